@@ -0,0 +1,197 @@
+/**
+ * @file AssetDecoders.cpp
+ * @brief Implements the decoders turning asset file contents into data ready for upload.
+ */
+
+#include "AssetDecoders.h"
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+  /**
+   * @brief Reads the next whitespace separated token of a Netpbm header, skipping comments.
+   */
+  bool readHeaderToken(const std::string& data, size_t& position, std::string& token) {
+    token.clear();
+    while (position < data.size()) {
+      char c = data[position];
+      if (c == '#') {
+        while (position < data.size() && data[position] != '\n') {
+          ++position;
+        }
+      } else if (std::isspace(static_cast<unsigned char>(c))) {
+        if (!token.empty()) {
+          return true;
+        }
+        ++position;
+      } else {
+        token += c;
+        ++position;
+      }
+    }
+    return !token.empty();
+  }
+
+  /**
+   * @brief Reads a positive integer from a Netpbm header.
+   */
+  bool readHeaderNumber(const std::string& data, size_t& position, int& value) {
+    std::string token;
+    if (!readHeaderToken(data, position, token)) {
+      return false;
+    }
+    char* end = nullptr;
+    long number = std::strtol(token.c_str(), &end, 10);
+    if (*end != '\0' || number <= 0 || number > 65535) {
+      return false;
+    }
+    value = static_cast<int>(number);
+    return true;
+  }
+}
+
+bool decodeNetpbm(const std::string& data, DecodedImage& image, std::string& error) {
+  size_t position = 0;
+  std::string magic;
+  int maxValue = 0;
+  int channels = 3;
+  bool ascii = false;
+
+  if (!readHeaderToken(data, position, magic)) {
+    error = "empty file";
+    return false;
+  }
+
+  if (magic == "P3" || magic == "P6") {
+    ascii = magic == "P3";
+    if (!readHeaderNumber(data, position, image.width) || !readHeaderNumber(data, position, image.height)
+        || !readHeaderNumber(data, position, maxValue)) {
+      error = "malformed PPM header";
+      return false;
+    }
+  } else if (magic == "P7") {
+    // PAM headers are key/value lines ending with ENDHDR
+    std::string key;
+    std::string tupleType;
+    while (readHeaderToken(data, position, key) && key != "ENDHDR") {
+      if (key == "WIDTH") {
+        readHeaderNumber(data, position, image.width);
+      } else if (key == "HEIGHT") {
+        readHeaderNumber(data, position, image.height);
+      } else if (key == "DEPTH") {
+        readHeaderNumber(data, position, channels);
+      } else if (key == "MAXVAL") {
+        readHeaderNumber(data, position, maxValue);
+      } else if (key == "TUPLTYPE") {
+        readHeaderToken(data, position, tupleType);
+      }
+    }
+    if (key != "ENDHDR" || image.width <= 0 || image.height <= 0
+        || !((channels == 3 && tupleType == "RGB") || (channels == 4 && tupleType == "RGB_ALPHA"))) {
+      error = "unsupported PAM header";
+      return false;
+    }
+  } else {
+    error = "not a PPM or PAM image";
+    return false;
+  }
+
+  if (maxValue != 255) {
+    error = "only 8-bit channels are supported";
+    return false;
+  }
+
+  size_t pixelCount = static_cast<size_t>(image.width) * image.height;
+  image.pixels.assign(pixelCount * 4, 255);
+
+  if (ascii) {
+    std::istringstream stream(data.substr(position));
+    for (size_t i = 0; i < pixelCount; ++i) {
+      for (int channel = 0; channel < 3; ++channel) {
+        int value;
+        if (!(stream >> value) || value < 0 || value > 255) {
+          error = "truncated or malformed pixel data";
+          return false;
+        }
+        image.pixels[i * 4 + channel] = static_cast<uint8_t>(value);
+      }
+    }
+    return true;
+  }
+
+  // A single whitespace character separates the binary data from the header
+  ++position;
+  if (data.size() < position + pixelCount * channels) {
+    error = "truncated pixel data";
+    return false;
+  }
+
+  const uint8_t* source = reinterpret_cast<const uint8_t*>(data.data()) + position;
+  for (size_t i = 0; i < pixelCount; ++i) {
+    for (int channel = 0; channel < channels; ++channel) {
+      image.pixels[i * 4 + channel] = source[i * channels + channel];
+    }
+  }
+  return true;
+}
+
+bool decodeObj(const std::string& data, DecodedMesh& mesh, std::string& error) {
+  std::istringstream stream(data);
+  std::string line;
+  int lineNumber = 0;
+
+  while (std::getline(stream, line)) {
+    ++lineNumber;
+    std::istringstream words(line);
+    std::string type;
+    if (!(words >> type)) {
+      continue;
+    }
+
+    if (type == "v") {
+      float position[3];
+      float color[3] = { 1.0f, 1.0f, 1.0f };
+      if (!(words >> position[0] >> position[1] >> position[2])) {
+        error = "malformed vertex on line " + std::to_string(lineNumber);
+        return false;
+      }
+      if (!(words >> color[0] >> color[1] >> color[2])) {
+        color[0] = color[1] = color[2] = 1.0f;
+      }
+      mesh.vertices.push_back(packVertex(position, color));
+    } else if (type == "f") {
+      // Each corner is "v", "v/vt", "v//vn" or "v/vt/vn"; only the position index matters here
+      std::vector<GLuint> corners;
+      std::string corner;
+      while (words >> corner) {
+        long index = std::strtol(corner.c_str(), nullptr, 10);
+        long vertexCount = static_cast<long>(mesh.vertices.size());
+        if (index < 0) {
+          index += vertexCount + 1;
+        }
+        if (index < 1 || index > vertexCount) {
+          error = "face refers to a missing vertex on line " + std::to_string(lineNumber);
+          return false;
+        }
+        corners.push_back(static_cast<GLuint>(index - 1));
+      }
+      if (corners.size() < 3) {
+        error = "face with fewer than three corners on line " + std::to_string(lineNumber);
+        return false;
+      }
+
+      for (size_t i = 1; i + 1 < corners.size(); ++i) {
+        mesh.indices.push_back(corners[0]);
+        mesh.indices.push_back(corners[i]);
+        mesh.indices.push_back(corners[i + 1]);
+      }
+    }
+  }
+
+  if (mesh.indices.empty()) {
+    error = "no faces";
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file AssetDecoders.h
+ * @brief Declares the decoders turning asset file contents into data ready for upload.
+ */
+
+#ifndef ASSET_DECODERS_H
+#define ASSET_DECODERS_H
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../mesh/VertexFormat.h"
+
+/**
+ * @struct DecodedImage
+ * @brief An image decoded to RGBA pixels, row by row from the top, four bytes each.
+ */
+struct DecodedImage {
+  int width = 0;
+  int height = 0;
+  std::vector<uint8_t> pixels;
+};
+
+/**
+ * @struct DecodedMesh
+ * @brief Indexed triangle data decoded from a model file.
+ */
+struct DecodedMesh {
+  std::vector<PackedVertex> vertices;
+  std::vector<GLuint> indices;
+};
+
+/**
+ * @brief Decodes a Netpbm image: binary (P6) or ASCII (P3) PPM, or PAM (P7) with an RGB or RGB_ALPHA tuple type.
+ * @param data File contents.
+ * @param image Receives the pixels; images without alpha are opaque.
+ * @param error Receives a description of the problem when decoding fails.
+ * @return true on success.
+ *
+ * Only 8-bit channels (a maximum value of 255) are supported.
+ */
+bool decodeNetpbm(const std::string& data, DecodedImage& image, std::string& error);
+
+/**
+ * @brief Decodes a Wavefront OBJ model.
+ * @param data File contents.
+ * @param mesh Receives one vertex per position and the triangles, with polygons split into fans.
+ * @param error Receives a description of the problem when decoding fails.
+ * @return true on success.
+ *
+ * Only positions and faces are read, plus the common extension of a vertex color after the position
+ * ("v x y z r g b"); vertices without one are white. Texture coordinates and normals in faces are ignored.
+ */
+bool decodeObj(const std::string& data, DecodedMesh& mesh, std::string& error);
+
+#endif
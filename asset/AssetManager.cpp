@@ -0,0 +1,212 @@
+/**
+ * @file AssetManager.cpp
+ * @brief Implements the AssetManager class, which loads textures, meshes and text files in the background.
+ */
+
+#include "AssetManager.h"
+#include "AssetDecoders.h"
+#include "../gl/GLApi.h"
+#include "../gl/GLState.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+  /**
+   * Initial size of each frame's region of the texture staging buffer in bytes; it grows for larger textures.
+   */
+  const size_t stagingRegionSize = 4 * 1024 * 1024;
+}
+
+AssetManager::AssetManager(ThreadPool* threadPool, bool persistentStreaming)
+  : threadPool(threadPool),
+    shared(std::make_shared<SharedState>()),
+    inFlight(0) {
+  stagingBuffer = new StreamBuffer(GL_PIXEL_UNPACK_BUFFER, stagingRegionSize, 3, persistentStreaming);
+}
+
+AssetManager::~AssetManager() {
+  // Uploads still queued are dropped, and tasks still running only ever touch the shared state
+  for (auto& entry : textures) {
+    if (entry.second.isReady()) {
+      GLState::deleteTexture(entry.second.get().textureId);
+    }
+  }
+  for (auto& entry : meshes) {
+    if (entry.second.isReady()) {
+      delete entry.second.get().mesh;
+    }
+  }
+  delete stagingBuffer;
+}
+
+bool AssetManager::readFile(const std::string& path, std::string& contents) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  std::ostringstream stream;
+  stream << file.rdbuf();
+  contents = stream.str();
+  return true;
+}
+
+void AssetManager::startLoad(std::function<Upload()> load) {
+  ++inFlight;
+  std::shared_ptr<SharedState> state = shared;
+  threadPool -> submit([state, load]() {
+    Upload upload = load();
+    std::lock_guard<std::mutex> lock(state -> mutex);
+    state -> uploads.push_back(std::move(upload));
+  });
+}
+
+template <typename Resource>
+void AssetManager::fail(AssetSlot<Resource>& slot, const std::string& path, const std::string& error) {
+  std::cerr << "Failed to load asset " << path << ": " << error << std::endl;
+  slot.state.store(AssetState::Failed, std::memory_order_release);
+  ++stats.failed;
+}
+
+template <typename Resource>
+void AssetManager::succeed(AssetSlot<Resource>& slot) {
+  slot.state.store(AssetState::Ready, std::memory_order_release);
+  ++stats.loaded;
+}
+
+AssetHandle<TextureAsset> AssetManager::loadTexture(const std::string& path) {
+  AssetHandle<TextureAsset>& handle = textures[path];
+  if (handle.slot) {
+    return handle;
+  }
+  handle.slot = std::make_shared<AssetSlot<TextureAsset>>();
+
+  std::shared_ptr<AssetSlot<TextureAsset>> slot = handle.slot;
+  startLoad([slot, path]() -> Upload {
+    std::string contents;
+    std::string error = "cannot read file";
+    auto image = std::make_shared<DecodedImage>();
+    if (!readFile(path, contents) || !decodeNetpbm(contents, *image, error)) {
+      return [slot, path, error](AssetManager& manager) { manager.fail(*slot, path, error); };
+    }
+    return [slot, image](AssetManager& manager) {
+      manager.uploadTexture(*slot, image -> width, image -> height, image -> pixels);
+    };
+  });
+  return handle;
+}
+
+AssetHandle<MeshAsset> AssetManager::loadMesh(const std::string& path) {
+  AssetHandle<MeshAsset>& handle = meshes[path];
+  if (handle.slot) {
+    return handle;
+  }
+  handle.slot = std::make_shared<AssetSlot<MeshAsset>>();
+
+  std::shared_ptr<AssetSlot<MeshAsset>> slot = handle.slot;
+  startLoad([slot, path]() -> Upload {
+    std::string contents;
+    std::string error = "cannot read file";
+    auto decoded = std::make_shared<DecodedMesh>();
+    if (!readFile(path, contents) || !decodeObj(contents, *decoded, error)) {
+      return [slot, path, error](AssetManager& manager) { manager.fail(*slot, path, error); };
+    }
+    return [slot, decoded](AssetManager& manager) {
+      // Models are small, so they keep their vertices in memory for the software renderer
+      slot -> resource.mesh = new Mesh(decoded -> vertices.data(), decoded -> vertices.size(),
+        decoded -> indices.data(), decoded -> indices.size(), true);
+      manager.succeed(*slot);
+    };
+  });
+  return handle;
+}
+
+AssetHandle<TextAsset> AssetManager::loadText(const std::string& path) {
+  AssetHandle<TextAsset>& handle = texts[path];
+  if (handle.slot) {
+    return handle;
+  }
+  handle.slot = std::make_shared<AssetSlot<TextAsset>>();
+
+  std::shared_ptr<AssetSlot<TextAsset>> slot = handle.slot;
+  startLoad([slot, path]() -> Upload {
+    auto contents = std::make_shared<std::string>();
+    if (!readFile(path, *contents)) {
+      return [slot, path](AssetManager& manager) { manager.fail(*slot, path, "cannot read file"); };
+    }
+    return [slot, contents](AssetManager& manager) {
+      slot -> resource.text = std::move(*contents);
+      manager.succeed(*slot);
+    };
+  });
+  return handle;
+}
+
+void AssetManager::uploadTexture(AssetSlot<TextureAsset>& slot, int width, int height, const std::vector<uint8_t>& pixels) {
+  // Stage the pixels in the unpack buffer, so that glTexImage2D only has to schedule a copy on the GPU side
+  size_t offset = 0;
+  void* staging = stagingBuffer -> map(pixels.size(), 4, offset);
+  std::memcpy(staging, pixels.data(), pixels.size());
+  stagingBuffer -> unmap();
+
+  TextureAsset& texture = slot.resource;
+  texture.width = width;
+  texture.height = height;
+  GL::GenTextures(1, &texture.textureId);
+  GLState::bindTexture2D(0, texture.textureId);
+  GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer -> getBufferId());
+  GL::TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, (void*)offset);
+
+  // Other uploads pass client memory pointers, which an unpack buffer left bound would turn into offsets
+  GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+  // Nearest filtering keeps pixel art crisp, like the tile atlas
+  GL::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  GL::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  GL::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  GL::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  GL::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+
+  succeed(slot);
+}
+
+void AssetManager::update(double uploadBudget) {
+  auto start = std::chrono::steady_clock::now();
+  stats.uploadsLastUpdate = 0;
+  stagingBuffer -> beginFrame();
+
+  while (true) {
+    Upload upload;
+    {
+      std::lock_guard<std::mutex> lock(shared -> mutex);
+      if (shared -> uploads.empty()) {
+        break;
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      if (stats.uploadsLastUpdate > 0 && elapsed.count() >= uploadBudget) {
+        break;
+      }
+      upload = std::move(shared -> uploads.front());
+      shared -> uploads.pop_front();
+    }
+
+    upload(*this);
+    --inFlight;
+    ++stats.uploadsLastUpdate;
+  }
+
+  stagingBuffer -> endFrame();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  stats.uploadTimeLastUpdate = elapsed.count();
+}
+
+AssetStats AssetManager::getStats() const {
+  AssetStats result = stats;
+  result.queueDepth = inFlight;
+  std::lock_guard<std::mutex> lock(shared -> mutex);
+  result.pendingUploads = shared -> uploads.size();
+  return result;
+}
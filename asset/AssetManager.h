@@ -0,0 +1,283 @@
+/**
+ * @file AssetManager.h
+ * @brief Declares the AssetManager class, which loads textures, meshes and text files in the background.
+ */
+
+#ifndef ASSET_MANAGER_H
+#define ASSET_MANAGER_H
+
+#include <GL/glew.h>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../jobs/ThreadPool.h"
+#include "../mesh/Mesh.h"
+#include "../renderer/StreamBuffer.h"
+
+/**
+ * @enum AssetState
+ * @brief The progress of an asset through the loading pipeline.
+ */
+enum class AssetState {
+  Loading,
+  Ready,
+  Failed
+};
+
+/**
+ * @struct TextureAsset
+ * @brief A loaded texture.
+ */
+struct TextureAsset {
+  GLuint textureId = 0;
+  int width = 0;
+  int height = 0;
+};
+
+/**
+ * @struct MeshAsset
+ * @brief A loaded mesh, owned by the AssetManager.
+ */
+struct MeshAsset {
+  Mesh* mesh = nullptr;
+};
+
+/**
+ * @struct TextAsset
+ * @brief A loaded text file, such as a shader source.
+ */
+struct TextAsset {
+  std::string text;
+};
+
+/**
+ * @struct AssetSlot
+ * @brief The shared state behind every handle to one asset.
+ */
+template <typename Resource>
+struct AssetSlot {
+  std::atomic<AssetState> state { AssetState::Loading };
+  Resource resource;
+};
+
+/**
+ * @class AssetHandle
+ * @brief Refers to an asset that becomes ready some time after it was requested.
+ *
+ * Handles are cheap to copy, and all handles to the same file share one asset. The resource may only be read once
+ * isReady() returns true.
+ */
+template <typename Resource>
+class AssetHandle {
+public:
+  /**
+   * @brief Checks whether the asset has finished loading and can be used.
+   */
+  bool isReady() const {
+    return slot && slot -> state.load(std::memory_order_acquire) == AssetState::Ready;
+  }
+
+  /**
+   * @brief Checks whether loading the asset failed.
+   */
+  bool isFailed() const {
+    return slot && slot -> state.load(std::memory_order_acquire) == AssetState::Failed;
+  }
+
+  /**
+   * @brief Get the loaded resource. Only valid once isReady() returns true.
+   */
+  const Resource& get() const {
+    return slot -> resource;
+  }
+
+private:
+  friend class AssetManager;
+
+  /**
+   * Shared state of the asset, or nullptr for a handle that refers to nothing.
+   */
+  std::shared_ptr<AssetSlot<Resource>> slot;
+};
+
+/**
+ * @struct AssetStats
+ * @brief Counters describing the asset loading pipeline.
+ */
+struct AssetStats {
+  /**
+   * Number of assets requested but not ready or failed yet, whether being read, decoded or waiting for upload.
+   */
+  size_t queueDepth = 0;
+
+  /**
+   * Number of decoded assets waiting for their upload.
+   */
+  size_t pendingUploads = 0;
+
+  /**
+   * Number of assets uploaded by the last call to update().
+   */
+  size_t uploadsLastUpdate = 0;
+
+  /**
+   * Time spent uploading in the last call to update(), in seconds.
+   */
+  double uploadTimeLastUpdate = 0.0;
+
+  /**
+   * Total number of assets that became ready.
+   */
+  size_t loaded = 0;
+
+  /**
+   * Total number of assets that failed to load.
+   */
+  size_t failed = 0;
+};
+
+/**
+ * @class AssetManager
+ * @brief Loads assets without blocking the frame loop.
+ *
+ * Requesting an asset returns a handle immediately. A ThreadPool task reads the file and decodes it; the decoded data
+ * is then queued for the thread owning the OpenGL context, where update() performs the uploads until the per-frame
+ * time budget is spent. Texture pixels are staged through a pixel unpack buffer streamed like any other per-frame
+ * data, so glTexImage2D returns without waiting for the copy. Text files need no upload and become ready as soon as
+ * update() sees them.
+ *
+ * Files that cannot be read or decoded mark their asset failed, with the error printed to stderr. Requesting a file
+ * that was requested before returns a handle to the same asset.
+ *
+ * All methods must be called from the thread owning the OpenGL context.
+ */
+class AssetManager {
+public:
+  /**
+   * @brief Constructs the manager. Requires a current OpenGL context, as it creates the texture staging buffer.
+   * @param threadPool Pool the files are read and decoded on. It must outlive the manager.
+   * @param persistentStreaming Whether the texture staging buffer uses persistent mapping when supported.
+   */
+  AssetManager(ThreadPool* threadPool, bool persistentStreaming = true);
+
+  /**
+   * @brief Destructor that releases every loaded texture and mesh. Loads still running are abandoned.
+   */
+  ~AssetManager();
+
+  /**
+   * @brief Requests a texture from a PPM or PAM image.
+   */
+  AssetHandle<TextureAsset> loadTexture(const std::string& path);
+
+  /**
+   * @brief Requests a mesh from a Wavefront OBJ model.
+   */
+  AssetHandle<MeshAsset> loadMesh(const std::string& path);
+
+  /**
+   * @brief Requests the contents of a text file, such as a shader source.
+   */
+  AssetHandle<TextAsset> loadText(const std::string& path);
+
+  /**
+   * @brief Uploads decoded assets until the time budget is spent. Call once per frame.
+   * @param uploadBudget Time in seconds that may be spent uploading. At least one asset is uploaded per call when
+   * one is waiting, so a small budget slows loading down but never stalls it.
+   */
+  void update(double uploadBudget);
+
+  /**
+   * @brief Get the counters describing the loading pipeline.
+   */
+  AssetStats getStats() const;
+
+private:
+  /**
+   * A decoded asset waiting for its upload, which runs on the OpenGL thread.
+   */
+  typedef std::function<void(AssetManager&)> Upload;
+
+  /**
+   * State shared with the loading tasks, which may outlive the manager.
+   */
+  struct SharedState {
+    /**
+     * Guards uploads.
+     */
+    std::mutex mutex;
+
+    /**
+     * Decoded assets waiting for their upload, in order of completion.
+     */
+    std::deque<Upload> uploads;
+  };
+
+  /**
+   * @brief Reads a whole file into a string.
+   * @return true on success.
+   */
+  static bool readFile(const std::string& path, std::string& contents);
+
+  /**
+   * @brief Runs a loading task on the pool, queueing the upload it returns.
+   */
+  void startLoad(std::function<Upload()> load);
+
+  /**
+   * @brief Marks an asset failed, printing the reason.
+   */
+  template <typename Resource>
+  void fail(AssetSlot<Resource>& slot, const std::string& path, const std::string& error);
+
+  /**
+   * @brief Marks an asset ready.
+   */
+  template <typename Resource>
+  void succeed(AssetSlot<Resource>& slot);
+
+  /**
+   * @brief Uploads a decoded texture through the staging buffer.
+   */
+  void uploadTexture(AssetSlot<TextureAsset>& slot, int width, int height, const std::vector<uint8_t>& pixels);
+
+  /**
+   * Pool the files are read and decoded on.
+   */
+  ThreadPool* threadPool;
+
+  /**
+   * Queue shared with the loading tasks.
+   */
+  std::shared_ptr<SharedState> shared;
+
+  /**
+   * Stream that texture pixels are staged in, bound to GL_PIXEL_UNPACK_BUFFER during uploads.
+   */
+  StreamBuffer* stagingBuffer;
+
+  /**
+   * Requested assets by path, one map per resource type.
+   */
+  std::unordered_map<std::string, AssetHandle<TextureAsset>> textures;
+  std::unordered_map<std::string, AssetHandle<MeshAsset>> meshes;
+  std::unordered_map<std::string, AssetHandle<TextAsset>> texts;
+
+  /**
+   * Number of assets requested but not finished yet.
+   */
+  size_t inFlight;
+
+  /**
+   * Counters describing the loading pipeline.
+   */
+  AssetStats stats;
+};
+
+#endif
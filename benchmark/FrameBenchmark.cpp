@@ -0,0 +1,106 @@
+/**
+ * @file FrameBenchmark.cpp
+ * @brief Implements the FrameBenchmark class, which drives the game loop for a fixed number of frames and reports timings.
+ */
+
+#include "FrameBenchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+#include "PngWriter.h"
+
+namespace {
+  /**
+   * Distance of the scripted camera orbit from the origin.
+   */
+  const float orbitRadius = 10.0f;
+
+  /**
+   * Average height of the scripted camera orbit above the origin.
+   */
+  const float orbitHeight = 2.0f;
+}
+
+FrameBenchmark::FrameBenchmark(int frameCount, const std::string& dumpDirectory, int dumpInterval)
+  : frameCount(frameCount),
+    frameIndex(0),
+    dumpDirectory(dumpDirectory),
+    dumpInterval(dumpInterval),
+    frameTimes(frameCount, 0.0),
+    captureTimes(frameCount, 0.0),
+    finishedFrames(0),
+    lastFinishTime(0.0) {}
+
+void FrameBenchmark::start(double time) {
+  lastFinishTime = time;
+}
+
+void FrameBenchmark::beginFrame(Camera& camera) {
+  // One full orbit over the length of the benchmark, bobbing up and down twice, always looking at the origin
+  float angle = 2.0f * 3.14159265f * frameIndex / frameCount;
+  glm::vec3 position(
+    orbitRadius * sin(angle),
+    orbitHeight + 1.5f * sin(2.0f * angle),
+    orbitRadius * cos(angle)
+  );
+
+  glm::vec3 direction = glm::normalize(-position);
+  camera.setPose(position, atan2(direction.x, direction.z), asin(direction.y));
+}
+
+void FrameBenchmark::captureFrame(const Window& window, int frame) {
+  if (dumpDirectory.empty() || frame % dumpInterval != 0) {
+    return;
+  }
+
+  window.readPixels(pixels);
+
+  // Reading back waits for the GPU to finish the frame, which is the game's work, so only the encoding is timed
+  auto start = std::chrono::steady_clock::now();
+  char fileName[32];
+  std::snprintf(fileName, sizeof(fileName), "/frame_%05d.png", frame);
+  PngWriter::write(dumpDirectory + fileName, window.getWidth(), window.getHeight(), pixels);
+
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  captureTimes[frame] = elapsed.count();
+}
+
+void FrameBenchmark::finishFrame(int frame, double time) {
+  // The frame's capture ran between the previous frame finishing and this one, on the same thread
+  frameTimes[frame] = time - lastFinishTime - captureTimes[frame];
+  lastFinishTime = time;
+  finishedFrames = frame + 1;
+}
+
+void FrameBenchmark::endFrame() {
+  ++frameIndex;
+}
+
+int FrameBenchmark::getFrameIndex() const {
+  return frameIndex;
+}
+
+bool FrameBenchmark::isFinished() const {
+  return frameIndex >= frameCount;
+}
+
+void FrameBenchmark::report(std::ostream& output) const {
+  if (finishedFrames == 0) {
+    output << "Benchmark: no frames rendered" << std::endl;
+    return;
+  }
+
+  std::vector<double> sorted(frameTimes.begin(), frameTimes.begin() + finishedFrames);
+  std::sort(sorted.begin(), sorted.end());
+
+  double average = std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+  size_t p99Index = static_cast<size_t>(std::ceil(0.99 * sorted.size())) - 1;
+
+  output << "Benchmark: " << sorted.size() << " frames" << std::endl
+         << "  min " << sorted.front() * 1000.0 << " ms" << std::endl
+         << "  avg " << average * 1000.0 << " ms (" << 1.0 / average << " FPS)" << std::endl
+         << "  p99 " << sorted[p99Index] * 1000.0 << " ms" << std::endl
+         << "  max " << sorted.back() * 1000.0 << " ms" << std::endl;
+}
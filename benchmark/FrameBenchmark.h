@@ -0,0 +1,133 @@
+/**
+ * @file FrameBenchmark.h
+ * @brief Declares the FrameBenchmark class, which drives the game loop for a fixed number of frames and reports timings.
+ */
+
+#ifndef FRAME_BENCHMARK_H
+#define FRAME_BENCHMARK_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "../camera/Camera.h"
+#include "../window/Window.h"
+
+/**
+ * @class FrameBenchmark
+ * @brief Runs a deterministic, reproducible frame benchmark inside the game loop.
+ *
+ * Each frame the camera is placed on a scripted orbit around the origin instead of following user input, so every
+ * run renders exactly the same sequence of frames. Frame times are recorded and summarized as min/avg/p99/max, and
+ * frames can optionally be dumped as PNG files for visual comparison between builds.
+ *
+ * A frame's time is the interval between the previous frame and this one finishing on the thread that draws them,
+ * or since start() for the first frame. When drawing runs on a render thread, pipelined with the simulation of the
+ * next frame, this is the rate at which frames come out of the pipeline, which neither thread's share of the work
+ * alone shows.
+ */
+class FrameBenchmark {
+public:
+  /**
+   * @brief Constructs a FrameBenchmark.
+   * @param frameCount Number of frames to render before the benchmark is finished.
+   * @param dumpDirectory Directory to save PNG frame dumps into, or empty to disable dumping.
+   * @param dumpInterval Only every dumpInterval-th frame is dumped.
+   */
+  FrameBenchmark(int frameCount, const std::string& dumpDirectory, int dumpInterval);
+
+  /**
+   * @brief Marks the start of the first frame, which its time is measured from.
+   * @param time Time on the window's clock.
+   */
+  void start(double time);
+
+  /**
+   * @brief Moves the camera to its scripted pose for the current frame.
+   * @param camera The camera to position.
+   */
+  void beginFrame(Camera& camera);
+
+  /**
+   * @brief Saves the rendered frame as a PNG if dumping is enabled and the frame is due.
+   * @param window The window whose framebuffer holds the rendered frame. Must be called before swapping buffers.
+   * @param frame Index of the rendered frame, which may lag behind the current one when rendering on another thread.
+   *
+   * Encoding and writing the PNG is not part of the game's work, so its time is left out of the frame's time.
+   */
+  void captureFrame(const Window& window, int frame);
+
+  /**
+   * @brief Records the time of a frame from when the previous one finished.
+   * @param frame Index of the frame, which has been drawn and swapped.
+   * @param time Time on the window's clock.
+   *
+   * Called by the thread drawing the frames, for every frame in order.
+   */
+  void finishFrame(int frame, double time);
+
+  /**
+   * @brief Get the index of the frame currently being simulated.
+   */
+  int getFrameIndex() const;
+
+  /**
+   * @brief Advances to the next frame, once the current one has been handed over for drawing.
+   */
+  void endFrame();
+
+  /**
+   * @brief Checks whether all frames have been rendered.
+   */
+  bool isFinished() const;
+
+  /**
+   * @brief Prints a summary of the recorded frame times.
+   * @param output Stream to print the summary to. Every frame must have finished.
+   */
+  void report(std::ostream& output) const;
+
+private:
+  /**
+   * Total number of frames to render.
+   */
+  int frameCount;
+
+  /**
+   * Index of the frame currently being rendered.
+   */
+  int frameIndex;
+
+  /**
+   * Directory PNG frame dumps are written into; empty when dumping is disabled.
+   */
+  std::string dumpDirectory;
+
+  /**
+   * Only every dumpInterval-th frame is dumped.
+   */
+  int dumpInterval;
+
+  /**
+   * Recorded duration of every finished frame, in seconds.
+   */
+  std::vector<double> frameTimes;
+
+  /**
+   * Time captureFrame() spent encoding every frame, in seconds.
+   */
+  std::vector<double> captureTimes;
+
+  /**
+   * Number of frames finished, and the time the last of them finished, or the start time before the first one.
+   * Only used by the thread drawing the frames until the benchmark is over.
+   */
+  int finishedFrames;
+  double lastFinishTime;
+
+  /**
+   * Scratch buffer for framebuffer readback, reused across frames to avoid reallocating.
+   */
+  std::vector<unsigned char> pixels;
+};
+
+#endif
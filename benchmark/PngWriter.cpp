@@ -0,0 +1,95 @@
+/**
+ * @file PngWriter.cpp
+ * @brief Implements the PngWriter class, which saves RGBA framebuffer captures as PNG files.
+ */
+
+#include "PngWriter.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+bool PngWriter::write(const std::string& path, int width, int height, const std::vector<unsigned char>& pixels) {
+  const size_t rowSize = static_cast<size_t>(width) * 4;
+
+  // Raw scanlines, each prefixed with filter type 0 (none). OpenGL rows are bottom-up, PNG rows are top-down
+  std::vector<unsigned char> scanlines;
+  scanlines.reserve((rowSize + 1) * height);
+  for (int row = height - 1; row >= 0; --row) {
+    scanlines.push_back(0);
+    const unsigned char* source = pixels.data() + row * rowSize;
+    scanlines.insert(scanlines.end(), source, source + rowSize);
+  }
+
+  // Wrap the scanlines in a zlib stream made of stored (uncompressed) deflate blocks of at most 65535 bytes
+  std::vector<unsigned char> compressed = { 0x78, 0x01 };
+  size_t offset = 0;
+  do {
+    size_t blockSize = std::min<size_t>(65535, scanlines.size() - offset);
+    bool finalBlock = offset + blockSize == scanlines.size();
+    compressed.push_back(finalBlock ? 1 : 0);
+    compressed.push_back(blockSize & 0xff);
+    compressed.push_back((blockSize >> 8) & 0xff);
+    compressed.push_back(~blockSize & 0xff);
+    compressed.push_back((~blockSize >> 8) & 0xff);
+    compressed.insert(compressed.end(), scanlines.begin() + offset, scanlines.begin() + offset + blockSize);
+    offset += blockSize;
+  } while (offset < scanlines.size());
+  appendUint32(compressed, adler32(scanlines));
+
+  // Header: dimensions, 8 bits per channel, color type 6 (RGBA), default compression/filter, no interlacing
+  std::vector<unsigned char> header;
+  appendUint32(header, width);
+  appendUint32(header, height);
+  header.insert(header.end(), { 8, 6, 0, 0, 0 });
+
+  std::vector<unsigned char> file = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+  appendChunk(file, "IHDR", header);
+  appendChunk(file, "IDAT", compressed);
+  appendChunk(file, "IEND", {});
+
+  std::ofstream output(path, std::ios::binary);
+  if (!output.is_open()) {
+    std::cerr << "Failed to open " << path << " for writing" << std::endl;
+    return false;
+  }
+  output.write(reinterpret_cast<const char*>(file.data()), file.size());
+  return output.good();
+}
+
+void PngWriter::appendChunk(std::vector<unsigned char>& output, const char* type, const std::vector<unsigned char>& data) {
+  appendUint32(output, data.size());
+
+  // The CRC covers the chunk type and the payload, but not the length
+  size_t typeStart = output.size();
+  output.insert(output.end(), type, type + 4);
+  output.insert(output.end(), data.begin(), data.end());
+  appendUint32(output, crc32(output.data() + typeStart, output.size() - typeStart));
+}
+
+void PngWriter::appendUint32(std::vector<unsigned char>& output, uint32_t value) {
+  output.push_back((value >> 24) & 0xff);
+  output.push_back((value >> 16) & 0xff);
+  output.push_back((value >> 8) & 0xff);
+  output.push_back(value & 0xff);
+}
+
+uint32_t PngWriter::crc32(const unsigned char* data, size_t length, uint32_t crc) {
+  crc = ~crc;
+  for (size_t i = 0; i < length; ++i) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ (0xedb88320u & (0u - (crc & 1u)));
+    }
+  }
+  return ~crc;
+}
+
+uint32_t PngWriter::adler32(const std::vector<unsigned char>& data) {
+  uint32_t a = 1;
+  uint32_t b = 0;
+  for (unsigned char byte : data) {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+  return (b << 16) | a;
+}
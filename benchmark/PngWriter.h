@@ -0,0 +1,57 @@
+/**
+ * @file PngWriter.h
+ * @brief Declares the PngWriter class, which saves RGBA framebuffer captures as PNG files.
+ */
+
+#ifndef PNG_WRITER_H
+#define PNG_WRITER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class PngWriter
+ * @brief Encodes RGBA8 pixel data into a PNG file without any external image library.
+ *
+ * Image data is stored with uncompressed deflate blocks. Frame dumps are a debugging aid rather than a shipping
+ * format, so file size is traded for zero dependencies and negligible encode time inside the benchmark loop.
+ */
+class PngWriter {
+public:
+  /**
+   * @brief Writes an RGBA image to disk as a PNG.
+   * @param path Destination file path.
+   * @param width Width of the image in pixels.
+   * @param height Height of the image in pixels.
+   * @param pixels Tightly packed RGBA8 pixels, bottom row first as returned by glReadPixels.
+   * @return true if the file was written successfully; false otherwise.
+   */
+  static bool write(const std::string& path, int width, int height, const std::vector<unsigned char>& pixels);
+
+private:
+  /**
+   * @brief Appends a PNG chunk (length, type, data and CRC) to the output buffer.
+   * @param output Buffer receiving the encoded chunk.
+   * @param type Four character chunk type.
+   * @param data Chunk payload.
+   */
+  static void appendChunk(std::vector<unsigned char>& output, const char* type, const std::vector<unsigned char>& data);
+
+  /**
+   * @brief Appends a 32-bit value in big-endian (network) byte order.
+   */
+  static void appendUint32(std::vector<unsigned char>& output, uint32_t value);
+
+  /**
+   * @brief Computes the CRC-32 used by PNG chunks.
+   */
+  static uint32_t crc32(const unsigned char* data, size_t length, uint32_t crc = 0);
+
+  /**
+   * @brief Computes the Adler-32 checksum that terminates a zlib stream.
+   */
+  static uint32_t adler32(const std::vector<unsigned char>& data);
+};
+
+#endif
@@ -0,0 +1,102 @@
+/**
+ * @file CameraBenchmark.cpp
+ * @brief Microbenchmarks of the camera work done every frame: mouse look, view matrix and frustum updates, and the
+ * model-view-projection matrices of the cube lattice.
+ */
+
+#include <benchmark/benchmark.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <vector>
+#include "../../camera/Camera.h"
+
+namespace {
+  /**
+   * Distance between neighbouring cubes of the lattice, as in the game.
+   */
+  const float cubeSpacing = 3.0f;
+
+  /**
+   * @brief Returns a camera set up like the game's, for a 4:3 window.
+   */
+  Camera makeCamera() {
+    return Camera(45.0f, 4.0f / 3.0f, 0.1f, 100.0f);
+  }
+
+  /**
+   * @brief Returns the model matrices of a cubic lattice of the given number of cubes, centered on the origin.
+   */
+  std::vector<glm::mat4> latticeMatrices(int count) {
+    int side = static_cast<int>(std::ceil(std::cbrt(static_cast<double>(count))));
+    float offset = (side - 1) * cubeSpacing / 2.0f;
+    std::vector<glm::mat4> matrices;
+    for (int i = 0; i < count; ++i) {
+      glm::vec3 position(
+        (i % side) * cubeSpacing - offset,
+        (i / (side * side)) * cubeSpacing - offset,
+        ((i / side) % side) * cubeSpacing - offset
+      );
+      matrices.push_back(glm::translate(glm::mat4(1.0f), position));
+    }
+    return matrices;
+  }
+}
+
+/**
+ * Turns the camera by a small mouse motion, as every frame the mouse moves.
+ */
+static void BM_CameraUpdateOrientation(benchmark::State& state) {
+  Camera camera = makeCamera();
+  double direction = 1.0;
+  for (auto _ : state) {
+    camera.updateOrientation(3.0 * direction, 1.0 * direction);
+    direction = -direction;
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_CameraUpdateOrientation);
+
+/**
+ * Builds the view matrix of the rendered pose.
+ */
+static void BM_CameraViewMatrix(benchmark::State& state) {
+  Camera camera = makeCamera();
+  camera.updateOrientation(40.0, 10.0);
+  for (auto _ : state) {
+    glm::mat4 view = camera.getViewMatrix();
+    benchmark::DoNotOptimize(view);
+  }
+}
+BENCHMARK(BM_CameraViewMatrix);
+
+/**
+ * Extracts the view frustum, which culling needs every frame.
+ */
+static void BM_CameraFrustum(benchmark::State& state) {
+  Camera camera = makeCamera();
+  camera.updateOrientation(40.0, 10.0);
+  for (auto _ : state) {
+    Frustum frustum = camera.getFrustum();
+    benchmark::DoNotOptimize(frustum);
+  }
+}
+BENCHMARK(BM_CameraFrustum);
+
+/**
+ * Computes the model-view-projection matrix of every cube of a lattice from the camera, the per-object work of a
+ * renderer without a camera uniform block.
+ */
+static void BM_ModelViewProjection(benchmark::State& state) {
+  Camera camera = makeCamera();
+  std::vector<glm::mat4> models = latticeMatrices(static_cast<int>(state.range(0)));
+  std::vector<glm::mat4> mvps(models.size());
+  for (auto _ : state) {
+    glm::mat4 viewProjection = camera.getProjectionMatrix() * camera.getViewMatrix();
+    for (size_t i = 0; i < models.size(); ++i) {
+      mvps[i] = viewProjection * models[i];
+    }
+    benchmark::DoNotOptimize(mvps.data());
+  }
+  state.SetItemsProcessed(state.iterations() * models.size());
+}
+BENCHMARK(BM_ModelViewProjection)->RangeMultiplier(8)->Range(64, 32768);
@@ -0,0 +1,126 @@
+/**
+ * @file CullingBenchmark.cpp
+ * @brief Microbenchmarks comparing scalar, SIMD and grid accelerated frustum culling of 100k boxes.
+ */
+
+#include <benchmark/benchmark.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+#include <vector>
+#include "../../culling/CullingGrid.h"
+
+namespace {
+  /**
+   * Number of boxes culled by every benchmark.
+   */
+  const size_t boxCount = 100000;
+
+  /**
+   * Boxes scattered over a 1000 x 1000 unit field, the same for every benchmark.
+   */
+  const std::vector<AABB>& sceneBoxes() {
+    static std::vector<AABB> boxes = [] {
+      std::mt19937 random(1234);
+      std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+      std::uniform_real_distribution<float> height(0.0f, 20.0f);
+      std::uniform_real_distribution<float> extent(0.5f, 2.0f);
+
+      std::vector<AABB> result(boxCount);
+      for (AABB& box : result) {
+        glm::vec3 center(position(random), height(random), position(random));
+        glm::vec3 halfSize(extent(random));
+        box = { center - halfSize, center + halfSize };
+      }
+      return result;
+    }();
+    return boxes;
+  }
+
+  /**
+   * A camera in the middle of the field looking along it, which sees a few percent of the boxes.
+   */
+  Frustum sceneFrustum() {
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, 300.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 10.0f, 0.0f), glm::vec3(1.0f, 9.8f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    return Frustum::fromMatrix(projection * view);
+  }
+
+  void reportCounters(benchmark::State& state, size_t tested, size_t visible) {
+    state.SetItemsProcessed(state.iterations() * boxCount);
+    state.counters["tested"] = static_cast<double>(tested);
+    state.counters["visible"] = static_cast<double>(visible);
+  }
+}
+
+/**
+ * Tests every box on its own with the scalar Frustum::intersects(), the baseline.
+ */
+static void BM_CullScalar(benchmark::State& state) {
+  const std::vector<AABB>& boxes = sceneBoxes();
+  Frustum frustum = sceneFrustum();
+  std::vector<uint32_t> visible;
+  visible.reserve(boxCount);
+
+  for (auto _ : state) {
+    visible.clear();
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      if (frustum.intersects(boxes[i])) {
+        visible.push_back(static_cast<uint32_t>(i));
+      }
+    }
+    benchmark::DoNotOptimize(visible.data());
+  }
+  reportCounters(state, boxCount, visible.size());
+}
+BENCHMARK(BM_CullScalar);
+
+/**
+ * Tests every box with the structure of arrays SIMD path, without the grid.
+ */
+static void BM_CullSimd(benchmark::State& state) {
+  CullingGrid grid;
+  grid.build(sceneBoxes().data(), boxCount);
+  Frustum frustum = sceneFrustum();
+  std::vector<uint32_t> visible;
+  visible.reserve(boxCount);
+
+  for (auto _ : state) {
+    grid.cull(frustum, visible, false);
+    benchmark::DoNotOptimize(visible.data());
+  }
+  reportCounters(state, grid.getStats().objectsTested, visible.size());
+}
+BENCHMARK(BM_CullSimd);
+
+/**
+ * Rejects and accepts whole grid cells first, then tests the boxes of the remaining cells with SIMD.
+ */
+static void BM_CullGrid(benchmark::State& state) {
+  CullingGrid grid;
+  grid.build(sceneBoxes().data(), boxCount);
+  Frustum frustum = sceneFrustum();
+  std::vector<uint32_t> visible;
+  visible.reserve(boxCount);
+
+  for (auto _ : state) {
+    grid.cull(frustum, visible);
+    benchmark::DoNotOptimize(visible.data());
+  }
+  reportCounters(state, grid.getStats().objectsTested, visible.size());
+}
+BENCHMARK(BM_CullGrid);
+
+/**
+ * Building the grid, which has to be repeated whenever the boxes move.
+ */
+static void BM_BuildGrid(benchmark::State& state) {
+  const std::vector<AABB>& boxes = sceneBoxes();
+  CullingGrid grid;
+
+  for (auto _ : state) {
+    grid.build(boxes.data(), boxes.size());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * boxCount);
+}
+BENCHMARK(BM_BuildGrid);
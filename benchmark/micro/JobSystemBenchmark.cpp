@@ -0,0 +1,87 @@
+/**
+ * @file JobSystemBenchmark.cpp
+ * @brief Microbenchmarks measuring how the job system scales a frame's worth of parallel work from 1 to N threads.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "../../jobs/JobSystem.h"
+
+namespace {
+  /**
+   * Number of items processed by every benchmark iteration.
+   */
+  const size_t itemCount = 100000;
+
+  /**
+   * Number of items handed to each job.
+   */
+  const size_t grainSize = 256;
+
+  /**
+   * @brief A few hundred nanoseconds of arithmetic standing in for the per-entity work of a frame.
+   */
+  float work(float value) {
+    for (int i = 0; i < 16; ++i) {
+      value = std::sin(value) * 0.5f + std::cos(value * 1.5f);
+    }
+    return value;
+  }
+}
+
+/**
+ * Splits the items over the benchmark's thread count with parallelFor(); compare the times against 1 thread.
+ */
+static void BM_ParallelFor(benchmark::State& state) {
+  JobSystem jobs(static_cast<int>(state.range(0)));
+  std::vector<float> values(itemCount, 1.0f);
+
+  for (auto _ : state) {
+    jobs.parallelFor(values.size(), grainSize, [&values](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        values[i] = work(values[i]);
+      }
+    });
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * itemCount);
+  state.counters["steals"] = static_cast<double>(jobs.getStealCount());
+}
+BENCHMARK(BM_ParallelFor)->DenseRange(1, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+  ->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+/**
+ * A chain of dependent stages, each fanned out once the previous one finished, as in a frame of culling, transform
+ * updates and draw preparation; measures the cost of the dependency handoffs.
+ */
+static void BM_DependentStages(benchmark::State& state) {
+  JobSystem jobs(static_cast<int>(state.range(0)));
+  std::vector<float> values(itemCount, 1.0f);
+  const int stageCount = 4;
+
+  for (auto _ : state) {
+    JobCounter stages[stageCount];
+    for (int stage = 0; stage < stageCount; ++stage) {
+      for (size_t begin = 0; begin < values.size(); begin += grainSize * 16) {
+        size_t end = std::min(values.size(), begin + grainSize * 16);
+        auto job = [&values, begin, end]() {
+          for (size_t i = begin; i < end; ++i) {
+            values[i] = work(values[i]);
+          }
+        };
+        if (stage == 0) {
+          jobs.run(job, &stages[stage]);
+        } else {
+          jobs.runAfter(stages[stage - 1], job, &stages[stage]);
+        }
+      }
+    }
+    jobs.wait(stages[stageCount - 1]);
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * itemCount * stageCount);
+}
+BENCHMARK(BM_DependentStages)->DenseRange(1, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+  ->UseRealTime()->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,143 @@
+/**
+ * @file OcclusionBenchmark.cpp
+ * @brief Microbenchmarks of occlusion culling in a town of 100 buildings hiding 20k small props, on 1 to N threads.
+ */
+
+#include <benchmark/benchmark.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+#include "../../culling/OcclusionCuller.h"
+
+namespace {
+  /**
+   * Number of props scattered between the buildings.
+   */
+  const size_t propCount = 20000;
+
+  /**
+   * Number of buildings along each side of the town's square grid, and the distance between their centers.
+   */
+  const int buildingsPerSide = 10;
+  const float buildingPitch = 10.0f;
+
+  /**
+   * A camera at eye height on the edge of the town, looking down its main street.
+   */
+  glm::mat4 sceneViewProjection() {
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, 300.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(3.0f, 1.7f, -60.0f), glm::vec3(8.0f, 1.5f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    return projection * view;
+  }
+
+  /**
+   * Adds the buildings of the town to a culler, as boxes of random heights.
+   */
+  void addBuildings(OcclusionCuller& culler) {
+    const uint32_t faces[6][4] = {
+      { 0, 4, 6, 2 }, { 1, 3, 7, 5 }, { 0, 1, 5, 4 }, { 2, 6, 7, 3 }, { 0, 2, 3, 1 }, { 4, 5, 7, 6 }
+    };
+    uint32_t indices[36];
+    for (int face = 0; face < 6; ++face) {
+      const uint32_t triangles[6] = { faces[face][0], faces[face][1], faces[face][2], faces[face][0], faces[face][2], faces[face][3] };
+      std::copy(triangles, triangles + 6, indices + face * 6);
+    }
+
+    std::mt19937 random(4321);
+    std::uniform_real_distribution<float> height(8.0f, 20.0f);
+    float offset = (buildingsPerSide - 1) * buildingPitch / 2.0f;
+    for (int z = 0; z < buildingsPerSide; ++z) {
+      for (int x = 0; x < buildingsPerSide; ++x) {
+        glm::vec3 min(x * buildingPitch - offset - 3.0f, 0.0f, z * buildingPitch - offset - 3.0f);
+        glm::vec3 max(min.x + 6.0f, height(random), min.z + 6.0f);
+        glm::vec3 corners[8];
+        for (int corner = 0; corner < 8; ++corner) {
+          corners[corner] = glm::vec3((corner & 1) ? max.x : min.x, (corner & 2) ? max.y : min.y, (corner & 4) ? max.z : min.z);
+        }
+        culler.addOccluder(corners, 8, indices, 36);
+      }
+    }
+  }
+
+  /**
+   * Props scattered over the whole town, the same for every benchmark.
+   */
+  const std::vector<AABB>& sceneProps() {
+    static std::vector<AABB> props = [] {
+      std::mt19937 random(1234);
+      std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+      std::uniform_real_distribution<float> extent(0.25f, 1.0f);
+
+      std::vector<AABB> result(propCount);
+      for (AABB& box : result) {
+        glm::vec3 halfSize(extent(random));
+        glm::vec3 center(position(random), halfSize.y, position(random));
+        box = { center - halfSize, center + halfSize };
+      }
+      return result;
+    }();
+    return props;
+  }
+
+  /**
+   * @brief Returns the props inside the view, the objects occlusion culling gets after frustum culling.
+   */
+  std::vector<uint32_t> propsInView() {
+    Frustum frustum = Frustum::fromMatrix(sceneViewProjection());
+    std::vector<uint32_t> inView;
+    for (size_t i = 0; i < sceneProps().size(); ++i) {
+      if (frustum.intersects(sceneProps()[i])) {
+        inView.push_back(static_cast<uint32_t>(i));
+      }
+    }
+    return inView;
+  }
+
+  int maxThreads() {
+    return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  }
+}
+
+/**
+ * Rasterizes the buildings in view and builds the depth pyramid.
+ */
+static void BM_OcclusionRender(benchmark::State& state) {
+  JobSystem jobs(static_cast<int>(state.range(0)));
+  OcclusionCuller culler(&jobs);
+  addBuildings(culler);
+  glm::mat4 viewProjection = sceneViewProjection();
+  Frustum frustum = Frustum::fromMatrix(viewProjection);
+
+  for (auto _ : state) {
+    culler.render(viewProjection, frustum);
+    benchmark::DoNotOptimize(culler.getDepthBuffer().data());
+  }
+  state.counters["occluders"] = static_cast<double>(culler.getStats().occluders);
+  state.counters["triangles"] = static_cast<double>(culler.getStats().occluderTriangles);
+}
+BENCHMARK(BM_OcclusionRender)->DenseRange(1, maxThreads())->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+/**
+ * Tests the props in view against the depth pyramid.
+ */
+static void BM_OcclusionCull(benchmark::State& state) {
+  JobSystem jobs(static_cast<int>(state.range(0)));
+  OcclusionCuller culler(&jobs);
+  addBuildings(culler);
+  glm::mat4 viewProjection = sceneViewProjection();
+  culler.render(viewProjection, Frustum::fromMatrix(viewProjection));
+
+  const std::vector<uint32_t> inView = propsInView();
+  std::vector<uint32_t> visible;
+  for (auto _ : state) {
+    visible = inView;
+    culler.cull(sceneProps().data(), visible);
+    benchmark::DoNotOptimize(visible.data());
+  }
+  state.SetItemsProcessed(state.iterations() * inView.size());
+  state.counters["tested"] = static_cast<double>(inView.size());
+  state.counters["hidden"] = static_cast<double>(inView.size() - visible.size());
+}
+BENCHMARK(BM_OcclusionCull)->DenseRange(1, maxThreads())->UseRealTime()->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,124 @@
+/**
+ * @file RenderBenchmark.cpp
+ * @brief Microbenchmarks of mesh construction and render submission, run against the NullGL backend so that only the
+ * CPU side is measured, without any driver.
+ */
+
+#include <benchmark/benchmark.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <vector>
+#include "../../gl/NullGL.h"
+#include "../../renderer/Renderer.h"
+
+namespace {
+  /**
+   * Shader sources for the benchmarks' programs. NullGL accepts any source, so the game's own files are not needed.
+   */
+  const char* vertexShaderSource = "#version 330 core\nvoid main() {}\n";
+  const char* fragmentShaderSource = "#version 330 core\nvoid main() {}\n";
+
+  /**
+   * Vertex positions and colors of a terrain-like grid, as triangles without indices, the way models are loaded.
+   */
+  struct GridData {
+    std::vector<float> vertices;
+    std::vector<float> colors;
+  };
+
+  /**
+   * @brief Returns a grid of side x side quads, two triangles each, with neighbouring quads sharing their corners.
+   */
+  GridData makeGrid(int side) {
+    GridData grid;
+    const int corners[6][2] = { { 0, 0 }, { 0, 1 }, { 1, 1 }, { 0, 0 }, { 1, 1 }, { 1, 0 } };
+    for (int z = 0; z < side; ++z) {
+      for (int x = 0; x < side; ++x) {
+        for (const int* corner : corners) {
+          float cornerX = static_cast<float>(x + corner[0]);
+          float cornerZ = static_cast<float>(z + corner[1]);
+          grid.vertices.insert(grid.vertices.end(), { cornerX, 0.1f * ((x + z + corner[0]) % 3), cornerZ });
+          grid.colors.insert(grid.colors.end(), { cornerX / side, 0.5f, cornerZ / side });
+        }
+      }
+    }
+    return grid;
+  }
+
+  /**
+   * @brief Returns the model matrices of the given number of cubes, in rows in front of the default camera.
+   */
+  std::vector<glm::mat4> rowMatrices(int count) {
+    std::vector<glm::mat4> matrices;
+    for (int i = 0; i < count; ++i) {
+      glm::vec3 position((i % 64) * 3.0f - 96.0f, ((i / 64) % 16) * 3.0f - 24.0f, -10.0f - (i / 1024) * 3.0f);
+      matrices.push_back(glm::translate(glm::mat4(1.0f), position));
+    }
+    return matrices;
+  }
+}
+
+/**
+ * Builds a grid mesh from loose triangles: converting to the compact vertex format, merging duplicate vertices,
+ * building the index buffer and uploading.
+ */
+static void BM_MeshConstruction(benchmark::State& state) {
+  NullGL::install();
+  GridData grid = makeGrid(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    Mesh mesh(grid.vertices.data(), grid.colors.data(), grid.vertices.size() * sizeof(float));
+    benchmark::DoNotOptimize(mesh.getIndexCount());
+  }
+  state.SetItemsProcessed(state.iterations() * (grid.vertices.size() / 3));
+}
+BENCHMARK(BM_MeshConstruction)->RangeMultiplier(4)->Range(4, 256)->Unit(benchmark::kMicrosecond);
+
+/**
+ * Submits a frame of cubes one draw at a time through the render queue, then sorts and executes it.
+ */
+static void BM_RenderSubmit(benchmark::State& state) {
+  NullGL::install();
+  Camera camera(45.0f, 4.0f / 3.0f, 0.1f, 100.0f);
+  ShaderProgram program("", "");
+  program.init(vertexShaderSource, fragmentShaderSource);
+  Renderer renderer(&camera, &program);
+  GridData grid = makeGrid(1);
+  Mesh mesh(grid.vertices.data(), grid.colors.data(), grid.vertices.size() * sizeof(float));
+  std::vector<glm::mat4> models = rowMatrices(static_cast<int>(state.range(0)));
+
+  for (auto _ : state) {
+    renderer.beginFrame();
+    for (const glm::mat4& model : models) {
+      renderer.submit(mesh, model);
+    }
+    renderer.flush();
+    renderer.endFrame();
+    NullGL::endFrame();
+  }
+  state.SetItemsProcessed(state.iterations() * models.size());
+  state.counters["streamWords"] = static_cast<double>(NullGL::getLastFrame().size());
+}
+BENCHMARK(BM_RenderSubmit)->RangeMultiplier(8)->Range(64, 4096)->Unit(benchmark::kMicrosecond);
+
+/**
+ * Submits the same frame of cubes as one instanced draw, streaming the model matrices.
+ */
+static void BM_RenderInstanced(benchmark::State& state) {
+  NullGL::install();
+  Camera camera(45.0f, 4.0f / 3.0f, 0.1f, 100.0f);
+  ShaderProgram program("", "");
+  program.init(vertexShaderSource, fragmentShaderSource);
+  Renderer renderer(&camera, &program);
+  GridData grid = makeGrid(1);
+  Mesh mesh(grid.vertices.data(), grid.colors.data(), grid.vertices.size() * sizeof(float));
+  std::vector<glm::mat4> models = rowMatrices(static_cast<int>(state.range(0)));
+
+  for (auto _ : state) {
+    renderer.beginFrame();
+    renderer.renderInstanced(mesh, models.data(), models.size());
+    renderer.endFrame();
+    NullGL::endFrame();
+  }
+  state.SetItemsProcessed(state.iterations() * models.size());
+  state.counters["streamWords"] = static_cast<double>(NullGL::getLastFrame().size());
+}
+BENCHMARK(BM_RenderInstanced)->RangeMultiplier(8)->Range(64, 4096)->Unit(benchmark::kMicrosecond);
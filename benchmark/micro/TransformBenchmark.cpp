@@ -0,0 +1,162 @@
+/**
+ * @file TransformBenchmark.cpp
+ * @brief Microbenchmarks comparing per-object glm transform updates with the SoA batch kernels of TransformStore, for
+ * 100k entities.
+ */
+
+#include <benchmark/benchmark.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <random>
+#include <vector>
+#include "../../entity/TransformStore.h"
+
+namespace {
+  /**
+   * Number of entities updated by every benchmark.
+   */
+  const size_t entityCount = 100000;
+
+  /**
+   * A transform as a game object would hold it, next to the matrices derived from it.
+   */
+  struct Transform {
+    glm::vec3 position;
+    glm::quat rotation;
+    glm::vec3 scale;
+    glm::mat4 world;
+    glm::mat4 mvp;
+  };
+
+  /**
+   * Transforms scattered over a 1000 x 1000 unit field, the same for every benchmark.
+   */
+  const std::vector<Transform>& sceneTransforms() {
+    static std::vector<Transform> transforms = [] {
+      std::mt19937 random(1234);
+      std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+      std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+      std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+
+      std::vector<Transform> result(entityCount);
+      for (Transform& transform : result) {
+        transform.position = glm::vec3(position(random), position(random), position(random));
+        transform.rotation = glm::angleAxis(angle(random), glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f)));
+        transform.scale = glm::vec3(scale(random));
+      }
+      return result;
+    }();
+    return transforms;
+  }
+
+  /**
+   * Builds a store holding the scene transforms, with all matrices up to date for the given camera.
+   */
+  void fillStore(TransformStore& store, const glm::mat4& viewProjection) {
+    for (const Transform& transform : sceneTransforms()) {
+      store.create(transform.position, transform.rotation, transform.scale);
+    }
+    store.updateMvpMatrices(viewProjection);
+  }
+
+  /**
+   * Camera looking at the field, turned a little further on every call so that every frame has a new view.
+   */
+  glm::mat4 cameraMatrix(int frame) {
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, 300.0f);
+    glm::vec3 direction(std::cos(frame * 0.01f), -0.2f, std::sin(frame * 0.01f));
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 10.0f, 0.0f), glm::vec3(0.0f, 10.0f, 0.0f) + direction,
+                                 glm::vec3(0.0f, 1.0f, 0.0f));
+    return projection * view;
+  }
+
+  /**
+   * A rotation that changes every frame, applied to the entities that move.
+   */
+  glm::quat frameRotation(int frame) {
+    return glm::angleAxis(frame * 0.01f, glm::vec3(0.0f, 1.0f, 0.0f));
+  }
+}
+
+/**
+ * Moves every entity and rebuilds its world and MVP matrices one object at a time with glm, the baseline.
+ */
+static void BM_TransformsGlm(benchmark::State& state) {
+  std::vector<Transform> transforms = sceneTransforms();
+  int frame = 0;
+
+  for (auto _ : state) {
+    glm::mat4 viewProjection = cameraMatrix(frame);
+    glm::quat rotation = frameRotation(frame++);
+    for (Transform& transform : transforms) {
+      transform.rotation = rotation;
+      transform.world = glm::translate(glm::mat4(1.0f), transform.position) * glm::mat4_cast(transform.rotation)
+                      * glm::scale(glm::mat4(1.0f), transform.scale);
+      transform.mvp = viewProjection * transform.world;
+    }
+    benchmark::DoNotOptimize(transforms.data());
+  }
+  state.SetItemsProcessed(state.iterations() * entityCount);
+}
+BENCHMARK(BM_TransformsGlm);
+
+/**
+ * Moves every entity and rebuilds all matrices with the SIMD batch kernels, the same work as the baseline.
+ */
+static void BM_TransformsSoa(benchmark::State& state) {
+  TransformStore store;
+  fillStore(store, cameraMatrix(0));
+  int frame = 1;
+
+  for (auto _ : state) {
+    glm::mat4 viewProjection = cameraMatrix(frame);
+    glm::quat rotation = frameRotation(frame++);
+    for (Entity entity = 0; entity < entityCount; ++entity) {
+      store.setRotation(entity, rotation);
+    }
+    store.updateMvpMatrices(viewProjection);
+    benchmark::DoNotOptimize(store.getMvpMatrices());
+  }
+  state.SetItemsProcessed(state.iterations() * entityCount);
+}
+BENCHMARK(BM_TransformsSoa);
+
+/**
+ * Moves a percentage of the entities, spread over the whole store, under a still camera, so only the dirty
+ * entities' matrices are rebuilt.
+ */
+static void BM_TransformsSoaDirty(benchmark::State& state) {
+  TransformStore store;
+  fillStore(store, cameraMatrix(0));
+  size_t stride = 100 / static_cast<size_t>(state.range(0));
+  int frame = 1;
+
+  for (auto _ : state) {
+    glm::quat rotation = frameRotation(frame++);
+    for (Entity entity = 0; entity < entityCount; entity += stride) {
+      store.setRotation(entity, rotation);
+    }
+    store.updateMvpMatrices(cameraMatrix(0));
+    benchmark::DoNotOptimize(store.getMvpMatrices());
+  }
+  state.SetItemsProcessed(state.iterations() * entityCount);
+  state.counters["world"] = static_cast<double>(store.getStats().worldMatricesUpdated);
+  state.counters["mvp"] = static_cast<double>(store.getStats().mvpMatricesUpdated);
+}
+BENCHMARK(BM_TransformsSoaDirty)->Arg(1)->Arg(10)->Arg(100);
+
+/**
+ * Moves nothing while the camera turns, so every MVP matrix is rebuilt from the cached world matrices.
+ */
+static void BM_TransformsSoaCameraOnly(benchmark::State& state) {
+  TransformStore store;
+  fillStore(store, cameraMatrix(0));
+  int frame = 1;
+
+  for (auto _ : state) {
+    store.updateMvpMatrices(cameraMatrix(frame++));
+    benchmark::DoNotOptimize(store.getMvpMatrices());
+  }
+  state.SetItemsProcessed(state.iterations() * entityCount);
+}
+BENCHMARK(BM_TransformsSoaCameraOnly);
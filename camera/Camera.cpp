@@ -7,27 +7,17 @@
 
 Camera::Camera(GLfloat fov, GLfloat aspectRatio, GLfloat nearClip, GLfloat farClip)
   : position(glm::vec3(2,2,10)),
+    previousPosition(position),
+    renderPosition(position),
     target(glm::vec3(0,0,0)),
     up(glm::vec3(0,1,0)),
     horizontalAngle(3.14f),
     verticalAngle(0.0f),
     initialFov(fov),
     cameraSpeed(3.0f),
-    mouseSpeed(0.05f) {
+    mouseSpeed(0.0008f) {
   
-  viewDirection = glm::vec3 (
-      cos(verticalAngle) * sin(horizontalAngle),
-      sin(verticalAngle),
-      cos(verticalAngle) * cos(horizontalAngle)
-  );
-
-  sideVector = glm::vec3(
-    sin(horizontalAngle - 3.14f/2.0f),
-    0,
-    cos(horizontalAngle - 3.14f/2.0f)
-  );
-
-  updateTarget();
+  updateDirection();
   projectionMatrix = glm::perspective(glm::radians(fov), aspectRatio, nearClip, farClip);
 }
 
@@ -37,40 +27,75 @@ glm::mat4 Camera::getProjectionMatrix() const {
 
 glm::mat4 Camera::getViewMatrix() const {
   return glm::lookAt(
-    position,
+    renderPosition,
     target,
     up
   );
 }
 
+Frustum Camera::getFrustum() const {
+  return Frustum::fromMatrix(projectionMatrix * getViewMatrix());
+}
+
+glm::vec3 Camera::getPosition() const {
+  return renderPosition;
+}
+
 void Camera::moveBackward(double deltaTime) {
   position -= viewDirection * cameraSpeed * static_cast<GLfloat>(deltaTime);
+  renderPosition = position;
   updateTarget();
 }
 
 void Camera::moveForward(double deltaTime) {
   position += viewDirection * cameraSpeed * static_cast<GLfloat>(deltaTime);
+  renderPosition = position;
   updateTarget();
 }
 
 void Camera::moveLeft(double deltaTime) {
   position -= sideVector * cameraSpeed * static_cast<GLfloat>(deltaTime);
+  renderPosition = position;
   updateTarget();
 }
 
 void Camera::moveRight(double deltaTime) {
   position += sideVector * cameraSpeed * static_cast<GLfloat>(deltaTime);
+  renderPosition = position;
   updateTarget();
 }
 
 void Camera::updateTarget() {
-  target = position + viewDirection;
+  target = renderPosition + viewDirection;
+}
+
+void Camera::beginTick() {
+  previousPosition = position;
+}
+
+void Camera::interpolate(double alpha) {
+  renderPosition = glm::mix(previousPosition, position, static_cast<GLfloat>(alpha));
+  updateTarget();
 }
 
-void Camera::updateOrientation(double deltaTime, double xPosition, double yPosition, int screenWidth, int screenHeight) {
-  horizontalAngle += mouseSpeed * deltaTime * float(screenWidth / 2 - xPosition);
-  verticalAngle   += mouseSpeed * deltaTime * float(screenHeight / 2 - yPosition);
+void Camera::updateOrientation(double deltaX, double deltaY) {
+  horizontalAngle -= mouseSpeed * float(deltaX);
+  verticalAngle   -= mouseSpeed * float(deltaY);
+
+  updateDirection();
+}
+
+void Camera::setPose(const glm::vec3& newPosition, GLfloat newHorizontalAngle, GLfloat newVerticalAngle) {
+  position = newPosition;
+  previousPosition = newPosition;
+  renderPosition = newPosition;
+  horizontalAngle = newHorizontalAngle;
+  verticalAngle = newVerticalAngle;
+
+  updateDirection();
+}
 
+void Camera::updateDirection() {
   viewDirection = glm::vec3(
     cos(verticalAngle) * sin(horizontalAngle),
     sin(verticalAngle),
@@ -9,6 +9,7 @@
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include "../culling/Frustum.h"
 
 /**
  * @class Camera
@@ -44,6 +45,17 @@ public:
    */
   glm::mat4 getViewMatrix() const;
 
+  /**
+   * @brief Retrieves the view frustum of the camera.
+   * @return The clipping planes of the current view and projection matrices, for culling objects outside the view.
+   */
+  Frustum getFrustum() const;
+
+  /**
+   * @brief Retrieves the position the camera is rendered from.
+   */
+  glm::vec3 getPosition() const;
+
   /**
    * @brief Moves the camera backward along its view direction.
    * @param deltaTime The time elapsed since the last frame, used to calculate consistent movement speed.
@@ -71,20 +83,50 @@ public:
   /**
    * @brief Updates the camera's orientation based on mouse movement.
    *
-   * This function adjusts the camera's horizontal and vertical angles according to the mouse's position
-   * on the screen, which affects the camera's view direction and creates a first-person camera effect.
+   * This function adjusts the camera's horizontal and vertical angles by the distance the mouse moved, which affects
+   * the camera's view direction and creates a first-person camera effect. The turn depends only on the distance, not
+   * on the frame time, so the same hand motion turns the camera equally far at any frame rate.
+   *
+   * @param deltaX Horizontal mouse motion, positive to the right.
+   * @param deltaY Vertical mouse motion, positive downwards.
+   */
+  void updateOrientation(double deltaX, double deltaY);
+
+  /**
+   * @brief Places the camera at an exact position and orientation.
+   *
+   * Used to drive the camera along a scripted path, e.g. by the frame benchmark, independently of user input.
+   *
+   * @param newPosition Position of the camera in world space.
+   * @param newHorizontalAngle Horizontal angle of the view direction, in radians.
+   * @param newVerticalAngle Vertical angle of the view direction, in radians.
+   */
+  void setPose(const glm::vec3& newPosition, GLfloat newHorizontalAngle, GLfloat newVerticalAngle);
+
+  /**
+   * @brief Remembers the current position as the start of a fixed simulation tick.
+   *
+   * Call before applying a tick's movement so that interpolate() can blend between the two tick states.
+   */
+  void beginTick();
+
+  /**
+   * @brief Places the rendered viewpoint between the previous and the current tick positions.
+   * @param alpha Interpolation factor in [0, 1], where 0 is the previous tick and 1 is the current one.
    *
-   * @param deltaTime Time elapsed since the last frame, used to scale the orientation change for smooth movement.
-   * @param xPosition Current x-coordinate of the mouse cursor within the window.
-   * @param yPosition Current y-coordinate of the mouse cursor within the window.
-   * @param screenWidth Width of the window, used to calculate the mouse offset.
-   * @param screenHeight Height of the window, used to calculate the mouse offset.
+   * Movement through moveForward() and friends snaps the rendered viewpoint to the new position; this call is only
+   * needed when the camera is simulated at a fixed tick rate that differs from the frame rate.
    */
-  void updateOrientation(double deltaTime, double xPosition, double yPosition, int screenWidth, int screenHeight);
+  void interpolate(double alpha);
 
 private:
   /**
-   * @brief Updates the target point the camera is looking at based on its position and view direction.
+   * @brief Recomputes the view direction and side vector from the horizontal and vertical angles.
+   */
+  void updateDirection();
+
+  /**
+   * @brief Updates the target point the camera is looking at based on its rendered position and view direction.
    *
    * Ensures the target point remains aligned with the camera's orientation.
    */
@@ -100,6 +142,16 @@ private:
    */
   glm::vec3 position;
 
+  /**
+   * The position of the camera at the start of the latest simulation tick.
+   */
+  glm::vec3 previousPosition;
+
+  /**
+   * The position the view matrix is built from, interpolated between ticks.
+   */
+  glm::vec3 renderPosition;
+
   /**
    * The target point the camera is looking at.
    */
@@ -132,7 +184,7 @@ private:
   GLfloat cameraSpeed;
 
   /**
-   * The speed at which the camera responds to mouse movements.
+   * The angle in radians the camera turns per unit of mouse movement.
    */
   GLfloat mouseSpeed;
 
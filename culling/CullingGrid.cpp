@@ -0,0 +1,234 @@
+/**
+ * @file CullingGrid.cpp
+ * @brief Implements the CullingGrid class, a uniform grid of bounding boxes for fast frustum culling.
+ */
+
+#include "CullingGrid.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+  /**
+   * Average number of objects per grid cell the grid resolution aims for.
+   */
+  const size_t objectsPerCell = 64;
+
+  /**
+   * Upper limit on the number of cells along each axis.
+   */
+  const size_t maxCellsPerAxis = 128;
+
+  /**
+   * For one plane, the box coordinates furthest along its normal: the max arrays where the normal component is
+   * positive and the min arrays elsewhere. A box is outside the plane when that corner is.
+   */
+  struct PlaneCorner {
+    float x, y, z, w;
+    const float* cornerX;
+    const float* cornerY;
+    const float* cornerZ;
+  };
+}
+
+CullingGrid::CullingGrid() {}
+
+void CullingGrid::build(const AABB* boxes, size_t count) {
+  cells.clear();
+  if (count == 0) {
+    minX.clear(); minY.clear(); minZ.clear();
+    maxX.clear(); maxY.clear(); maxZ.clear();
+    objectIds.clear();
+    return;
+  }
+
+  // Span the grid over the box centers in the XZ plane
+  glm::vec2 low(boxes[0].min.x + boxes[0].max.x, boxes[0].min.z + boxes[0].max.z);
+  glm::vec2 high = low;
+  for (size_t i = 1; i < count; ++i) {
+    glm::vec2 center(boxes[i].min.x + boxes[i].max.x, boxes[i].min.z + boxes[i].max.z);
+    low = glm::min(low, center);
+    high = glm::max(high, center);
+  }
+  low *= 0.5f;
+  high *= 0.5f;
+
+  size_t cellsPerAxis = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count) / objectsPerCell)));
+  cellsPerAxis = std::min(std::max<size_t>(cellsPerAxis, 1), maxCellsPerAxis);
+  glm::vec2 cellScale = glm::vec2(static_cast<float>(cellsPerAxis)) / glm::max(high - low, glm::vec2(1e-6f));
+
+  // Counting sort the boxes into their cells
+  std::vector<uint32_t> cellOfObject(count);
+  std::vector<uint32_t> cellStart(cellsPerAxis * cellsPerAxis + 1, 0);
+  for (size_t i = 0; i < count; ++i) {
+    glm::vec2 center((boxes[i].min.x + boxes[i].max.x) * 0.5f, (boxes[i].min.z + boxes[i].max.z) * 0.5f);
+    glm::vec2 cell = (center - low) * cellScale;
+    size_t cellX = std::min(static_cast<size_t>(std::max(cell.x, 0.0f)), cellsPerAxis - 1);
+    size_t cellZ = std::min(static_cast<size_t>(std::max(cell.y, 0.0f)), cellsPerAxis - 1);
+    cellOfObject[i] = static_cast<uint32_t>(cellX + cellZ * cellsPerAxis);
+    ++cellStart[cellOfObject[i] + 1];
+  }
+  for (size_t i = 1; i < cellStart.size(); ++i) {
+    cellStart[i] += cellStart[i - 1];
+  }
+
+  minX.resize(count); minY.resize(count); minZ.resize(count);
+  maxX.resize(count); maxY.resize(count); maxZ.resize(count);
+  objectIds.resize(count);
+
+  std::vector<uint32_t> cursor(cellStart.begin(), cellStart.end() - 1);
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t slot = cursor[cellOfObject[i]]++;
+    minX[slot] = boxes[i].min.x; minY[slot] = boxes[i].min.y; minZ[slot] = boxes[i].min.z;
+    maxX[slot] = boxes[i].max.x; maxY[slot] = boxes[i].max.y; maxZ[slot] = boxes[i].max.z;
+    objectIds[slot] = static_cast<uint32_t>(i);
+  }
+
+  // Keep the non-empty cells, each bounded by the union of its boxes
+  for (size_t cell = 0; cell + 1 < cellStart.size(); ++cell) {
+    uint32_t first = cellStart[cell];
+    uint32_t end = cellStart[cell + 1];
+    if (first == end) {
+      continue;
+    }
+
+    Cell entry = { { glm::vec3(minX[first], minY[first], minZ[first]), glm::vec3(maxX[first], maxY[first], maxZ[first]) }, first, end - first };
+    for (uint32_t i = first + 1; i < end; ++i) {
+      entry.bounds.min = glm::min(entry.bounds.min, glm::vec3(minX[i], minY[i], minZ[i]));
+      entry.bounds.max = glm::max(entry.bounds.max, glm::vec3(maxX[i], maxY[i], maxZ[i]));
+    }
+    cells.push_back(entry);
+  }
+}
+
+void CullingGrid::cull(const Frustum& frustum, std::vector<uint32_t>& visible, bool hierarchical) {
+  visible.clear();
+  stats = CullingStats();
+
+  if (!hierarchical) {
+    cullObjects(frustum, 0, static_cast<uint32_t>(objectIds.size()), visible);
+    stats.objectsTested = objectIds.size();
+    stats.objectsVisible = visible.size();
+    return;
+  }
+
+  for (const Cell& cell : cells) {
+    ++stats.cellsTested;
+    FrustumTest test = frustum.classify(cell.bounds);
+    if (test == FrustumTest::Outside) {
+      continue;
+    }
+
+    ++stats.cellsVisible;
+    if (test == FrustumTest::Inside) {
+      visible.insert(visible.end(), objectIds.begin() + cell.first, objectIds.begin() + cell.first + cell.count);
+    } else {
+      stats.objectsTested += cell.count;
+      cullObjects(frustum, cell.first, cell.count, visible);
+    }
+  }
+  stats.objectsVisible = visible.size();
+}
+
+void CullingGrid::cullObjects(const Frustum& frustum, uint32_t first, uint32_t count, std::vector<uint32_t>& visible) const {
+  // The sign of each normal component is the same for every box, so the corner arrays are picked once per plane
+  // and the inner loops need no per-box selects
+  PlaneCorner planes[Frustum::planeCount];
+  for (int p = 0; p < Frustum::planeCount; ++p) {
+    const glm::vec4& plane = frustum.getPlane(p);
+    planes[p] = {
+      plane.x, plane.y, plane.z, plane.w,
+      (plane.x >= 0 ? maxX : minX).data(),
+      (plane.y >= 0 ? maxY : minY).data(),
+      (plane.z >= 0 ? maxZ : minZ).data()
+    };
+  }
+
+  uint32_t end = first + count;
+  uint32_t i = first;
+
+#if defined(__AVX__)
+  for (; i + 8 <= end; i += 8) {
+    __m256 outside = _mm256_setzero_ps();
+    for (const PlaneCorner& plane : planes) {
+      __m256 distance = _mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x), _mm256_loadu_ps(plane.cornerX + i)),
+                      _mm256_mul_ps(_mm256_set1_ps(plane.y), _mm256_loadu_ps(plane.cornerY + i))),
+        _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.z), _mm256_loadu_ps(plane.cornerZ + i)),
+                      _mm256_set1_ps(plane.w)));
+      outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_LT_OQ));
+    }
+    int visibleMask = ~_mm256_movemask_ps(outside);
+    for (int lane = 0; lane < 8; ++lane) {
+      if (visibleMask & (1 << lane)) {
+        visible.push_back(objectIds[i + lane]);
+      }
+    }
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  for (; i + 4 <= end; i += 4) {
+    __m128 outside = _mm_setzero_ps();
+    for (const PlaneCorner& plane : planes) {
+      __m128 distance = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), _mm_loadu_ps(plane.cornerX + i)),
+                   _mm_mul_ps(_mm_set1_ps(plane.y), _mm_loadu_ps(plane.cornerY + i))),
+        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.z), _mm_loadu_ps(plane.cornerZ + i)),
+                   _mm_set1_ps(plane.w)));
+      outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, _mm_setzero_ps()));
+    }
+    int visibleMask = ~_mm_movemask_ps(outside);
+    for (int lane = 0; lane < 4; ++lane) {
+      if (visibleMask & (1 << lane)) {
+        visible.push_back(objectIds[i + lane]);
+      }
+    }
+  }
+#elif defined(__ARM_NEON)
+  for (; i + 4 <= end; i += 4) {
+    uint32x4_t outside = vdupq_n_u32(0);
+    for (const PlaneCorner& plane : planes) {
+      float32x4_t distance = vdupq_n_f32(plane.w);
+      distance = vmlaq_n_f32(distance, vld1q_f32(plane.cornerX + i), plane.x);
+      distance = vmlaq_n_f32(distance, vld1q_f32(plane.cornerY + i), plane.y);
+      distance = vmlaq_n_f32(distance, vld1q_f32(plane.cornerZ + i), plane.z);
+      outside = vorrq_u32(outside, vcltq_f32(distance, vdupq_n_f32(0.0f)));
+    }
+    uint32_t lanes[4];
+    vst1q_u32(lanes, outside);
+    for (int lane = 0; lane < 4; ++lane) {
+      if (!lanes[lane]) {
+        visible.push_back(objectIds[i + lane]);
+      }
+    }
+  }
+#endif
+
+  // Remaining boxes, or all of them without SIMD support
+  for (; i < end; ++i) {
+    bool inside = true;
+    for (const PlaneCorner& plane : planes) {
+      if (plane.x * plane.cornerX[i] + plane.y * plane.cornerY[i] + plane.z * plane.cornerZ[i] + plane.w < 0) {
+        inside = false;
+        break;
+      }
+    }
+    if (inside) {
+      visible.push_back(objectIds[i]);
+    }
+  }
+}
+
+const CullingStats& CullingGrid::getStats() const {
+  return stats;
+}
+
+size_t CullingGrid::getObjectCount() const {
+  return objectIds.size();
+}
@@ -0,0 +1,123 @@
+/**
+ * @file CullingGrid.h
+ * @brief Declares the CullingGrid class, a uniform grid of bounding boxes for fast frustum culling.
+ */
+
+#ifndef CULLING_GRID_H
+#define CULLING_GRID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Frustum.h"
+
+/**
+ * @struct CullingStats
+ * @brief Counters from the last CullingGrid::cull() call.
+ */
+struct CullingStats {
+  /**
+   * Number of grid cells tested against the frustum.
+   */
+  size_t cellsTested = 0;
+
+  /**
+   * Number of grid cells found fully or partially inside the frustum.
+   */
+  size_t cellsVisible = 0;
+
+  /**
+   * Number of objects tested individually. Objects in cells fully inside the frustum are accepted untested.
+   */
+  size_t objectsTested = 0;
+
+  /**
+   * Number of objects found visible.
+   */
+  size_t objectsVisible = 0;
+};
+
+/**
+ * @class CullingGrid
+ * @brief A static set of bounding boxes, bucketed into a uniform grid in the XZ plane, that can be culled quickly.
+ *
+ * Culling first classifies each grid cell, using the union of the boxes inside it. Cells outside the frustum reject
+ * all their objects at once and cells fully inside accept all of them, so individual boxes are only tested in cells
+ * crossing a frustum plane. Those boxes are stored as separate min/max coordinate arrays (structure of arrays),
+ * grouped by cell, which lets each plane be tested against 8 (AVX), 4 (SSE or NEON) boxes per instruction.
+ */
+class CullingGrid {
+public:
+  /**
+   * @brief Constructs an empty grid.
+   */
+  CullingGrid();
+
+  /**
+   * @brief Replaces the contents of the grid.
+   * @param boxes Bounding boxes of the objects, identified by their index in this array.
+   * @param count Number of boxes.
+   */
+  void build(const AABB* boxes, size_t count);
+
+  /**
+   * @brief Finds the objects whose bounding boxes intersect the frustum.
+   * @param frustum Frustum to test against.
+   * @param visible Receives the indices of the visible objects, grouped by grid cell.
+   * @param hierarchical Whether to reject and accept whole cells first. When false every box is tested, which only
+   * exists to measure what the grid saves.
+   */
+  void cull(const Frustum& frustum, std::vector<uint32_t>& visible, bool hierarchical = true);
+
+  /**
+   * @brief Get the counters from the last cull() call.
+   */
+  const CullingStats& getStats() const;
+
+  /**
+   * @brief Get the number of objects in the grid.
+   */
+  size_t getObjectCount() const;
+
+private:
+  /**
+   * A grid cell, referring to a contiguous range of the object arrays.
+   */
+  struct Cell {
+    AABB bounds;
+    uint32_t first;
+    uint32_t count;
+  };
+
+  /**
+   * @brief Tests a contiguous range of objects individually, appending the visible ones.
+   */
+  void cullObjects(const Frustum& frustum, uint32_t first, uint32_t count, std::vector<uint32_t>& visible) const;
+
+  /**
+   * Non-empty grid cells.
+   */
+  std::vector<Cell> cells;
+
+  /**
+   * Box minimum X coordinates, grouped by cell. The other five arrays follow the same order.
+   */
+  std::vector<float> minX;
+  std::vector<float> minY;
+  std::vector<float> minZ;
+  std::vector<float> maxX;
+  std::vector<float> maxY;
+  std::vector<float> maxZ;
+
+  /**
+   * Index of each box in the array passed to build().
+   */
+  std::vector<uint32_t> objectIds;
+
+  /**
+   * Counters from the last cull() call.
+   */
+  CullingStats stats;
+};
+
+#endif
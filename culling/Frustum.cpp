@@ -0,0 +1,62 @@
+/**
+ * @file Frustum.cpp
+ * @brief Implements the Frustum class, which extracts clipping planes and tests bounding boxes against them.
+ */
+
+#include "Frustum.h"
+
+Frustum Frustum::fromMatrix(const glm::mat4& viewProjection) {
+  // A clip space point is visible when -w <= x, y, z <= w. Each inequality is a plane built from the rows of the
+  // matrix (Gribb and Hartmann); glm stores columns, so row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+  glm::vec4 rows[4];
+  for (int i = 0; i < 4; ++i) {
+    rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+  }
+
+  Frustum frustum;
+  frustum.planes[0] = rows[3] + rows[0];
+  frustum.planes[1] = rows[3] - rows[0];
+  frustum.planes[2] = rows[3] + rows[1];
+  frustum.planes[3] = rows[3] - rows[1];
+  frustum.planes[4] = rows[3] + rows[2];
+  frustum.planes[5] = rows[3] - rows[2];
+
+  // Normalize, so that plane distances are in world units
+  for (glm::vec4& plane : frustum.planes) {
+    plane /= glm::length(glm::vec3(plane));
+  }
+  return frustum;
+}
+
+FrustumTest Frustum::classify(const AABB& box) const {
+  FrustumTest result = FrustumTest::Inside;
+
+  for (const glm::vec4& plane : planes) {
+    // The corner furthest along the plane normal decides whether anything is inside, the opposite corner whether
+    // everything is
+    glm::vec3 positive(plane.x >= 0 ? box.max.x : box.min.x, plane.y >= 0 ? box.max.y : box.min.y, plane.z >= 0 ? box.max.z : box.min.z);
+    glm::vec3 negative(plane.x >= 0 ? box.min.x : box.max.x, plane.y >= 0 ? box.min.y : box.max.y, plane.z >= 0 ? box.min.z : box.max.z);
+
+    if (glm::dot(glm::vec3(plane), positive) + plane.w < 0) {
+      return FrustumTest::Outside;
+    }
+    if (glm::dot(glm::vec3(plane), negative) + plane.w < 0) {
+      result = FrustumTest::Intersecting;
+    }
+  }
+  return result;
+}
+
+bool Frustum::intersects(const AABB& box) const {
+  for (const glm::vec4& plane : planes) {
+    glm::vec3 positive(plane.x >= 0 ? box.max.x : box.min.x, plane.y >= 0 ? box.max.y : box.min.y, plane.z >= 0 ? box.max.z : box.min.z);
+    if (glm::dot(glm::vec3(plane), positive) + plane.w < 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const glm::vec4& Frustum::getPlane(int index) const {
+  return planes[index];
+}
@@ -0,0 +1,76 @@
+/**
+ * @file Frustum.h
+ * @brief Declares the AABB and Frustum types used for visibility tests.
+ */
+
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+/**
+ * @struct AABB
+ * @brief An axis-aligned bounding box in world space.
+ */
+struct AABB {
+  glm::vec3 min;
+  glm::vec3 max;
+};
+
+/**
+ * @enum FrustumTest
+ * @brief Result of testing a bounding box against a frustum.
+ */
+enum class FrustumTest {
+  Outside,
+  Intersecting,
+  Inside
+};
+
+/**
+ * @class Frustum
+ * @brief The six clipping planes of a view-projection matrix, for testing what the camera can see.
+ *
+ * Each plane is stored as (normal, distance) with a unit normal pointing into the frustum, so a point p is inside a
+ * plane when dot(normal, p) + distance >= 0.
+ */
+class Frustum {
+public:
+  /**
+   * @brief Extracts the frustum planes from a combined view-projection matrix.
+   * @param viewProjection Projection matrix times view matrix, as used for OpenGL clip space.
+   */
+  static Frustum fromMatrix(const glm::mat4& viewProjection);
+
+  /**
+   * @brief Classifies a box as fully outside, partially inside or fully inside the frustum.
+   *
+   * The test is conservative: boxes near a frustum corner may be reported as intersecting although they are outside,
+   * but a visible box is never reported as outside.
+   */
+  FrustumTest classify(const AABB& box) const;
+
+  /**
+   * @brief Returns false if the box is certainly outside the frustum.
+   */
+  bool intersects(const AABB& box) const;
+
+  /**
+   * @brief Returns one plane, as (normal, distance).
+   * @param index Plane index: left, right, bottom, top, near, far.
+   */
+  const glm::vec4& getPlane(int index) const;
+
+  /**
+   * Number of planes in a frustum.
+   */
+  static const int planeCount = 6;
+
+private:
+  /**
+   * Clipping planes, in the order left, right, bottom, top, near, far.
+   */
+  glm::vec4 planes[planeCount];
+};
+
+#endif
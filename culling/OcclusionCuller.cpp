@@ -0,0 +1,375 @@
+/**
+ * @file OcclusionCuller.cpp
+ * @brief Implements the OcclusionCuller class, which skips objects hidden behind occluders using a CPU depth pyramid.
+ */
+
+#include "OcclusionCuller.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+  /**
+   * Number of depth buffer rows rasterized by each job.
+   */
+  const int bandHeight = 8;
+
+  /**
+   * Number of boxes tested by each job of cull().
+   */
+  const size_t testGrainSize = 256;
+
+  /**
+   * Depth the buffer is cleared to, that of the far plane: nothing beyond it is visible anyway.
+   */
+  const float farDepth = 1.0f;
+
+  /**
+   * Largest number of texels per axis a box may cover in the pyramid level it is tested against.
+   */
+  const int maxTestTexels = 4;
+
+  /**
+   * @brief Returns how far a clip space position lies in front of the near plane; negative when behind it.
+   */
+  float nearDistance(const glm::vec4& position) {
+    return position.z + position.w;
+  }
+
+  double secondsSince(std::chrono::steady_clock::time_point start) {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+  }
+}
+
+OcclusionCuller::OcclusionCuller(JobSystem* jobSystem, int width, int height)
+  : jobSystem(jobSystem),
+    width((std::max(width, 4) + 3) & ~3),
+    height(std::max(height, 1)),
+    viewProjection(1.0f) {
+  // Every level halves the one below, rounding up, down to a single texel
+  int levelWidth = this -> width;
+  int levelHeight = this -> height;
+  while (true) {
+    levels.push_back({ levelWidth, levelHeight, std::vector<float>(static_cast<size_t>(levelWidth) * levelHeight, farDepth) });
+    if (levelWidth == 1 && levelHeight == 1) {
+      break;
+    }
+    levelWidth = (levelWidth + 1) / 2;
+    levelHeight = (levelHeight + 1) / 2;
+  }
+}
+
+void OcclusionCuller::addOccluder(const glm::vec3* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount) {
+  if (vertexCount == 0) {
+    return;
+  }
+
+  Occluder occluder;
+  occluder.bounds = { vertices[0], vertices[0] };
+  occluder.firstIndex = static_cast<uint32_t>(occluderIndices.size());
+  occluder.indexCount = static_cast<uint32_t>(indexCount - indexCount % 3);
+
+  uint32_t firstVertex = static_cast<uint32_t>(occluderVertices.size());
+  for (size_t i = 0; i < vertexCount; ++i) {
+    occluder.bounds.min = glm::min(occluder.bounds.min, vertices[i]);
+    occluder.bounds.max = glm::max(occluder.bounds.max, vertices[i]);
+    occluderVertices.push_back(vertices[i]);
+  }
+  for (size_t i = 0; i < occluder.indexCount; ++i) {
+    occluderIndices.push_back(firstVertex + indices[i]);
+  }
+  occluders.push_back(occluder);
+}
+
+size_t OcclusionCuller::getOccluderCount() const {
+  return occluders.size();
+}
+
+void OcclusionCuller::render(const glm::mat4& viewProjection, const Frustum& frustum) {
+  auto start = std::chrono::steady_clock::now();
+  this -> viewProjection = viewProjection;
+  triangles.clear();
+  stats = OcclusionStats();
+
+  // Occluders are few and small, so their triangles are set up on this thread
+  for (const Occluder& occluder : occluders) {
+    if (!frustum.intersects(occluder.bounds)) {
+      continue;
+    }
+    ++stats.occluders;
+
+    for (uint32_t i = occluder.firstIndex; i < occluder.firstIndex + occluder.indexCount; i += 3) {
+      glm::vec4 positions[3];
+      for (int corner = 0; corner < 3; ++corner) {
+        positions[corner] = viewProjection * glm::vec4(occluderVertices[occluderIndices[i + corner]], 1.0f);
+      }
+
+      if (nearDistance(positions[0]) >= 0.0f && nearDistance(positions[1]) >= 0.0f && nearDistance(positions[2]) >= 0.0f) {
+        setupTriangle(positions);
+        continue;
+      }
+
+      // Clip the parts in front of the near plane away, leaving a polygon of up to four vertices drawn as a fan
+      glm::vec4 clipped[4];
+      int clippedCount = 0;
+      for (int corner = 0; corner < 3; ++corner) {
+        const glm::vec4& current = positions[corner];
+        const glm::vec4& next = positions[(corner + 1) % 3];
+        float currentDistance = nearDistance(current);
+        float nextDistance = nearDistance(next);
+        if (currentDistance >= 0.0f) {
+          clipped[clippedCount++] = current;
+        }
+        if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f)) {
+          clipped[clippedCount++] = current + (next - current) * (currentDistance / (currentDistance - nextDistance));
+        }
+      }
+      for (int corner = 2; corner < clippedCount; ++corner) {
+        glm::vec4 fan[3] = { clipped[0], clipped[corner - 1], clipped[corner] };
+        setupTriangle(fan);
+      }
+    }
+  }
+  stats.occluderTriangles = triangles.size();
+
+  size_t bandCount = static_cast<size_t>((height + bandHeight - 1) / bandHeight);
+  jobSystem -> parallelFor(bandCount, 1, [this](size_t begin, size_t end) {
+    for (size_t band = begin; band < end; ++band) {
+      int minY = static_cast<int>(band) * bandHeight;
+      rasterizeBand(minY, std::min(minY + bandHeight, height) - 1);
+    }
+  });
+
+  buildPyramid();
+  stats.rasterTime = secondsSince(start);
+}
+
+void OcclusionCuller::setupTriangle(const glm::vec4* positions) {
+  float x[3];
+  float y[3];
+  float z[3];
+  for (int i = 0; i < 3; ++i) {
+    float inverseW = 1.0f / positions[i].w;
+    x[i] = (positions[i].x * inverseW * 0.5f + 0.5f) * width;
+    y[i] = (positions[i].y * inverseW * 0.5f + 0.5f) * height;
+    z[i] = positions[i].z * inverseW;
+  }
+
+  // Occluders are closed, so their back faces are always hidden behind their front faces
+  float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+  if (!(area > 0.0f)) {
+    return;
+  }
+
+  // Only pixels entirely within the triangle's bounds can be covered entirely. The bounds are clamped to the buffer
+  // before conversion, since vertices close to the near plane may project very far out
+  Triangle triangle;
+  triangle.minX = static_cast<int>(std::max(0.0f, std::ceil(std::min({ x[0], x[1], x[2] }))));
+  triangle.minY = static_cast<int>(std::max(0.0f, std::ceil(std::min({ y[0], y[1], y[2] }))));
+  triangle.maxX = static_cast<int>(std::min(static_cast<float>(width), std::floor(std::max({ x[0], x[1], x[2] })))) - 1;
+  triangle.maxY = static_cast<int>(std::min(static_cast<float>(height), std::floor(std::max({ y[0], y[1], y[2] })))) - 1;
+  if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) {
+    return;
+  }
+
+  // Each edge function is positive to the left of its edge, inside the counter-clockwise triangle. Subtracting its
+  // largest change from the pixel center to a corner leaves it non-negative only when the whole pixel is inside
+  for (int i = 0; i < 3; ++i) {
+    int j = (i + 1) % 3;
+    float a = y[i] - y[j];
+    float b = x[j] - x[i];
+    triangle.edges[i][0] = a;
+    triangle.edges[i][1] = b;
+    triangle.edges[i][2] = -(a * x[i] + b * y[i]) - 0.5f * (std::fabs(a) + std::fabs(b));
+  }
+
+  // Likewise, adding the largest change of the depth gives the farthest depth within the pixel
+  float depthX = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) / area;
+  float depthY = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) / area;
+  triangle.depth[0] = depthX;
+  triangle.depth[1] = depthY;
+  triangle.depth[2] = z[0] - depthX * x[0] - depthY * y[0] + 0.5f * (std::fabs(depthX) + std::fabs(depthY));
+
+  triangles.push_back(triangle);
+}
+
+void OcclusionCuller::rasterizeBand(int minY, int maxY) {
+  std::vector<float>& depths = levels[0].depths;
+  std::fill(depths.begin() + static_cast<size_t>(minY) * width, depths.begin() + static_cast<size_t>(maxY + 1) * width, farDepth);
+
+  for (const Triangle& triangle : triangles) {
+    int firstRow = std::max(triangle.minY, minY);
+    int lastRow = std::min(triangle.maxY, maxY);
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+      float centerY = row + 0.5f;
+      float edgeRows[3];
+      for (int i = 0; i < 3; ++i) {
+        edgeRows[i] = triangle.edges[i][1] * centerY + triangle.edges[i][2];
+      }
+      float depthRow = triangle.depth[1] * centerY + triangle.depth[2];
+      float* rowDepths = depths.data() + static_cast<size_t>(row) * width;
+
+      // Groups of four pixels start at multiples of four, so they never leave the row. Pixels of a group outside the
+      // triangle's bounds are not entirely covered, so the edge functions reject them
+      int x = triangle.minX & ~3;
+#if defined(__SSE2__) || defined(_M_X64)
+      const __m128 centerOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+      const __m128 zero = _mm_setzero_ps();
+      for (; x <= triangle.maxX; x += 4) {
+        __m128 centerX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), centerOffsets);
+        __m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.edges[0][0]), centerX), _mm_set1_ps(edgeRows[0])), zero);
+        inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.edges[1][0]), centerX), _mm_set1_ps(edgeRows[1])), zero));
+        inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.edges[2][0]), centerX), _mm_set1_ps(edgeRows[2])), zero));
+
+        __m128 depth = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.depth[0]), centerX), _mm_set1_ps(depthRow));
+        __m128 stored = _mm_loadu_ps(rowDepths + x);
+        __m128 nearest = _mm_min_ps(stored, depth);
+        _mm_storeu_ps(rowDepths + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, stored)));
+      }
+#elif defined(__ARM_NEON)
+      const float offsets[4] = { 0.5f, 1.5f, 2.5f, 3.5f };
+      const float32x4_t centerOffsets = vld1q_f32(offsets);
+      const float32x4_t zero = vdupq_n_f32(0.0f);
+      for (; x <= triangle.maxX; x += 4) {
+        float32x4_t centerX = vaddq_f32(vdupq_n_f32(static_cast<float>(x)), centerOffsets);
+        uint32x4_t inside = vcgeq_f32(vmlaq_n_f32(vdupq_n_f32(edgeRows[0]), centerX, triangle.edges[0][0]), zero);
+        inside = vandq_u32(inside, vcgeq_f32(vmlaq_n_f32(vdupq_n_f32(edgeRows[1]), centerX, triangle.edges[1][0]), zero));
+        inside = vandq_u32(inside, vcgeq_f32(vmlaq_n_f32(vdupq_n_f32(edgeRows[2]), centerX, triangle.edges[2][0]), zero));
+
+        float32x4_t depth = vmlaq_n_f32(vdupq_n_f32(depthRow), centerX, triangle.depth[0]);
+        float32x4_t stored = vld1q_f32(rowDepths + x);
+        vst1q_f32(rowDepths + x, vbslq_f32(inside, vminq_f32(stored, depth), stored));
+      }
+#else
+      for (; x <= triangle.maxX; ++x) {
+        float centerX = x + 0.5f;
+        if (triangle.edges[0][0] * centerX + edgeRows[0] >= 0.0f && triangle.edges[1][0] * centerX + edgeRows[1] >= 0.0f
+            && triangle.edges[2][0] * centerX + edgeRows[2] >= 0.0f) {
+          rowDepths[x] = std::min(rowDepths[x], triangle.depth[0] * centerX + depthRow);
+        }
+      }
+#endif
+    }
+  }
+}
+
+void OcclusionCuller::buildPyramid() {
+  // Each texel keeps the farthest of the up to four texels below it, so that it bounds every depth it covers
+  for (size_t level = 1; level < levels.size(); ++level) {
+    const Level& below = levels[level - 1];
+    Level& current = levels[level];
+    for (int y = 0; y < current.height; ++y) {
+      const float* row0 = below.depths.data() + static_cast<size_t>(2 * y) * below.width;
+      const float* row1 = below.depths.data() + static_cast<size_t>(std::min(2 * y + 1, below.height - 1)) * below.width;
+      float* output = current.depths.data() + static_cast<size_t>(y) * current.width;
+      for (int x = 0; x < current.width; ++x) {
+        int x0 = 2 * x;
+        int x1 = std::min(2 * x + 1, below.width - 1);
+        output[x] = std::max(std::max(row0[x0], row0[x1]), std::max(row1[x0], row1[x1]));
+      }
+    }
+  }
+}
+
+bool OcclusionCuller::isVisible(const AABB& box) const {
+  float minX = std::numeric_limits<float>::max();
+  float minY = std::numeric_limits<float>::max();
+  float maxX = -std::numeric_limits<float>::max();
+  float maxY = -std::numeric_limits<float>::max();
+  float minDepth = std::numeric_limits<float>::max();
+
+  for (int corner = 0; corner < 8; ++corner) {
+    glm::vec3 position((corner & 1) ? box.max.x : box.min.x, (corner & 2) ? box.max.y : box.min.y,
+                       (corner & 4) ? box.max.z : box.min.z);
+    glm::vec4 clip = viewProjection * glm::vec4(position, 1.0f);
+
+    // A box reaching in front of the near plane may cover the whole view
+    if (clip.w <= 0.0f || nearDistance(clip) < 0.0f) {
+      return true;
+    }
+
+    float inverseW = 1.0f / clip.w;
+    float x = (clip.x * inverseW * 0.5f + 0.5f) * width;
+    float y = (clip.y * inverseW * 0.5f + 0.5f) * height;
+    minX = std::min(minX, x);
+    minY = std::min(minY, y);
+    maxX = std::max(maxX, x);
+    maxY = std::max(maxY, y);
+    minDepth = std::min(minDepth, clip.z * inverseW);
+  }
+
+  // Every pixel the box's screen rectangle touches, even partly
+  int x0 = static_cast<int>(std::max(0.0f, std::floor(minX)));
+  int y0 = static_cast<int>(std::max(0.0f, std::floor(minY)));
+  int x1 = static_cast<int>(std::min(static_cast<float>(width - 1), std::floor(maxX)));
+  int y1 = static_cast<int>(std::min(static_cast<float>(height - 1), std::floor(maxY)));
+  if (x0 > x1 || y0 > y1) {
+    return false;
+  }
+
+  // Go up the pyramid until the rectangle spans only a few texels, which hold the farthest depth beneath them
+  size_t level = 0;
+  while (level + 1 < levels.size() && std::max((x1 >> level) - (x0 >> level), (y1 >> level) - (y0 >> level)) >= maxTestTexels) {
+    ++level;
+  }
+
+  const Level& texels = levels[level];
+  for (int y = y0 >> level; y <= y1 >> level; ++y) {
+    const float* row = texels.depths.data() + static_cast<size_t>(y) * texels.width;
+    for (int x = x0 >> level; x <= x1 >> level; ++x) {
+      if (row[x] >= minDepth) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void OcclusionCuller::cull(const AABB* boxes, std::vector<uint32_t>& objects) {
+  auto start = std::chrono::steady_clock::now();
+
+  visibility.resize(objects.size());
+  jobSystem -> parallelFor(objects.size(), testGrainSize, [this, boxes, &objects](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      visibility[i] = isVisible(boxes[objects[i]]) ? 1 : 0;
+    }
+  });
+
+  size_t kept = 0;
+  for (size_t i = 0; i < objects.size(); ++i) {
+    if (visibility[i]) {
+      objects[kept++] = objects[i];
+    }
+  }
+
+  stats.occludeesTested = objects.size();
+  stats.occludeesCulled = objects.size() - kept;
+  objects.resize(kept);
+  stats.testTime = secondsSince(start);
+}
+
+const std::vector<float>& OcclusionCuller::getDepthBuffer() const {
+  return levels[0].depths;
+}
+
+int OcclusionCuller::getWidth() const {
+  return width;
+}
+
+int OcclusionCuller::getHeight() const {
+  return height;
+}
+
+const OcclusionStats& OcclusionCuller::getStats() const {
+  return stats;
+}
@@ -0,0 +1,223 @@
+/**
+ * @file OcclusionCuller.h
+ * @brief Declares the OcclusionCuller class, which skips objects hidden behind large occluders using a depth pyramid
+ * rasterized on the CPU.
+ */
+
+#ifndef OCCLUSION_CULLER_H
+#define OCCLUSION_CULLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Frustum.h"
+#include "../jobs/JobSystem.h"
+
+/**
+ * @struct OcclusionStats
+ * @brief Counters of the work the OcclusionCuller did in the last frame.
+ */
+struct OcclusionStats {
+  /**
+   * Number of occluders inside the view, which were rasterized.
+   */
+  size_t occluders = 0;
+
+  /**
+   * Number of occluder triangles rasterized, after back faces were culled and the near plane clipped.
+   */
+  size_t occluderTriangles = 0;
+
+  /**
+   * Number of bounding boxes tested against the depth pyramid.
+   */
+  size_t occludeesTested = 0;
+
+  /**
+   * Number of tested boxes found to be hidden.
+   */
+  size_t occludeesCulled = 0;
+
+  /**
+   * Time spent rasterizing the occluders and building the depth pyramid, in seconds.
+   */
+  double rasterTime = 0;
+
+  /**
+   * Time spent testing boxes, in seconds.
+   */
+  double testTime = 0;
+};
+
+/**
+ * @class OcclusionCuller
+ * @brief Finds objects hidden behind a small set of large occluders, such as buildings, before they are submitted.
+ *
+ * Every frame, render() rasterizes the occluders inside the view into a low resolution depth buffer, in bands of rows
+ * spread over the job system and four pixels at a time with SIMD, then reduces it into a pyramid in which each texel
+ * holds the farthest depth of the four below it. cull() then projects each object's bounding box and compares its
+ * nearest depth against the level of the pyramid where the box spans at most a few texels.
+ *
+ * The culler never hides a visible object: a pixel only receives an occluder's depth when the occluder covers the
+ * whole pixel, and then its farthest depth within the pixel. Boxes reaching in front of the near plane are always
+ * visible.
+ *
+ * Occluders are static and given in world space. Depths are normalized device depths, with the OpenGL convention of
+ * -1 at the near plane and 1 at the far plane.
+ */
+class OcclusionCuller {
+public:
+  /**
+   * @brief Constructs an OcclusionCuller with a depth buffer of the given size.
+   * @param jobSystem Pointer to the job system the rasterization and tests run on.
+   * @param width Width of the depth buffer in pixels, rounded up to a multiple of 4.
+   * @param height Height of the depth buffer in pixels.
+   *
+   * The buffer covers the whole view whatever its aspect ratio; its resolution only sets the precision of the culling.
+   */
+  OcclusionCuller(JobSystem* jobSystem, int width = 256, int height = 128);
+
+  /**
+   * @brief Adds an occluder, a closed mesh whose front faces wind counter-clockwise.
+   * @param vertices Positions of the vertices in world space.
+   * @param vertexCount Number of vertices.
+   * @param indices Three vertex indices per triangle.
+   * @param indexCount Number of indices.
+   */
+  void addOccluder(const glm::vec3* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount);
+
+  /**
+   * @brief Get the number of occluders added.
+   */
+  size_t getOccluderCount() const;
+
+  /**
+   * @brief Rasterizes the occluders for a new view and builds the depth pyramid.
+   * @param viewProjection Projection matrix times view matrix of the view.
+   * @param frustum View frustum of the same view, used to skip occluders outside it.
+   */
+  void render(const glm::mat4& viewProjection, const Frustum& frustum);
+
+  /**
+   * @brief Checks whether any part of a box may be visible in the view of the last render().
+   */
+  bool isVisible(const AABB& box) const;
+
+  /**
+   * @brief Removes the hidden objects from a list, testing them in parallel.
+   * @param boxes Bounding boxes of all objects, indexed by the values in objects.
+   * @param objects Indices of the objects to test. Those found hidden are removed, keeping the others in order.
+   */
+  void cull(const AABB* boxes, std::vector<uint32_t>& objects);
+
+  /**
+   * @brief Get the depth buffer of the last render(), row by row from the bottom.
+   */
+  const std::vector<float>& getDepthBuffer() const;
+
+  /**
+   * @brief Get the width of the depth buffer in pixels.
+   */
+  int getWidth() const;
+
+  /**
+   * @brief Get the height of the depth buffer in pixels.
+   */
+  int getHeight() const;
+
+  /**
+   * @brief Get the counters of the last frame.
+   */
+  const OcclusionStats& getStats() const;
+
+private:
+  /**
+   * A range of the occluder mesh data, with the bounds of its vertices.
+   */
+  struct Occluder {
+    AABB bounds;
+    uint32_t firstIndex;
+    uint32_t indexCount;
+  };
+
+  /**
+   * A triangle ready for rasterization. Its three edge functions and its depth are planes over the depth buffer,
+   * each given as a * x + b * y + c for the pixel center (x, y). The edge functions are offset so that they are only
+   * non-negative where the whole pixel is inside the edge, and the depth so that it is the farthest within the pixel.
+   */
+  struct Triangle {
+    float edges[3][3];
+    float depth[3];
+    int minX, minY, maxX, maxY;
+  };
+
+  /**
+   * One level of the depth pyramid.
+   */
+  struct Level {
+    int width;
+    int height;
+    std::vector<float> depths;
+  };
+
+  /**
+   * @brief Sets up a triangle given in clip space, unless it faces away or covers no pixel.
+   */
+  void setupTriangle(const glm::vec4* positions);
+
+  /**
+   * @brief Clears a band of rows and rasterizes the triangles overlapping it.
+   */
+  void rasterizeBand(int minY, int maxY);
+
+  /**
+   * @brief Reduces each level of the pyramid into the next one.
+   */
+  void buildPyramid();
+
+  /**
+   * Pointer to the job system the rasterization and tests run on.
+   */
+  JobSystem* jobSystem;
+
+  /**
+   * Size of the depth buffer in pixels.
+   */
+  int width;
+  int height;
+
+  /**
+   * Vertices and indices of every occluder, and the range each one uses.
+   */
+  std::vector<glm::vec3> occluderVertices;
+  std::vector<uint32_t> occluderIndices;
+  std::vector<Occluder> occluders;
+
+  /**
+   * Projection matrix times view matrix of the last render().
+   */
+  glm::mat4 viewProjection;
+
+  /**
+   * Triangles of the occluders in the last render().
+   */
+  std::vector<Triangle> triangles;
+
+  /**
+   * The depth pyramid, starting with the full resolution depth buffer.
+   */
+  std::vector<Level> levels;
+
+  /**
+   * Visibility of each tested object during cull(), kept to reuse its memory.
+   */
+  std::vector<uint8_t> visibility;
+
+  /**
+   * Counters of the last frame.
+   */
+  OcclusionStats stats;
+};
+
+#endif
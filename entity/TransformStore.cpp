@@ -0,0 +1,363 @@
+/**
+ * @file TransformStore.cpp
+ * @brief Implements the TransformStore class, which keeps entity transforms in SoA arrays and updates their matrices
+ * in SIMD batches.
+ */
+
+#include "TransformStore.h"
+#include <cstring>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+  /**
+   * Vector operations of the widest instruction set available, so that the world matrix kernel is written once.
+   * Each vector holds one transform component of `width` consecutive entities.
+   */
+#if defined(__AVX__)
+  struct Simd {
+    typedef __m256 Vector;
+    static const size_t width = 8;
+    static Vector load(const float* values) { return _mm256_loadu_ps(values); }
+    static Vector set(float value) { return _mm256_set1_ps(value); }
+    static Vector add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+    static Vector sub(Vector a, Vector b) { return _mm256_sub_ps(a, b); }
+    static Vector mul(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+
+    // Transpose the four rows within each 128-bit half, which leaves entity i's column in the low half of row i % 4
+    // for i < 4 and in the high half for the rest
+    static void storeColumn(Vector x, Vector y, Vector z, Vector w, glm::mat4* matrices, int column) {
+      __m256 xy0 = _mm256_unpacklo_ps(x, y);
+      __m256 xy1 = _mm256_unpackhi_ps(x, y);
+      __m256 zw0 = _mm256_unpacklo_ps(z, w);
+      __m256 zw1 = _mm256_unpackhi_ps(z, w);
+      __m256 rows[4] = {
+        _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(1, 0, 1, 0)),
+        _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(3, 2, 3, 2)),
+        _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(1, 0, 1, 0)),
+        _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(3, 2, 3, 2))
+      };
+      for (int i = 0; i < 4; ++i) {
+        _mm_storeu_ps(&matrices[i][column][0], _mm256_castps256_ps128(rows[i]));
+        _mm_storeu_ps(&matrices[i + 4][column][0], _mm256_extractf128_ps(rows[i], 1));
+      }
+    }
+  };
+#elif defined(__SSE2__) || defined(_M_X64)
+  struct Simd {
+    typedef __m128 Vector;
+    static const size_t width = 4;
+    static Vector load(const float* values) { return _mm_loadu_ps(values); }
+    static Vector set(float value) { return _mm_set1_ps(value); }
+    static Vector add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+    static Vector sub(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+    static Vector mul(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+
+    static void storeColumn(Vector x, Vector y, Vector z, Vector w, glm::mat4* matrices, int column) {
+      _MM_TRANSPOSE4_PS(x, y, z, w);
+      _mm_storeu_ps(&matrices[0][column][0], x);
+      _mm_storeu_ps(&matrices[1][column][0], y);
+      _mm_storeu_ps(&matrices[2][column][0], z);
+      _mm_storeu_ps(&matrices[3][column][0], w);
+    }
+  };
+#elif defined(__ARM_NEON)
+  struct Simd {
+    typedef float32x4_t Vector;
+    static const size_t width = 4;
+    static Vector load(const float* values) { return vld1q_f32(values); }
+    static Vector set(float value) { return vdupq_n_f32(value); }
+    static Vector add(Vector a, Vector b) { return vaddq_f32(a, b); }
+    static Vector sub(Vector a, Vector b) { return vsubq_f32(a, b); }
+    static Vector mul(Vector a, Vector b) { return vmulq_f32(a, b); }
+
+    // An interleaving store writes the four entities' columns back to back; each is then copied into its matrix
+    static void storeColumn(Vector x, Vector y, Vector z, Vector w, glm::mat4* matrices, int column) {
+      float interleaved[16];
+      float32x4x4_t columns = { { x, y, z, w } };
+      vst4q_f32(interleaved, columns);
+      for (int i = 0; i < 4; ++i) {
+        std::memcpy(&matrices[i][column][0], interleaved + 4 * i, sizeof(glm::vec4));
+      }
+    }
+  };
+#else
+  struct Simd {
+    typedef float Vector;
+    static const size_t width = 1;
+    static Vector load(const float* values) { return *values; }
+    static Vector set(float value) { return value; }
+    static Vector add(Vector a, Vector b) { return a + b; }
+    static Vector sub(Vector a, Vector b) { return a - b; }
+    static Vector mul(Vector a, Vector b) { return a * b; }
+
+    static void storeColumn(Vector x, Vector y, Vector z, Vector w, glm::mat4* matrices, int column) {
+      matrices[0][column] = glm::vec4(x, y, z, w);
+    }
+  };
+#endif
+
+  /**
+   * Pointers to the components of the first entity of a block.
+   */
+  struct Components {
+    const float* positionX;
+    const float* positionY;
+    const float* positionZ;
+    const float* rotationX;
+    const float* rotationY;
+    const float* rotationZ;
+    const float* rotationW;
+    const float* scaleX;
+    const float* scaleY;
+    const float* scaleZ;
+  };
+
+  /**
+   * @brief Computes translation * rotation * scale for Simd::width entities at once.
+   */
+  void composeWorldMatrices(const Components& in, size_t offset, glm::mat4* out) {
+    typedef Simd::Vector V;
+    V qx = Simd::load(in.rotationX + offset);
+    V qy = Simd::load(in.rotationY + offset);
+    V qz = Simd::load(in.rotationZ + offset);
+    V qw = Simd::load(in.rotationW + offset);
+
+    // The rotation matrix of a unit quaternion, as glm::mat4_cast builds it
+    V two = Simd::set(2.0f);
+    V one = Simd::set(1.0f);
+    V xx = Simd::mul(qx, qx), yy = Simd::mul(qy, qy), zz = Simd::mul(qz, qz);
+    V xy = Simd::mul(qx, qy), xz = Simd::mul(qx, qz), yz = Simd::mul(qy, qz);
+    V wx = Simd::mul(qw, qx), wy = Simd::mul(qw, qy), wz = Simd::mul(qw, qz);
+
+    V sx = Simd::load(in.scaleX + offset);
+    V sy = Simd::load(in.scaleY + offset);
+    V sz = Simd::load(in.scaleZ + offset);
+    V zero = Simd::set(0.0f);
+
+    Simd::storeColumn(
+      Simd::mul(Simd::sub(one, Simd::mul(two, Simd::add(yy, zz))), sx),
+      Simd::mul(Simd::mul(two, Simd::add(xy, wz)), sx),
+      Simd::mul(Simd::mul(two, Simd::sub(xz, wy)), sx),
+      zero, out, 0);
+    Simd::storeColumn(
+      Simd::mul(Simd::mul(two, Simd::sub(xy, wz)), sy),
+      Simd::mul(Simd::sub(one, Simd::mul(two, Simd::add(xx, zz))), sy),
+      Simd::mul(Simd::mul(two, Simd::add(yz, wx)), sy),
+      zero, out, 1);
+    Simd::storeColumn(
+      Simd::mul(Simd::mul(two, Simd::add(xz, wy)), sz),
+      Simd::mul(Simd::mul(two, Simd::sub(yz, wx)), sz),
+      Simd::mul(Simd::sub(one, Simd::mul(two, Simd::add(xx, yy))), sz),
+      zero, out, 2);
+    Simd::storeColumn(
+      Simd::load(in.positionX + offset),
+      Simd::load(in.positionY + offset),
+      Simd::load(in.positionZ + offset),
+      one, out, 3);
+  }
+
+  /**
+   * @brief Computes left * right[i] for count matrices.
+   *
+   * Each result column is a combination of the columns of left weighted by a column of right, so left's columns are
+   * loaded once and every product is a handful of broadcasts and multiply-adds.
+   */
+  void multiplyMatrices(const glm::mat4& left, const glm::mat4* right, glm::mat4* out, size_t count) {
+#if defined(__AVX__)
+    // Two result columns per iteration, one in each 128-bit half
+    __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&left[0][0]));
+    __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&left[1][0]));
+    __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&left[2][0]));
+    __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&left[3][0]));
+    for (size_t i = 0; i < count; ++i) {
+      const float* in = &right[i][0][0];
+      float* result = &out[i][0][0];
+      for (int column = 0; column < 4; column += 2) {
+        __m256 weights = _mm256_loadu_ps(in + 4 * column);
+        __m256 sum = _mm256_add_ps(
+          _mm256_add_ps(_mm256_mul_ps(c0, _mm256_shuffle_ps(weights, weights, 0x00)),
+                        _mm256_mul_ps(c1, _mm256_shuffle_ps(weights, weights, 0x55))),
+          _mm256_add_ps(_mm256_mul_ps(c2, _mm256_shuffle_ps(weights, weights, 0xaa)),
+                        _mm256_mul_ps(c3, _mm256_shuffle_ps(weights, weights, 0xff))));
+        _mm256_storeu_ps(result + 4 * column, sum);
+      }
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128 c0 = _mm_loadu_ps(&left[0][0]);
+    __m128 c1 = _mm_loadu_ps(&left[1][0]);
+    __m128 c2 = _mm_loadu_ps(&left[2][0]);
+    __m128 c3 = _mm_loadu_ps(&left[3][0]);
+    for (size_t i = 0; i < count; ++i) {
+      for (int column = 0; column < 4; ++column) {
+        const float* weights = &right[i][column][0];
+        __m128 sum = _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(weights[0])), _mm_mul_ps(c1, _mm_set1_ps(weights[1]))),
+          _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(weights[2])), _mm_mul_ps(c3, _mm_set1_ps(weights[3]))));
+        _mm_storeu_ps(&out[i][column][0], sum);
+      }
+    }
+#elif defined(__ARM_NEON)
+    float32x4_t c0 = vld1q_f32(&left[0][0]);
+    float32x4_t c1 = vld1q_f32(&left[1][0]);
+    float32x4_t c2 = vld1q_f32(&left[2][0]);
+    float32x4_t c3 = vld1q_f32(&left[3][0]);
+    for (size_t i = 0; i < count; ++i) {
+      for (int column = 0; column < 4; ++column) {
+        const float* weights = &right[i][column][0];
+        float32x4_t sum = vmulq_n_f32(c0, weights[0]);
+        sum = vmlaq_n_f32(sum, c1, weights[1]);
+        sum = vmlaq_n_f32(sum, c2, weights[2]);
+        sum = vmlaq_n_f32(sum, c3, weights[3]);
+        vst1q_f32(&out[i][column][0], sum);
+      }
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+      out[i] = left * right[i];
+    }
+#endif
+  }
+}
+
+TransformStore::TransformStore()
+  : entityCount(0),
+    lastViewProjection(0.0f) {}
+
+Entity TransformStore::create(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+  Entity entity = static_cast<Entity>(entityCount++);
+
+  // Grow by whole blocks, padding with identity transforms, so the kernels never need a scalar tail
+  if (entity % blockSize == 0) {
+    for (std::vector<float>* component : { &positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ }) {
+      component -> resize(component -> size() + blockSize, 0.0f);
+    }
+    for (std::vector<float>* component : { &rotationW, &scaleX, &scaleY, &scaleZ }) {
+      component -> resize(component -> size() + blockSize, 1.0f);
+    }
+    worldMatrices.resize(worldMatrices.size() + blockSize, glm::mat4(1.0f));
+    mvpMatrices.resize(mvpMatrices.size() + blockSize, glm::mat4(1.0f));
+    worldDirty.push_back(0);
+    mvpDirty.push_back(0);
+  }
+
+  positionX[entity] = position.x;
+  positionY[entity] = position.y;
+  positionZ[entity] = position.z;
+  rotationX[entity] = rotation.x;
+  rotationY[entity] = rotation.y;
+  rotationZ[entity] = rotation.z;
+  rotationW[entity] = rotation.w;
+  scaleX[entity] = scale.x;
+  scaleY[entity] = scale.y;
+  scaleZ[entity] = scale.z;
+  markDirty(entity);
+  return entity;
+}
+
+size_t TransformStore::size() const {
+  return entityCount;
+}
+
+void TransformStore::setPosition(Entity entity, const glm::vec3& position) {
+  positionX[entity] = position.x;
+  positionY[entity] = position.y;
+  positionZ[entity] = position.z;
+  markDirty(entity);
+}
+
+void TransformStore::setRotation(Entity entity, const glm::quat& rotation) {
+  rotationX[entity] = rotation.x;
+  rotationY[entity] = rotation.y;
+  rotationZ[entity] = rotation.z;
+  rotationW[entity] = rotation.w;
+  markDirty(entity);
+}
+
+void TransformStore::setScale(Entity entity, const glm::vec3& scale) {
+  scaleX[entity] = scale.x;
+  scaleY[entity] = scale.y;
+  scaleZ[entity] = scale.z;
+  markDirty(entity);
+}
+
+glm::vec3 TransformStore::getPosition(Entity entity) const {
+  return glm::vec3(positionX[entity], positionY[entity], positionZ[entity]);
+}
+
+void TransformStore::markDirty(Entity entity) {
+  uint32_t block = entity / blockSize;
+  if (!worldDirty[block]) {
+    worldDirty[block] = 1;
+    dirtyBlocks.push_back(block);
+  }
+}
+
+void TransformStore::updateWorldMatrices() {
+  Components components = {
+    positionX.data(), positionY.data(), positionZ.data(),
+    rotationX.data(), rotationY.data(), rotationZ.data(), rotationW.data(),
+    scaleX.data(), scaleY.data(), scaleZ.data()
+  };
+
+  for (uint32_t block : dirtyBlocks) {
+    size_t first = block * blockSize;
+    for (size_t offset = first; offset < first + blockSize; offset += Simd::width) {
+      composeWorldMatrices(components, offset, &worldMatrices[offset]);
+    }
+    worldDirty[block] = 0;
+
+    // The block's MVP matrices are now stale too
+    if (!mvpDirty[block]) {
+      mvpDirty[block] = 1;
+      mvpDirtyBlocks.push_back(block);
+    }
+  }
+
+  stats.worldMatricesUpdated = dirtyBlocks.size() * blockSize;
+  dirtyBlocks.clear();
+}
+
+void TransformStore::updateMvpMatrices(const glm::mat4& viewProjection) {
+  updateWorldMatrices();
+
+  if (viewProjection != lastViewProjection) {
+    multiplyMatrices(viewProjection, worldMatrices.data(), mvpMatrices.data(), mvpMatrices.size());
+    stats.mvpMatricesUpdated = mvpMatrices.size();
+    lastViewProjection = viewProjection;
+  } else {
+    for (uint32_t block : mvpDirtyBlocks) {
+      size_t first = block * blockSize;
+      multiplyMatrices(viewProjection, &worldMatrices[first], &mvpMatrices[first], blockSize);
+    }
+    stats.mvpMatricesUpdated = mvpDirtyBlocks.size() * blockSize;
+  }
+
+  for (uint32_t block : mvpDirtyBlocks) {
+    mvpDirty[block] = 0;
+  }
+  mvpDirtyBlocks.clear();
+}
+
+const glm::mat4& TransformStore::getWorldMatrix(Entity entity) const {
+  return worldMatrices[entity];
+}
+
+const glm::mat4* TransformStore::getWorldMatrices() const {
+  return worldMatrices.data();
+}
+
+const glm::mat4* TransformStore::getMvpMatrices() const {
+  return mvpMatrices.data();
+}
+
+const TransformStats& TransformStore::getStats() const {
+  return stats;
+}
@@ -0,0 +1,179 @@
+/**
+ * @file TransformStore.h
+ * @brief Declares the TransformStore class, which keeps entity transforms in SoA arrays and updates their matrices in
+ * SIMD batches.
+ */
+
+#ifndef TRANSFORM_STORE_H
+#define TRANSFORM_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+/**
+ * Handle of an entity; the index of its transform in the store.
+ */
+typedef uint32_t Entity;
+
+/**
+ * @struct TransformStats
+ * @brief Counters from the last matrix updates of a TransformStore.
+ */
+struct TransformStats {
+  /**
+   * Number of entities whose world matrix was recomputed by the last updateWorldMatrices().
+   */
+  size_t worldMatricesUpdated = 0;
+
+  /**
+   * Number of entities whose model-view-projection matrix was recomputed by the last updateMvpMatrices().
+   */
+  size_t mvpMatricesUpdated = 0;
+};
+
+/**
+ * @class TransformStore
+ * @brief Stores the position, rotation and scale of every entity, and caches their world and MVP matrices.
+ *
+ * Each transform component lives in an array of its own (structure of arrays), so that the matrix kernels load the
+ * same component of several entities with one vector load and compose their matrices side by side, one entity per
+ * SIMD lane. Entities are grouped in blocks of blockSize; changing a transform marks its block dirty, and the updates
+ * only recompute dirty blocks. MVP matrices are recomputed for dirty blocks only as long as the view-projection matrix
+ * stays the same, and for every entity when it changes.
+ */
+class TransformStore {
+public:
+  /**
+   * Number of entities per dirty-tracking block; a multiple of every SIMD width used.
+   */
+  static const size_t blockSize = 8;
+
+  /**
+   * @brief Constructs an empty store.
+   */
+  TransformStore();
+
+  /**
+   * @brief Adds an entity.
+   * @return Handle of the new entity.
+   */
+  Entity create(const glm::vec3& position, const glm::quat& rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+    const glm::vec3& scale = glm::vec3(1.0f));
+
+  /**
+   * @brief Get the number of entities.
+   */
+  size_t size() const;
+
+  /**
+   * @brief Moves an entity.
+   */
+  void setPosition(Entity entity, const glm::vec3& position);
+
+  /**
+   * @brief Rotates an entity.
+   * @param rotation Unit quaternion.
+   */
+  void setRotation(Entity entity, const glm::quat& rotation);
+
+  /**
+   * @brief Scales an entity.
+   */
+  void setScale(Entity entity, const glm::vec3& scale);
+
+  /**
+   * @brief Get the position of an entity.
+   */
+  glm::vec3 getPosition(Entity entity) const;
+
+  /**
+   * @brief Recomputes the world matrices of the entities changed since the last call.
+   */
+  void updateWorldMatrices();
+
+  /**
+   * @brief Recomputes the model-view-projection matrices that are out of date, after updating the world matrices.
+   * @param viewProjection Projection matrix times view matrix of the camera.
+   */
+  void updateMvpMatrices(const glm::mat4& viewProjection);
+
+  /**
+   * @brief Get the world matrix of an entity, as of the last updateWorldMatrices().
+   */
+  const glm::mat4& getWorldMatrix(Entity entity) const;
+
+  /**
+   * @brief Get the world matrices of all entities, indexed by entity.
+   */
+  const glm::mat4* getWorldMatrices() const;
+
+  /**
+   * @brief Get the model-view-projection matrices of all entities, indexed by entity, as of the last
+   * updateMvpMatrices().
+   */
+  const glm::mat4* getMvpMatrices() const;
+
+  /**
+   * @brief Get the counters from the last updates.
+   */
+  const TransformStats& getStats() const;
+
+private:
+  /**
+   * @brief Marks the block of an entity dirty.
+   */
+  void markDirty(Entity entity);
+
+  /**
+   * Transform components, padded with identity transforms to a whole number of blocks.
+   */
+  std::vector<float> positionX, positionY, positionZ;
+  std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+  std::vector<float> scaleX, scaleY, scaleZ;
+
+  /**
+   * Cached matrices, padded like the components.
+   */
+  std::vector<glm::mat4> worldMatrices;
+  std::vector<glm::mat4> mvpMatrices;
+
+  /**
+   * Number of entities.
+   */
+  size_t entityCount;
+
+  /**
+   * Whether each block's world matrices are out of date.
+   */
+  std::vector<uint8_t> worldDirty;
+
+  /**
+   * Whether each block's MVP matrices are out of date regardless of the camera.
+   */
+  std::vector<uint8_t> mvpDirty;
+
+  /**
+   * Blocks whose world matrices are out of date, each listed once.
+   */
+  std::vector<uint32_t> dirtyBlocks;
+
+  /**
+   * Blocks whose MVP matrices are out of date, each listed once.
+   */
+  std::vector<uint32_t> mvpDirtyBlocks;
+
+  /**
+   * View-projection matrix the MVP matrices were last computed with.
+   */
+  glm::mat4 lastViewProjection;
+
+  /**
+   * Counters from the last updates.
+   */
+  TransformStats stats;
+};
+
+#endif
@@ -7,12 +7,220 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <iostream>
-#include <thread>
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <thread>
+#include <utility>
 #include "../mesh/Mesh.h"
+#include "../gl/GLApi.h"
+#include "../gl/NullGL.h"
+#include "../gl/GLState.h"
+
+namespace {
+  /**
+   * Distance between the centers of neighbouring cubes in the lattice.
+   */
+  const float cubeSpacing = 3.0f;
+
+  /**
+   * Time in seconds each frame may spend uploading chunk meshes, so that large world changes are spread over several
+   * frames instead of causing a hitch.
+   */
+  const double chunkUploadBudget = 0.002;
+
+  /**
+   * Time in seconds each frame may spend uploading loaded assets.
+   */
+  const double assetUploadBudget = 0.002;
+
+  /**
+   * Number of agents steered by each job; a few microseconds of work, so that scheduling costs stay negligible.
+   */
+  const size_t agentGrainSize = 256;
+
+  /**
+   * Number of directions each agent probes when choosing where to steer, which sets the cost of an agent update.
+   */
+  const int agentProbeCount = 16;
+
+  /**
+   * Number of visible cube transforms gathered into the instance stream by each job.
+   */
+  const size_t instanceGrainSize = 4096;
+
+  /**
+   * Speed the spinning cubes turn at, in radians per second.
+   */
+  const float spinSpeed = 1.5f;
+
+  /**
+   * Distance between the centers of neighbouring city blocks, and half the width of the building on each.
+   */
+  const float buildingPitch = 4.5f;
+  const float buildingHalfWidth = 1.5f;
+
+  /**
+   * Heights the buildings vary between, standing on the ground below the benchmark camera.
+   */
+  const float buildingMinHeight = 4.0f;
+  const float buildingMaxHeight = 10.0f;
+  const float groundHeight = -2.0f;
+
+  /**
+   * Distances from the origin kept free of buildings: a ring road around the orbit the benchmark camera follows.
+   */
+  const float roadInnerRadius = 7.0f;
+  const float roadOuterRadius = 13.0f;
+
+  /**
+   * Corners of each face of a box, counter-clockwise seen from outside. Bits 0, 1 and 2 of a corner select the
+   * maximum x, y and z of the box.
+   */
+  const uint32_t boxFaces[6][4] = {
+    { 0, 4, 6, 2 }, { 1, 3, 7, 5 }, { 0, 1, 5, 4 }, { 2, 6, 7, 3 }, { 0, 2, 3, 1 }, { 4, 5, 7, 6 }
+  };
+
+  /**
+   * Size of the sprite tiles in pixels, as on the Game Boy.
+   */
+  const int tileSize = 8;
+
+  /**
+   * Number of different tiles generated for the sprite layer.
+   */
+  const int tileCount = 16;
+
+  /**
+   * Number of steps in each sprite's circular animation.
+   */
+  const int spriteAnimationSteps = 64;
+
+  /**
+   * The four shades of the Game Boy screen, lightest first, as RGB bytes.
+   */
+  const uint8_t tilePalette[4][3] = {
+    { 0x9b, 0xbc, 0x0f },
+    { 0x8b, 0xac, 0x0f },
+    { 0x30, 0x62, 0x30 },
+    { 0x0f, 0x38, 0x0f }
+  };
+
+  /**
+   * @brief Returns the bounds of the given number of buildings, on the city blocks nearest the origin outside the road.
+   */
+  std::vector<AABB> layOutBuildings(int count) {
+    // Enough blocks in every direction that the count is met beyond the road
+    int reach = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(count)) + roadOuterRadius / buildingPitch));
+    std::vector<std::pair<int, int>> blocks;
+    for (int z = -reach; z <= reach; ++z) {
+      for (int x = -reach; x <= reach; ++x) {
+        float distance = std::sqrt(static_cast<float>(x * x + z * z)) * buildingPitch;
+        if (distance < roadInnerRadius || distance > roadOuterRadius) {
+          blocks.push_back({ x, z });
+        }
+      }
+    }
+    std::stable_sort(blocks.begin(), blocks.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+      return a.first * a.first + a.second * a.second < b.first * b.first + b.second * b.second;
+    });
+
+    std::vector<AABB> buildings;
+    for (int i = 0; i < count && i < static_cast<int>(blocks.size()); ++i) {
+      glm::vec2 center(blocks[i].first * buildingPitch, blocks[i].second * buildingPitch);
+      float height = buildingMinHeight + (buildingMaxHeight - buildingMinHeight) * ((i * 7919) % 13) / 12.0f;
+      buildings.push_back({
+        glm::vec3(center.x - buildingHalfWidth, groundHeight, center.y - buildingHalfWidth),
+        glm::vec3(center.x + buildingHalfWidth, groundHeight + height, center.y + buildingHalfWidth)
+      });
+    }
+    return buildings;
+  }
 
-Game::Game(int width, int height, std::string title)
-  : width(width),
+  /**
+   * @brief Adds a box to an occlusion culler, as the closed mesh of its faces.
+   */
+  void addBoxOccluder(OcclusionCuller& culler, const AABB& box) {
+    glm::vec3 corners[8];
+    for (int corner = 0; corner < 8; ++corner) {
+      corners[corner] = glm::vec3((corner & 1) ? box.max.x : box.min.x, (corner & 2) ? box.max.y : box.min.y,
+                                  (corner & 4) ? box.max.z : box.min.z);
+    }
+
+    uint32_t indices[36];
+    for (int face = 0; face < 6; ++face) {
+      const uint32_t* quad = boxFaces[face];
+      uint32_t* triangles = indices + face * 6;
+      triangles[0] = quad[0]; triangles[1] = quad[1]; triangles[2] = quad[2];
+      triangles[3] = quad[0]; triangles[4] = quad[2]; triangles[5] = quad[3];
+    }
+    culler.addOccluder(corners, 8, indices, 36);
+  }
+
+  /**
+   * @brief Generates the RGBA pixels of a patterned tile in the Game Boy palette.
+   *
+   * Odd tiles leave their lightest shade transparent, so that they show what is behind them like object sprites do.
+   */
+  void makeTile(int tile, uint8_t* pixels) {
+    for (int y = 0; y < tileSize; ++y) {
+      for (int x = 0; x < tileSize; ++x) {
+        int shade;
+        switch (tile % 4) {
+          case 0: shade = ((x ^ y) & (tile / 4 + 1)) ? 3 : 1; break;
+          case 1: shade = (x + y + tile) % 4; break;
+          case 2: shade = (x == 0 || y == 0 || x == tileSize - 1 || y == tileSize - 1) ? 3 : (tile / 4) % 3; break;
+          default: shade = ((x - 4) * (x - 3) + (y - 4) * (y - 3)) < 6 + tile ? 2 : 0; break;
+        }
+
+        uint8_t* pixel = pixels + (y * tileSize + x) * 4;
+        pixel[0] = tilePalette[shade][0];
+        pixel[1] = tilePalette[shade][1];
+        pixel[2] = tilePalette[shade][2];
+        pixel[3] = (tile % 2 == 1 && shade == 0) ? 0 : 255;
+      }
+    }
+  }
+}
+
+Game::Game(int width, int height, std::string title, const GameOptions& options)
+  : window(nullptr),
+    input(nullptr),
+    latencyTracker(nullptr),
+    shaderProgram(nullptr),
+    shaderCache(nullptr),
+    shaderWatcher(nullptr),
+    renderer(nullptr),
+    softwareRenderer(nullptr),
+    camera(nullptr),
+    renderCamera(nullptr),
+    renderThread(nullptr),
+    assetsFailed(false),
+    cube(nullptr),
+    jobSystem(nullptr),
+    threadPool(nullptr),
+    assetManager(nullptr),
+    shadersReady(false),
+    cubeTransforms(nullptr),
+    spinningCount(0),
+    spinAngle(0),
+    previousSpinAngle(0),
+    cubeGrid(nullptr),
+    occlusionCuller(nullptr),
+    world(nullptr),
+    spriteProgram(nullptr),
+    tileAtlas(nullptr),
+    spriteBatch(nullptr),
+    agentUpdateTime(0),
+    agentUpdateCount(0),
+    benchmark(nullptr),
+    inputLog(nullptr),
+    profiler(nullptr),
+    gpuTimer(nullptr),
+    pacer(nullptr),
+    timestep(nullptr),
+    options(options),
+    width(width),
     height(height),
     title(title),
     targetFps(61.0),
@@ -23,183 +231,559 @@ Game::Game(int width, int height, std::string title)
 
 bool Game::initialize() {
   // Create the window
-  window = new Window(width, height, title);
+  window = new Window(width, height, title, options.windowMode);
   if (!window -> init()) {
     return false;
   }
+  GLState::setValidation(options.validateGLState);
+
+  // Set up shaders, loading them from the program binary cache when possible
+  if (!options.shaderCacheDirectory.empty()) {
+    shaderCache = new ShaderCache(options.shaderCacheDirectory);
+  }
+
+  // Short jobs within the frame run on every core, with the main thread helping whenever it waits for them
+  jobSystem = new JobSystem(options.threadCount);
+
+  // Files are read and decoded in the background, so the frame loop starts right away and shows the scene once its
+  // assets have arrived
+  threadPool = new ThreadPool(2);
+  assetManager = new AssetManager(threadPool, options.persistentStreaming);
 
-  // Set up shaders
   shaderProgram = new ShaderProgram("shader/vertex_shader.glsl", "shader/fragment_shader.glsl");
-  if (!shaderProgram -> init()) {
-    return false;
+  shaderProgram -> setCache(shaderCache);
+  vertexShaderSource = assetManager -> loadText("shader/vertex_shader.glsl");
+  fragmentShaderSource = assetManager -> loadText("shader/fragment_shader.glsl");
+
+  // Rebuild the shaders whenever their sources are saved
+  shaderWatcher = new ShaderWatcher({
+    "shader/vertex_shader.glsl", "shader/fragment_shader.glsl", "shader/sprite_vertex.glsl", "shader/sprite_fragment.glsl"
+  });
+  if (!shaderWatcher -> init()) {
+    delete shaderWatcher;
+    shaderWatcher = nullptr;
   }
 
   camera = new Camera(45.0f, (float) window -> getWidth() / (float) window -> getHeight(), 0.1f, 100.0f);
 
-  renderer = new Renderer(camera, shaderProgram);
+  // The renderer draws with its own copy of the camera, updated with every recorded frame
+  renderCamera = new Camera(*camera);
+  renderer = new Renderer(renderCamera, shaderProgram, options.persistentStreaming);
+  renderer -> setSorting(options.sortDraws);
+
+  // The cubes can be rasterized on the CPU instead, into a framebuffer of their own that is scaled up to the window
+  if (options.softwareWidth > 0) {
+    softwareRenderer = new SoftwareRenderer(renderCamera, jobSystem, options.softwareWidth, options.softwareHeight);
+  }
+
+  profiler = new Profiler();
+  gpuTimer = new GpuTimer(profiler);
+  renderer -> setGpuTimer(gpuTimer);
 
   // Accept only the fragments closest to the screen when overlapping
-  glEnable(GL_DEPTH_TEST);
-  glDepthFunc(GL_LESS);
+  GLState::setEnabled(GL_DEPTH_TEST, true);
+  GLState::depthFunc(GL_LESS);
 
   // Cull triangles which normal is not towards the camera
-  glEnable(GL_CULL_FACE);
-
-  // Hide cursor
-  glfwSetInputMode(window->getWindow(), GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
-
-  // Cube vertices to be rendered to screen
-  const GLfloat vertices[] = {
-    -1.0f,-1.0f,-1.0f,
-    -1.0f,-1.0f, 1.0f,
-    -1.0f, 1.0f, 1.0f,
-    1.0f, 1.0f,-1.0f,
-    -1.0f,-1.0f,-1.0f,
-    -1.0f, 1.0f,-1.0f,
-    1.0f,-1.0f, 1.0f,
-    -1.0f,-1.0f,-1.0f,
-    1.0f,-1.0f,-1.0f,
-    1.0f, 1.0f,-1.0f,
-    1.0f,-1.0f,-1.0f,
-    -1.0f,-1.0f,-1.0f,
-    -1.0f,-1.0f,-1.0f,
-    -1.0f, 1.0f, 1.0f,
-    -1.0f, 1.0f,-1.0f,
-    1.0f,-1.0f, 1.0f,
-    -1.0f,-1.0f, 1.0f,
-    -1.0f,-1.0f,-1.0f,
-    -1.0f, 1.0f, 1.0f,
-    -1.0f,-1.0f, 1.0f,
-    1.0f,-1.0f, 1.0f,
-    1.0f, 1.0f, 1.0f,
-    1.0f,-1.0f,-1.0f,
-    1.0f, 1.0f,-1.0f,
-    1.0f,-1.0f,-1.0f,
-    1.0f, 1.0f, 1.0f,
-    1.0f,-1.0f, 1.0f,
-    1.0f, 1.0f, 1.0f,
-    1.0f, 1.0f,-1.0f,
-    -1.0f, 1.0f,-1.0f,
-    1.0f, 1.0f, 1.0f,
-    -1.0f, 1.0f,-1.0f,
-    -1.0f, 1.0f, 1.0f,
-    1.0f, 1.0f, 1.0f,
-    -1.0f, 1.0f, 1.0f,
-    1.0f,-1.0f, 1.0f
-  };
+  GLState::setEnabled(GL_CULL_FACE, true);
 
-  const GLfloat colors[] = {
-    0.583f,  0.771f,  0.014f,
-    0.609f,  0.115f,  0.436f,
-    0.327f,  0.483f,  0.844f,
-    0.822f,  0.569f,  0.201f,
-    0.435f,  0.602f,  0.223f,
-    0.310f,  0.747f,  0.185f,
-    0.597f,  0.770f,  0.761f,
-    0.559f,  0.436f,  0.730f,
-    0.359f,  0.583f,  0.152f,
-    0.483f,  0.596f,  0.789f,
-    0.559f,  0.861f,  0.639f,
-    0.195f,  0.548f,  0.859f,
-    0.014f,  0.184f,  0.576f,
-    0.771f,  0.328f,  0.970f,
-    0.406f,  0.615f,  0.116f,
-    0.676f,  0.977f,  0.133f,
-    0.971f,  0.572f,  0.833f,
-    0.140f,  0.616f,  0.489f,
-    0.997f,  0.513f,  0.064f,
-    0.945f,  0.719f,  0.592f,
-    0.543f,  0.021f,  0.978f,
-    0.279f,  0.317f,  0.505f,
-    0.167f,  0.620f,  0.077f,
-    0.347f,  0.857f,  0.137f,
-    0.055f,  0.953f,  0.042f,
-    0.714f,  0.505f,  0.345f,
-    0.783f,  0.290f,  0.734f,
-    0.722f,  0.645f,  0.174f,
-    0.302f,  0.455f,  0.848f,
-    0.225f,  0.587f,  0.040f,
-    0.517f,  0.713f,  0.338f,
-    0.053f,  0.959f,  0.120f,
-    0.393f,  0.621f,  0.362f,
-    0.673f,  0.211f,  0.457f,
-    0.820f,  0.883f,  0.371f,
-    0.982f,  0.099f,  0.879f
-  };
+  // Receive keyboard and mouse events through callbacks, with the cursor captured by the window
+  input = new Input(window);
+  if (!input -> init()) {
+    return false;
+  }
+  latencyTracker = new LatencyTracker(window);
+
+  // The cube model holds the corners with their colors, stored in the compact vertex format once loaded
+  cubeAsset = assetManager -> loadMesh("assets/models/cube.obj");
+
+  // Lay the cubes out in a lattice centered on the origin; a single cube sits exactly at the origin
+  int latticeSide = static_cast<int>(std::ceil(std::cbrt(static_cast<double>(options.cubeCount))));
+  float latticeOffset = (latticeSide - 1) * cubeSpacing / 2.0f;
+  cubeTransforms = new TransformStore();
+  for (int i = 0; i < options.cubeCount; ++i) {
+    glm::vec3 position(
+      (i % latticeSide) * cubeSpacing - latticeOffset,
+      (i / (latticeSide * latticeSide)) * cubeSpacing - latticeOffset,
+      ((i / latticeSide) % latticeSide) * cubeSpacing - latticeOffset
+    );
+    cubeTransforms -> create(position);
+  }
+  spinningCount = std::min(options.spinningCount, options.cubeCount);
+
+  // Index the cube bounds, so that culling can reject whole regions of the lattice at once. The grid is static, so
+  // spinning cubes get bounds that hold them at any angle
+  for (Entity entity = 0; entity < cubeTransforms -> size(); ++entity) {
+    glm::vec3 center = cubeTransforms -> getPosition(entity);
+    glm::vec3 halfExtent(static_cast<int>(entity) < spinningCount ? std::sqrt(3.0f) : 1.0f);
+    cubeBounds.push_back({ center - halfExtent, center + halfExtent });
+  }
+
+  // Buildings are drawn as cubes stretched to their bounds, after the lattice
+  std::vector<AABB> buildings = layOutBuildings(options.buildingCount);
+  for (const AABB& building : buildings) {
+    glm::vec3 halfExtent = (building.max - building.min) * 0.5f;
+    cubeTransforms -> create(building.min + halfExtent, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), halfExtent);
+    cubeBounds.push_back(building);
+  }
+  cubeGrid = new CullingGrid();
+  cubeGrid -> build(cubeBounds.data(), cubeBounds.size());
+
+  // Their large and simple boxes hide much of the scene, which makes them ideal occluders
+  if (options.occlusionCulling) {
+    occlusionCuller = new OcclusionCuller(jobSystem);
+    for (const AABB& building : buildings) {
+      addBoxOccluder(*occlusionCuller, building);
+    }
+  }
+
+  // Scatter the agents over the plane, heading in different directions
+  for (int i = 0; i < options.jobLoad; ++i) {
+    float angle = i * 2.39996f;
+    float radius = std::sqrt(static_cast<float>(i));
+    agents.push_back({ radius * glm::vec2(std::cos(angle), std::sin(angle)), glm::vec2(std::sin(angle), -std::cos(angle)) });
+  }
+
+  if (options.worldRadius >= 0) {
+    world = new World();
+    world -> generate(options.worldRadius);
+  }
+
+  if (options.spriteCount > 0 && !initializeSprites()) {
+    return false;
+  }
+
+  // A replay runs as a benchmark following the recorded input instead of the scripted path, for as many frames as
+  // were recorded
+  int benchmarkFrames = options.benchmarkFrames;
+  if (!options.inputReplay.empty()) {
+    inputLog = new InputLog();
+    if (!inputLog -> load(options.inputReplay)) {
+      return false;
+    }
+    if (inputLog -> getFrameCount() == 0) {
+      std::cerr << "Input log " << options.inputReplay << " holds no frames" << std::endl;
+      return false;
+    }
+    int recordedFrames = static_cast<int>(inputLog -> getFrameCount());
+    benchmarkFrames = benchmarkFrames > 0 ? std::min(benchmarkFrames, recordedFrames) : recordedFrames;
+  } else if (!options.inputRecording.empty()) {
+    inputLog = new InputLog();
+  }
+
+  if (benchmarkFrames > 0) {
+    benchmark = new FrameBenchmark(benchmarkFrames, options.dumpDirectory, options.dumpInterval);
+  }
+
+  // Never simulate more than a quarter second of backlog in one frame
+  timestep = new FixedTimestep(1.0 / options.tickRate, options.tickRate / 4 + 1);
+
+  pacer = new FramePacer(targetFrameTime);
+  pacer -> start();
+
+  // Benchmarks and replays measure the steady state from their first frame, so the assets the scene needs are loaded,
+  // compiled and uploaded here instead of during the measured frames, and every run starts drawing the same scene
+  if (benchmark) {
+    while (true) {
+      if (!updateAssets()) {
+        return false;
+      }
+      if (shadersReady && cube) {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
 
-  cube = new Mesh(vertices, colors, sizeof(vertices));
+  // Hand the OpenGL context over to the render thread last, once every GL object has been created
+  renderThread = new RenderThread(window, profiler, options.renderThread);
 
-  lastTime = glfwGetTime();
+  lastTime = window -> getTime();
 
   return true;
 }
 
+bool Game::initializeSprites() {
+  spriteProgram = new ShaderProgram("shader/sprite_vertex.glsl", "shader/sprite_fragment.glsl");
+  spriteProgram -> setCache(shaderCache);
+  spriteVertexShaderSource = assetManager -> loadText("shader/sprite_vertex.glsl");
+  spriteFragmentShaderSource = assetManager -> loadText("shader/sprite_fragment.glsl");
+
+  tileAtlas = new TextureAtlas(64, 64);
+  std::vector<uint8_t> pixels(tileSize * tileSize * 4);
+  for (int tile = 0; tile < tileCount; ++tile) {
+    makeTile(tile, pixels.data());
+    tiles.push_back(tileAtlas -> add(pixels.data(), tileSize, tileSize));
+  }
+  if (!tileAtlas -> build()) {
+    return false;
+  }
+
+  spriteBatch = new SpriteBatch(spriteProgram, options.persistentStreaming, options.spriteCount);
+  return true;
+}
+
+bool Game::updateAssets() {
+  assetManager -> update(assetUploadBudget);
+
+  // Build the programs once all shader sources are in
+  if (!shadersReady) {
+    if (vertexShaderSource.isFailed() || fragmentShaderSource.isFailed()
+        || spriteVertexShaderSource.isFailed() || spriteFragmentShaderSource.isFailed()) {
+      return false;
+    }
+
+    bool spriteSourcesReady = !spriteProgram || (spriteVertexShaderSource.isReady() && spriteFragmentShaderSource.isReady());
+    if (vertexShaderSource.isReady() && fragmentShaderSource.isReady() && spriteSourcesReady) {
+      if (!shaderProgram -> init(vertexShaderSource.get().text, fragmentShaderSource.get().text)) {
+        return false;
+      }
+      if (spriteProgram && !spriteProgram -> init(spriteVertexShaderSource.get().text, spriteFragmentShaderSource.get().text)) {
+        return false;
+      }
+      shadersReady = true;
+      reportShaderCache();
+    }
+  }
+
+  if (!cube) {
+    if (cubeAsset.isFailed()) {
+      return false;
+    }
+    if (cubeAsset.isReady()) {
+      cube = cubeAsset.get().mesh;
+    }
+  }
+  return true;
+}
+
+void Game::reportShaderCache() {
+  if (!shaderCache) {
+    return;
+  }
+
+  const ShaderCacheStats& stats = shaderCache -> getStats();
+  if (!shaderCache -> isEnabled()) {
+    std::cout << "Shader cache: unavailable, the driver does not support program binaries" << std::endl;
+    return;
+  }
+  std::cout << "Shader cache: " << stats.hits << " hit(s), " << stats.misses << " miss(es)";
+  if (stats.hits > 0) {
+    std::cout << ", loaded in " << stats.loadTime * 1000.0 << " ms, saved " << stats.timeSaved * 1000.0 << " ms";
+  }
+  std::cout << std::endl;
+}
+
 void Game::update(double startTime) {
+  // Benchmarks advance by a fixed step, or replays by the recorded ones, so that every run simulates exactly the same
+  // frames. They report their own timings and measure throughput, so they are never throttled either
+  if (benchmark) {
+    deltaTime = targetFrameTime;
+    return;
+  }
+
   deltaTime = startTime - lastTime;
   lastTime = startTime;
   secondsCounter += deltaTime;
   ++fpsCounter;
 
-  // Output FPS
+  // Output FPS, along with frame time percentiles that reveal spikes the average hides and the pacing accuracy
   if (secondsCounter >= 1) {
-    std::cout << "FPS: " << fpsCounter << std::endl;
+    // The rendering statistics belong to the render thread, so the line is finished there, with the next frame
+    int fps = fpsCounter;
+    double p50 = profiler -> getFrameTimePercentile(50);
+    double p99 = profiler -> getFrameTimePercentile(99);
+    PacingStats pacing = pacer -> getStats();
+    CullingStats culling = cubeGrid -> getStats();
+    OcclusionStats occlusion = occlusionCuller ? occlusionCuller -> getStats() : OcclusionStats();
+    renderThread -> getCommandList().record([this, fps, p50, p99, pacing, culling, occlusion]() {
+      std::cout << "FPS: " << fps
+                << " (p50 " << p50 * 1000.0 << " ms"
+                << ", p99 " << p99 * 1000.0 << " ms"
+                << ", pacing error avg " << pacing.meanError * 1000000.0 << " us"
+                << " p99 " << pacing.p99Error * 1000000.0 << " us"
+                << " max " << pacing.maxError * 1000000.0 << " us"
+                << ", missed " << pacing.missedDeadlines << ")"
+                << ", cubes visible " << culling.objectsVisible << "/" << cubeTransforms -> size()
+                << " (" << culling.objectsTested << " tested, " << occlusion.occludeesCulled << " occluded)"
+                << ", draws " << renderer -> getStats().draws
+                << ", program switches " << renderer -> getStats().programSwitches
+                << ", VAO binds " << renderer -> getStats().vertexArrayBinds
+                << ", GL state changes " << GLState::getStats().issued << " (" << GLState::getStats().skipped << " skipped)"
+                << ", instance stream resizes " << renderer -> getInstanceStream().getStats().resizes
+                << ", assets queued " << assetManager -> getStats().queueDepth
+                << " (upload " << assetManager -> getStats().uploadTimeLastUpdate * 1000.0 << " ms/frame)"
+                << ", input latency avg " << latencyTracker -> getStats().meanLatency * 1000.0 << " ms"
+                << " p99 " << latencyTracker -> getStats().p99Latency * 1000.0 << " ms"
+                << std::endl;
+    });
     fpsCounter = 0;
     secondsCounter = 0;
   }
 
-  // Calculate frame time and control FPS by sleeping if needed
-  double frameEndTime = glfwGetTime();
-  double frameTime = frameEndTime - startTime;
-  if (frameTime < targetFrameTime) {
-      std::this_thread::sleep_for(std::chrono::microseconds((int) ((targetFrameTime - frameTime) * 1000000)));
-  }
+  // Wait out the rest of the frame to hold the target FPS
+  ProfileScope scope(profiler, "sleep");
+  pacer -> waitForNextFrame();
 }
 
-void Game::handleInput() {
-  // Handle movement
-  if (glfwGetKey( window -> getWindow(), GLFW_KEY_W ) == GLFW_PRESS){
-    camera -> moveForward(deltaTime);
+void Game::simulate(double tickDuration) {
+  camera -> beginTick();
+
+  if (movementInput.forward) {
+    camera -> moveForward(tickDuration);
+  }
+
+  if (movementInput.backward) {
+    camera -> moveBackward(tickDuration);
+  }
+
+  if (movementInput.right) {
+    camera -> moveRight(tickDuration);
+  }
+
+  if (movementInput.left) {
+    camera -> moveLeft(tickDuration);
   }
 
-  if (glfwGetKey( window -> getWindow(), GLFW_KEY_S ) == GLFW_PRESS){
-    camera -> moveBackward(deltaTime);
+  if (spinningCount > 0) {
+    spinCubes(tickDuration);
   }
 
-  if (glfwGetKey( window -> getWindow(), GLFW_KEY_D ) == GLFW_PRESS){
-    camera -> moveRight(deltaTime);
+  if (!agents.empty()) {
+    updateAgents(tickDuration);
   }
+}
+
+void Game::spinCubes(double tickDuration) {
+  // Wrap both angles together, so that blending between them never goes the long way round
+  previousSpinAngle = spinAngle;
+  spinAngle += spinSpeed * static_cast<float>(tickDuration);
+  if (spinAngle >= 6.2831853f) {
+    spinAngle -= 6.2831853f;
+    previousSpinAngle -= 6.2831853f;
+  }
+}
+
+void Game::poseSpinningCubes(double alpha) {
+  float angle = previousSpinAngle + (spinAngle - previousSpinAngle) * static_cast<float>(alpha);
 
-  if (glfwGetKey( window -> getWindow(), GLFW_KEY_A ) == GLFW_PRESS){
-    camera -> moveLeft(deltaTime);
+  // Only these cubes are marked dirty, so the rest of the lattice keeps its cached world matrices
+  for (Entity entity = 0; static_cast<int>(entity) < spinningCount; ++entity) {
+    glm::vec3 axis = glm::normalize(glm::vec3(1.0f, 1.0f + (entity % 3), 1.0f + (entity % 5)));
+    cubeTransforms -> setRotation(entity, glm::angleAxis(angle + entity * 0.1f, axis));
   }
+}
+
+void Game::updateAgents(double tickDuration) {
+  ProfileScope scope(profiler, "agents");
+  double startTime = profiler -> now();
+
+  // Every agent only reads and writes its own state, so ranges of agents are independent jobs
+  float step = static_cast<float>(tickDuration);
+  jobSystem -> parallelFor(agents.size(), agentGrainSize, [this, step](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      Agent& agent = agents[i];
+
+      // Probe the directions around the agent and steer towards the one leading closest to the origin without
+      // turning too sharply, as a stand-in for real steering behaviour
+      glm::vec2 bestDirection = agent.velocity;
+      float bestScore = -1e30f;
+      for (int probe = 0; probe < agentProbeCount; ++probe) {
+        float angle = probe * (6.2831853f / agentProbeCount);
+        glm::vec2 direction(std::cos(angle), std::sin(angle));
+        glm::vec2 ahead = agent.position + direction;
+        float score = glm::dot(direction, agent.velocity) - 0.1f * glm::dot(ahead, ahead);
+        if (score > bestScore) {
+          bestScore = score;
+          bestDirection = direction;
+        }
+      }
+
+      agent.velocity = glm::normalize(agent.velocity + bestDirection * step);
+      agent.position += agent.velocity * step;
+    }
+  });
+
+  agentUpdateTime += profiler -> now() - startTime;
+  ++agentUpdateCount;
+}
+
+void Game::handleInput() {
+  // Record held movement keys for the simulation ticks of this frame
+  movementInput.forward = input -> isKeyDown(GLFW_KEY_W);
+  movementInput.backward = input -> isKeyDown(GLFW_KEY_S);
+  movementInput.right = input -> isKeyDown(GLFW_KEY_D);
+  movementInput.left = input -> isKeyDown(GLFW_KEY_A);
 
-  handleMouseMovement();
+  // Dump the profiler samples when F9 is pressed
+  if (input -> wasKeyPressed(GLFW_KEY_F9)) {
+    dumpProfile("profile");
+  }
 
   // End game if esc is pressed
-  if (glfwGetKey(window->getWindow(), GLFW_KEY_ESCAPE) == GLFW_PRESS) {
-    glfwSetWindowShouldClose(window->getWindow(), true);
+  if (input -> isKeyDown(GLFW_KEY_ESCAPE)) {
+    window -> close();
   }
+
+  // Note what the simulation takes from the player and the clock this frame, in case it is recorded
+  recordedInput = FrameInput();
+  recordedInput.deltaTime = deltaTime;
+  recordedInput.forward = movementInput.forward;
+  recordedInput.backward = movementInput.backward;
+  recordedInput.left = movementInput.left;
+  recordedInput.right = movementInput.right;
 }
 
 void Game::handleMouseMovement() {
-  double xPosition, yPosition;
-  glfwGetCursorPos(window -> getWindow(), &xPosition, &yPosition);
+  double deltaX, deltaY, eventTime;
+  if (input -> takeMouseMotion(deltaX, deltaY, eventTime)) {
+    camera -> updateOrientation(deltaX, deltaY);
+    renderThread -> getCommandList().record([this, eventTime]() { latencyTracker -> addInput(eventTime); });
 
-  int screenWidth, screenHeight;
-  glfwGetWindowSize(window -> getWindow(), &screenWidth, &screenHeight);
-  glfwSetCursorPos(window -> getWindow(), screenWidth / 2, screenHeight / 2);
+    recordedInput.mouseMoved = true;
+    recordedInput.mouseDeltaX = deltaX;
+    recordedInput.mouseDeltaY = deltaY;
+  }
+}
 
-  camera -> updateOrientation(deltaTime, xPosition, yPosition, screenWidth, screenHeight);
+void Game::replayInput() {
+  // The recorded frame time replaces the measured one, so the simulation advances by the same ticks as when recorded
+  const FrameInput& frame = inputLog -> getFrame(benchmark -> getFrameIndex());
+  deltaTime = frame.deltaTime;
+  movementInput.forward = frame.forward;
+  movementInput.backward = frame.backward;
+  movementInput.left = frame.left;
+  movementInput.right = frame.right;
+}
+
+void Game::replayMouseMovement() {
+  const FrameInput& frame = inputLog -> getFrame(benchmark -> getFrameIndex());
+  if (frame.mouseMoved) {
+    camera -> updateOrientation(frame.mouseDeltaX, frame.mouseDeltaY);
+  }
 }
 
 void Game::render() {
-  glm::mat4 modelMatrix = glm::mat4(1.0f);
+  // Skip everything outside the view before it reaches the render thread
+  Frustum frustum = camera -> getFrustum();
+  {
+    ProfileScope scope(profiler, "cull");
+    cubeGrid -> cull(frustum, visibleCubes);
+  }
+
+  // Then skip those hidden behind the buildings
+  if (occlusionCuller) {
+    ProfileScope scope(profiler, "occlusion");
+    occlusionCuller -> render(camera -> getProjectionMatrix() * camera -> getViewMatrix(), frustum);
+    occlusionCuller -> cull(cubeBounds.data(), visibleCubes);
+  }
+
+  {
+    ProfileScope scope(profiler, "transforms");
+    if (spinningCount > 0) {
+      poseSpinningCubes(timestep -> getAlpha());
+    }
+    cubeTransforms -> updateWorldMatrices();
+  }
+
+  // Gather the visible transforms into the command list, a range of them per job, since the render thread draws
+  // them while the simulation already moves on
+  CommandList& commands = renderThread -> getCommandList();
+  size_t visibleCount = visibleCubes.size();
+  glm::mat4* transforms = commands.allocate<glm::mat4>(visibleCount);
+  jobSystem -> parallelFor(visibleCount, instanceGrainSize, [this, transforms](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      transforms[i] = cubeTransforms -> getWorldMatrix(visibleCubes[i]);
+    }
+  });
+
+  Camera cameraSnapshot = *camera;
+  commands.record([this, cameraSnapshot, frustum, transforms, visibleCount]() {
+    *renderCamera = cameraSnapshot;
+    drawScene(frustum, transforms, visibleCount);
+  });
+}
+
+void Game::drawScene(const Frustum& frustum, const glm::mat4* transforms, size_t transformCount) {
+  ProfileScope scope(profiler, "drawScene");
+
+  // Nothing can be drawn before the shaders have loaded, so the first frames only clear the screen
+  if (!shadersReady) {
+    GL::Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    return;
+  }
+
+  renderer -> beginFrame();
+  renderer -> beginPass("scene");
 
   // Clear the screen, preparing it for new frame rendering
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  GL::Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-  // Render to the screen
-  renderer -> render(*cube, modelMatrix);
+  if (softwareRenderer) {
+    // Rasterize the cubes on the CPU and copy the result over the screen. Terrain is only drawn with OpenGL
+    softwareRenderer -> beginFrame();
+    if (cube && options.instanced) {
+      softwareRenderer -> renderInstanced(*cube, transforms, transformCount);
+    } else if (cube) {
+      for (size_t i = 0; i < transformCount; ++i) {
+        softwareRenderer -> render(*cube, transforms[i]);
+      }
+    }
+    softwareRenderer -> endFrame();
+    softwareRenderer -> present(window -> getWidth(), window -> getHeight());
+  } else {
+    if (world) {
+      world -> render(*renderer, frustum);
+    }
+
+    // Render to the screen, either with one draw call for all visible cubes or one draw call per cube, once the cube
+    // model has loaded
+    if (cube && options.instanced) {
+      renderer -> renderInstanced(*cube, transforms, transformCount);
+    } else if (cube) {
+      for (size_t i = 0; i < transformCount; ++i) {
+        renderer -> submit(*cube, transforms[i]);
+      }
+    }
+
+    // Execute the queued draws, sorted by state
+    renderer -> flush();
+  }
+
+  renderer -> endPass();
+
+  if (spriteBatch) {
+    renderer -> beginPass("sprites");
+    renderSprites();
+    renderer -> endPass();
+  }
+
+  renderer -> endFrame();
+}
+
+void Game::renderSprites() {
+  ProfileScope scope(profiler, "sprites");
+
+  // Sprites fill the screen row by row, each circling around its place, one animation step per frame
+  int columns = window -> getWidth() / tileSize;
+  int step = static_cast<int>(profiler -> getFrameIndex() % spriteAnimationSteps);
+  glm::vec2 offsets[spriteAnimationSteps];
+  for (int i = 0; i < spriteAnimationSteps; ++i) {
+    float angle = 2.0f * 3.14159265f * i / spriteAnimationSteps;
+    offsets[i] = glm::vec2(std::cos(angle), std::sin(angle)) * static_cast<float>(tileSize);
+  }
+
+  spriteBatch -> begin(window -> getWidth(), window -> getHeight());
+  spriteBatch -> setTexture(tileAtlas -> getTextureId());
+  for (int i = 0; i < options.spriteCount; ++i) {
+    glm::vec2 position(
+      static_cast<float>((i % columns) * tileSize),
+      static_cast<float>(((i / columns) * tileSize) % window -> getHeight())
+    );
+    position += offsets[(i + step) % spriteAnimationSteps];
+    spriteBatch -> draw(tileAtlas -> getRegion(tiles[i % tileCount]), position, glm::vec2(tileSize));
+  }
+  spriteBatch -> end();
 }
 
 int Game::run() {
@@ -207,28 +791,286 @@ int Game::run() {
     return -1;
   }
 
+  if (benchmark) {
+    benchmark -> start(window -> getTime());
+  }
+
   while (!window -> shouldClose()) {
-    double startTime = glfwGetTime();
+    // Assets are put to use on the render thread, which reports failures here
+    if (assetsFailed) {
+      renderThread -> finish();
+      return -1;
+    }
+
+    double startTime = window -> getTime();
+    profiler -> beginFrame();
+
+    // Everything touching OpenGL is recorded into the frame's command list and runs on the render thread, while this
+    // thread goes on to simulate the next frame
+    renderThread -> getCommandList().record([this]() {
+      gpuTimer -> beginFrame();
+      latencyTracker -> beginFrame();
+    });
+
+    // The benchmark replaces user input with its scripted camera path or the replayed recording, which counts as input
+    // taken at frame start
+    if (benchmark) {
+      if (options.inputReplay.empty()) {
+        benchmark -> beginFrame(*camera);
+      } else {
+        replayInput();
+      }
+      renderThread -> getCommandList().record([this, startTime]() { latencyTracker -> addInput(startTime); });
+    } else {
+      ProfileScope scope(profiler, "handleInput");
+      handleInput();
+    }
+
+    // Run the simulation at its fixed tick rate, then place the camera between the last two ticks for rendering
+    {
+      ProfileScope scope(profiler, "simulate");
+      int ticks = timestep -> advance(deltaTime);
+      for (int i = 0; i < ticks; ++i) {
+        simulate(timestep -> getTickDuration());
+      }
+      camera -> interpolate(timestep -> getAlpha());
+    }
+
+    // Put the assets loaded in the background to use
+    renderThread -> getCommandList().record([this]() {
+      ProfileScope scope(profiler, "loadAssets");
+      if (!updateAssets()) {
+        assetsFailed = true;
+      }
+    });
+
+    // Start rebuilding edited shaders, and swap them in once the driver has finished in the background
+    bool reloadDue = benchmark && options.reloadInterval > 0 && profiler -> getFrameIndex() % options.reloadInterval == 0;
+    bool reloadRequested = reloadDue || (shaderWatcher && shaderWatcher -> poll());
+    renderThread -> getCommandList().record([this, reloadRequested]() {
+      if (!shadersReady) {
+        return;
+      }
+
+      ProfileScope scope(profiler, "shaderReload");
+      if (reloadRequested) {
+        shaderProgram -> reload();
+        if (spriteProgram) {
+          spriteProgram -> reload();
+        }
+      }
+      shaderProgram -> updateReload();
+      if (spriteProgram) {
+        spriteProgram -> updateReload();
+      }
+    });
 
-    handleInput();
+    // Pick up chunk meshes finished by the meshing threads
+    if (world) {
+      renderThread -> getCommandList().record([this]() {
+        ProfileScope scope(profiler, "uploadChunks");
+        world -> update(chunkUploadBudget);
+      });
+    }
 
-    render();
+    // Process pending events as late as possible, so that the frame shows all the mouse motion received until now
+    {
+      ProfileScope scope(profiler, "pollEvents");
+      window -> pollEvents();
+      input -> update();
+      if (!benchmark) {
+        handleMouseMovement();
+      } else if (!options.inputReplay.empty()) {
+        replayMouseMovement();
+      }
+    }
+
+    {
+      ProfileScope scope(profiler, "render");
+      render();
+    }
+
+    if (benchmark) {
+      int frame = benchmark -> getFrameIndex();
+      renderThread -> getCommandList().record([this, frame]() { benchmark -> captureFrame(*window, frame); });
+    }
 
     // Swap the front and back buffers, displaying the newly rendered frame
-    window -> swapBuffers();
+    renderThread -> getCommandList().record([this]() {
+      ProfileScope scope(profiler, "swapBuffers");
+      window -> swapBuffers();
+      latencyTracker -> endFrame();
+    });
+
+    // Benchmark frames are timed as they come out of the pipeline, once drawn and swapped
+    if (benchmark) {
+      int frame = benchmark -> getFrameIndex();
+      renderThread -> getCommandList().record([this, frame]() { benchmark -> finishFrame(frame, window -> getTime()); });
+    }
 
-    // Process any pending events, such as keyboard and mouse input
-    window -> pollEvents();
+    // Wait for the render thread to finish the previous frame, then hand it this one
+    {
+      ProfileScope scope(profiler, "submit");
+      renderThread -> submit();
+    }
+
+    if (benchmark) {
+      benchmark -> endFrame();
+      if (benchmark -> isFinished()) {
+        window -> close();
+      }
+    }
+
+    if (!options.inputRecording.empty()) {
+      inputLog -> append(recordedInput);
+    }
 
     update(startTime);
+    profiler -> endFrame();
+  }
+
+  // The reports read the render thread's statistics, which are only complete once it has drawn the last frame
+  renderThread -> finish();
+
+  if (benchmark) {
+    benchmark -> report(std::cout);
+    if (!options.inputReplay.empty()) {
+      std::cout << "  input replayed from " << options.inputReplay << " (" << inputLog -> getFrameCount()
+                << " frames recorded)" << std::endl;
+    }
+    std::cout << "  cubes visible in last frame " << cubeGrid -> getStats().objectsVisible << "/" << cubeTransforms -> size()
+              << " (" << cubeGrid -> getStats().objectsTested << " tested individually)" << std::endl
+              << "  last frame: " << renderer -> getStats().draws << " draws, "
+              << renderer -> getStats().programSwitches << " program switches, "
+              << renderer -> getStats().vertexArrayBinds << " VAO binds, "
+              << GLState::getStats().issued << " GL state changes (" << GLState::getStats().skipped << " redundant ones skipped)"
+              << std::endl;
+    AssetStats assetStats = assetManager -> getStats();
+    std::cout << "  assets: " << assetStats.loaded << " loaded, " << assetStats.failed << " failed, "
+              << assetStats.queueDepth << " still queued" << std::endl;
+    std::cout << "  jobs: " << jobSystem -> getThreadCount() << " thread(s), " << jobSystem -> getStealCount()
+              << " jobs stolen";
+    if (agentUpdateCount > 0) {
+      std::cout << ", " << agents.size() << " agents updated in " << agentUpdateTime / agentUpdateCount * 1000.0
+                << " ms per tick";
+    }
+    std::cout << std::endl;
+    if (spriteBatch) {
+      std::cout << "  sprites in last frame: " << spriteBatch -> getStats().sprites << " in "
+                << spriteBatch -> getStats().draws << " draw call(s), atlas " << tileAtlas -> getUsage() * 100.0f << "% used, "
+                << spriteBatch -> getStream().getStats().resizes << " stream resizes" << std::endl;
+    }
+    const StreamBufferStats& streamStats = renderer -> getInstanceStream().getStats();
+    std::cout << "  instance stream: " << (renderer -> getInstanceStream().isPersistent() ? "persistent mapping" : "orphaning")
+              << ", " << streamStats.bytesStreamed / 1024 << " KiB streamed, " << streamStats.stalls << " stalls ("
+              << streamStats.stallTime * 1000.0 << " ms), " << streamStats.resizes << " resizes" << std::endl;
+    RenderThreadStats threadStats = renderThread -> getStats();
+    std::cout << "  render thread: " << (renderThread -> isThreaded() ? "on" : "off") << ", executed "
+              << threadStats.executeTime / threadStats.frames * 1000.0 << " ms/frame, overlapped with simulation "
+              << threadStats.overlapTime / threadStats.frames * 1000.0 << " ms/frame, added latency avg "
+              << threadStats.waitTime / threadStats.frames * 1000.0 << " ms max " << threadStats.maxWaitTime * 1000.0
+              << " ms" << std::endl;
+    if (occlusionCuller) {
+      const OcclusionStats& occlusionStats = occlusionCuller -> getStats();
+      std::cout << "  occlusion culling at " << occlusionCuller -> getWidth() << "x" << occlusionCuller -> getHeight()
+                << ", last frame: " << occlusionStats.occluders << "/" << occlusionCuller -> getOccluderCount()
+                << " occluders (" << occlusionStats.occluderTriangles << " triangles), " << occlusionStats.occludeesCulled
+                << "/" << occlusionStats.occludeesTested << " cubes hidden, raster " << occlusionStats.rasterTime * 1000.0
+                << " ms, test " << occlusionStats.testTime * 1000.0 << " ms" << std::endl;
+    }
+    if (softwareRenderer) {
+      const SoftwareRenderStats& softwareStats = softwareRenderer -> getStats();
+      std::cout << "  software rasterizer at " << softwareRenderer -> getWidth() << "x" << softwareRenderer -> getHeight()
+                << ", last frame: " << softwareStats.trianglesSubmitted << " triangles (" << softwareStats.trianglesCulled
+                << " culled, " << softwareStats.trianglesClipped << " clipped), " << softwareStats.tileTriangles
+                << " tile triangles, setup " << softwareStats.setupTime * 1000.0 << " ms, raster "
+                << softwareStats.rasterTime * 1000.0 << " ms" << std::endl;
+    }
+    LatencyStats latency = latencyTracker -> getStats();
+    std::cout << "  input to frame finished latency: avg " << latency.meanLatency * 1000.0 << " ms, p99 "
+              << latency.p99Latency * 1000.0 << " ms, max " << latency.maxLatency * 1000.0 << " ms over "
+              << latency.samples << " frames (" << latency.dropped << " not finished in time)" << std::endl;
+    if (options.validateGLState) {
+      std::cout << "  GL state shadow mismatches: " << GLState::getStats().mismatches << std::endl;
+    }
+    if (options.windowMode == WindowMode::Null) {
+      reportNullGL();
+    }
+  }
+  if (!options.profileOutput.empty()) {
+    dumpProfile(options.profileOutput);
+  }
+  if (!options.inputRecording.empty() && inputLog -> save(options.inputRecording)) {
+    std::cout << "Input of " << inputLog -> getFrameCount() << " frames recorded to " << options.inputRecording << std::endl;
   }
   return 0;
 }
 
+void Game::reportNullGL() {
+  const NullGLStats& stats = NullGL::getStats();
+  double frames = static_cast<double>(std::max<size_t>(stats.frames, 1));
+  std::cout << "  null renderer per frame: " << stats.commands / frames << " GL commands in "
+            << stats.streamWords * sizeof(uint32_t) / frames / 1024.0 << " KiB, " << stats.draws / frames << " draws of "
+            << stats.indices / frames << " indices, " << stats.uploadBytes / frames / 1024.0 << " KiB uploaded"
+            << std::endl;
+
+  // The most frequent commands show where the submission path spends its calls
+  std::vector<GLCommand> commands;
+  for (size_t i = 0; i < static_cast<size_t>(GLCommand::Count); ++i) {
+    if (NullGL::getCommandCount(static_cast<GLCommand>(i)) > 0) {
+      commands.push_back(static_cast<GLCommand>(i));
+    }
+  }
+  std::sort(commands.begin(), commands.end(), [](GLCommand a, GLCommand b) {
+    return NullGL::getCommandCount(a) > NullGL::getCommandCount(b);
+  });
+  commands.resize(std::min<size_t>(commands.size(), 8));
+
+  std::cout << "  most frequent commands per frame:";
+  for (GLCommand command : commands) {
+    std::cout << " " << NullGL::getCommandName(command) << " " << NullGL::getCommandCount(command) / frames;
+  }
+  std::cout << std::endl;
+}
+
+void Game::dumpProfile(const std::string& prefix) {
+  if (profiler -> writeCsv(prefix + ".csv") && profiler -> writeChromeTrace(prefix + ".json")) {
+    std::cout << "Profile written to " << prefix << ".csv and " << prefix << ".json" << std::endl;
+  }
+}
+
 Game::~Game() {
+  // Takes the OpenGL context back from the render thread, so the objects below can be deleted on this thread
+  delete renderThread;
+
+  delete pacer;
+  delete timestep;
+  delete benchmark;
+  delete inputLog;
+  delete gpuTimer;
+  delete profiler;
   delete camera;
+  delete renderCamera;
   delete renderer;
+  delete softwareRenderer;
+  delete latencyTracker;
+  delete input;
   delete shaderProgram;
+  delete shaderCache;
+  delete shaderWatcher;
+  delete cubeGrid;
+  delete occlusionCuller;
+  delete cubeTransforms;
+  delete world;
+  delete spriteBatch;
+  delete tileAtlas;
+  delete spriteProgram;
+
+  // Loaded meshes and textures belong to the asset manager, and its loads to the thread pool
+  delete assetManager;
+  delete threadPool;
+  delete jobSystem;
+
+  // The window owns the OpenGL context, so it must outlive every object holding OpenGL resources
   delete window;
-  delete cube;
 }
\ No newline at end of file
@@ -6,11 +6,34 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <atomic>
 #include <string>
+#include <vector>
 #include "../shader/ShaderProgram.h"
+#include "../shader/ShaderWatcher.h"
 #include "../window/Window.h"
 #include "../camera/Camera.h"
 #include "../renderer/Renderer.h"
+#include "../renderer/RenderThread.h"
+#include "../renderer/SoftwareRenderer.h"
+#include "../benchmark/FrameBenchmark.h"
+#include "../profiler/Profiler.h"
+#include "../profiler/GpuTimer.h"
+#include "../profiler/LatencyTracker.h"
+#include "../input/Input.h"
+#include "../input/InputLog.h"
+#include "../timing/FramePacer.h"
+#include "../timing/FixedTimestep.h"
+#include "../world/World.h"
+#include "../culling/CullingGrid.h"
+#include "../culling/OcclusionCuller.h"
+#include "../entity/TransformStore.h"
+#include "../sprite/SpriteBatch.h"
+#include "../sprite/TextureAtlas.h"
+#include "../asset/AssetManager.h"
+#include "../jobs/ThreadPool.h"
+#include "../jobs/JobSystem.h"
+#include "GameOptions.h"
 
 /**
  * @class Game
@@ -26,8 +49,9 @@ public:
    * @param width Width of the game window.
    * @param height Height of the game window.
    * @param title Title displayed in the game window.
+   * @param options Launch configuration, e.g. headless mode or benchmark settings.
    */
-  Game(int width, int height, std::string title);
+  Game(int width, int height, std::string title, const GameOptions& options = GameOptions());
 
   /**
    * @brief Destroys the Game object, releasing allocated resources.
@@ -48,51 +72,330 @@ private:
   void update(double startTime);
 
   /**
-   * @brief Renders the current frame.
+   * @brief Advances the simulation by one fixed tick.
+   * @param tickDuration Length of the tick in seconds.
+   */
+  void simulate(double tickDuration);
+
+  /**
+   * @brief Steers the synthetic agents for one fixed tick, spread over every thread of the job system.
+   * @param tickDuration Length of the tick in seconds.
+   */
+  void updateAgents(double tickDuration);
+
+  /**
+   * @brief Turns the spinning cubes for one fixed tick.
+   * @param tickDuration Length of the tick in seconds.
+   */
+  void spinCubes(double tickDuration);
+
+  /**
+   * @brief Sets the rotations of the spinning cubes between their angles of the last two ticks, like the camera.
+   * @param alpha Fraction of a tick elapsed since the last one, in [0, 1).
+   */
+  void poseSpinningCubes(double alpha);
+
+  /**
+   * @brief Culls the scene and records the current frame's draws for the render thread.
    */
   void render();
 
+  /**
+   * @brief Draws the scene on the render thread.
+   * @param frustum View frustum of the frame's camera.
+   * @param transforms Model matrices of the visible cubes, copied into the frame's command list.
+   * @param transformCount Number of visible cubes.
+   */
+  void drawScene(const Frustum& frustum, const glm::mat4* transforms, size_t transformCount);
+
+  /**
+   * @brief Draws the animated sprite layer over the scene.
+   */
+  void renderSprites();
+
+  /**
+   * @brief Creates the sprite program, tile atlas and sprite batch.
+   * @return true on success; false otherwise, after printing the error to stderr.
+   */
+  bool initializeSprites();
+
+  /**
+   * @brief Uploads loaded assets within the frame's budget and puts them to use once they are ready.
+   * @return false if an asset the game cannot run without failed to load.
+   */
+  bool updateAssets();
+
   /**
    * @brief Initializes all core components, including the window, shaders, camera, and renderer.
    * @return Returns true if initialization was successful; false otherwise.
    */
   bool initialize();
 
+  /**
+   * @brief Prints how many shader programs were loaded from the cache and the compile time this saved.
+   */
+  void reportShaderCache();
+
   /**
    * @brief Handles input from user.
+   *
+   * Held movement keys are recorded and applied by every simulation tick, while mouse look is applied by
+   * handleMouseMovement() right before rendering.
    */
   void handleInput();
 
   /**
-   * @brief Handles mouse movement from user.
+   * @brief Turns the camera by the mouse motion received so far, and notes its time for the latency measurement.
    */
   void handleMouseMovement();
 
+  /**
+   * @brief Takes the held movement keys and the frame time of the current frame from the replayed recording.
+   */
+  void replayInput();
+
+  /**
+   * @brief Turns the camera by the mouse motion of the current frame of the replayed recording.
+   */
+  void replayMouseMovement();
+
+  /**
+   * @brief Prints the counters of the OpenGL commands recorded by NullGL, averaged per frame.
+   */
+  void reportNullGL();
+
+  /**
+   * @brief Writes the profiler's buffered samples to <prefix>.csv and <prefix>.json.
+   * @param prefix Path prefix of the output files.
+   */
+  void dumpProfile(const std::string& prefix);
+
   /**
    * Pointer to the window object managing the display.
    */
   Window* window; 
 
+  /**
+   * Pointer to the input collecting the window's keyboard and mouse events.
+   */
+  Input* input;
+
+  /**
+   * Pointer to the tracker measuring the latency from input to the finished frame.
+   */
+  LatencyTracker* latencyTracker;
+
   /**
    * Pointer to the shader program used for rendering.
    */
   ShaderProgram* shaderProgram;
 
+  /**
+   * Pointer to the cache of linked shader programs, or nullptr when caching is disabled.
+   */
+  ShaderCache* shaderCache;
+
+  /**
+   * Pointer to the watcher that triggers shader hot reloads, or nullptr if watching failed.
+   */
+  ShaderWatcher* shaderWatcher;
+
   /**
    * Pointer to the renderer responsible for drawing.
    */
   Renderer* renderer;
 
   /**
-   * Pointer to the camera for view transformations.
+   * Pointer to the renderer rasterizing the cubes on the CPU, or nullptr when they are drawn with OpenGL.
+   */
+  SoftwareRenderer* softwareRenderer;
+
+  /**
+   * Pointer to the camera for view transformations, moved by the simulation.
    */
   Camera* camera;
 
   /**
-   * Pointer to the mesh representing the 3D cube.
+   * Pointer to the copy of the camera the renderer draws the frame on the render thread with.
+   */
+  Camera* renderCamera;
+
+  /**
+   * Pointer to the thread executing the frames' OpenGL work.
+   */
+  RenderThread* renderThread;
+
+  /**
+   * Set by the render thread when an asset the game cannot run without failed to load.
+   */
+  std::atomic<bool> assetsFailed;
+
+  /**
+   * Pointer to the mesh representing the 3D cube, owned by the asset manager, or nullptr until it has loaded.
    */
   Mesh* cube;
 
+  /**
+   * Pointer to the job system fanning the frame's work out over every core.
+   */
+  JobSystem* jobSystem;
+
+  /**
+   * Pointer to the worker threads loading assets in the background.
+   */
+  ThreadPool* threadPool;
+
+  /**
+   * Pointer to the asset manager loading the scene's files without blocking the frame loop.
+   */
+  AssetManager* assetManager;
+
+  /**
+   * The cube model, loading in the background.
+   */
+  AssetHandle<MeshAsset> cubeAsset;
+
+  /**
+   * Sources of the scene and sprite shaders, loading in the background.
+   */
+  AssetHandle<TextAsset> vertexShaderSource;
+  AssetHandle<TextAsset> fragmentShaderSource;
+  AssetHandle<TextAsset> spriteVertexShaderSource;
+  AssetHandle<TextAsset> spriteFragmentShaderSource;
+
+  /**
+   * Whether the shader programs have been built from their loaded sources, so that the scene can be drawn. Only used
+   * on the render thread, as is cube.
+   */
+  bool shadersReady;
+
+  /**
+   * Pointer to the transforms of every cube in the scene, one entity per cube.
+   */
+  TransformStore* cubeTransforms;
+
+  /**
+   * Number of cubes spinning in place, the first entities of cubeTransforms, and their angle in radians after the
+   * last tick and the one before it. The previous angle is kept unwrapped, at most one tick's turn below the current.
+   */
+  int spinningCount;
+  float spinAngle;
+  float previousSpinAngle;
+
+  /**
+   * Pointer to the spatial index of the cube bounding boxes, used to skip cubes outside the view.
+   */
+  CullingGrid* cubeGrid;
+
+  /**
+   * Bounding boxes of the cubes, indexed like their entities.
+   */
+  std::vector<AABB> cubeBounds;
+
+  /**
+   * Pointer to the culler skipping cubes hidden behind the buildings, or nullptr when occlusion culling is disabled.
+   */
+  OcclusionCuller* occlusionCuller;
+
+  /**
+   * Indices of the cubes that passed culling this frame.
+   */
+  std::vector<uint32_t> visibleCubes;
+
+  /**
+   * Pointer to the chunked terrain, or nullptr when the scene has none.
+   */
+  World* world;
+
+  /**
+   * Pointer to the program drawing sprites, or nullptr when the scene has none.
+   */
+  ShaderProgram* spriteProgram;
+
+  /**
+   * Pointer to the atlas holding the sprite tiles, or nullptr when the scene has none.
+   */
+  TextureAtlas* tileAtlas;
+
+  /**
+   * Pointer to the batcher drawing the sprite layer, or nullptr when the scene has none.
+   */
+  SpriteBatch* spriteBatch;
+
+  /**
+   * Indices of the tiles in the tile atlas.
+   */
+  std::vector<int> tiles;
+
+  /**
+   * A synthetic agent wandering the plane, standing in for game logic whose cost grows with the entity count.
+   */
+  struct Agent {
+    glm::vec2 position;
+    glm::vec2 velocity;
+  };
+
+  /**
+   * Agents updated on the job system every tick.
+   */
+  std::vector<Agent> agents;
+
+  /**
+   * Total time spent updating agents and the number of updates, reported by benchmarks to compare thread counts.
+   */
+  double agentUpdateTime;
+  int agentUpdateCount;
+
+  /**
+   * Pointer to the benchmark runner driving the loop, or nullptr when playing interactively.
+   */
+  FrameBenchmark* benchmark;
+
+  /**
+   * Pointer to the input being recorded or replayed, or nullptr when doing neither.
+   */
+  InputLog* inputLog;
+
+  /**
+   * Input taken during the current frame, appended to the log at the end of the frame when recording.
+   */
+  FrameInput recordedInput;
+
+  /**
+   * Pointer to the profiler recording per-frame stage timings.
+   */
+  Profiler* profiler;
+
+  /**
+   * Pointer to the timer measuring render passes on the GPU.
+   */
+  GpuTimer* gpuTimer;
+
+  /**
+   * Pointer to the pacer that holds each frame to the target frame time.
+   */
+  FramePacer* pacer;
+
+  /**
+   * Pointer to the accumulator that runs the simulation at a fixed tick rate.
+   */
+  FixedTimestep* timestep;
+
+  /**
+   * Movement keys held during the current frame.
+   */
+  struct MovementInput {
+    bool forward = false;
+    bool backward = false;
+    bool left = false;
+    bool right = false;
+  } movementInput;
+
+  /**
+   * Launch configuration the game was started with.
+   */
+  GameOptions options;
+
   /**
    * Width of the game window.
    */
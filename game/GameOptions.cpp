@@ -0,0 +1,128 @@
+/**
+ * @file GameOptions.cpp
+ * @brief Implements command line parsing for the GameOptions struct.
+ */
+
+#include "GameOptions.h"
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+  /**
+   * Number of frames a headless run renders when no explicit benchmark length is given.
+   */
+  const int defaultHeadlessFrames = 600;
+
+  void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --headless            Render offscreen through EGL instead of opening a window\n"
+              << "  --null-renderer       Record OpenGL calls without executing them, to time the CPU side alone\n"
+              << "  --benchmark <frames>  Render a fixed number of frames along a scripted camera path and report timings\n"
+              << "  --dump-frames <dir>   Save benchmark frames into <dir> as PNG files\n"
+              << "  --dump-interval <n>   Only save every n-th benchmark frame (default 1)\n"
+              << "  --profile <prefix>    Write profiler samples to <prefix>.csv and <prefix>.json on exit\n"
+              << "  --record-input <file> Record the input and frame times of every frame into <file> on exit\n"
+              << "  --replay <file>       Replay recorded input on the recorded clock as a benchmark, instead of the scripted path\n"
+              << "  --tick-rate <hz>      Fixed simulation tick rate (default 120)\n"
+              << "  --cubes <count>       Number of cubes in the scene (default 1)\n"
+              << "  --spinning <count>    Number of cubes spinning in place (default 0)\n"
+              << "  --buildings <count>   Number of buildings standing among the cubes (default 0)\n"
+              << "  --occlusion           Skip cubes hidden behind the buildings, found with a CPU depth buffer\n"
+              << "  --instanced           Draw all cubes with a single instanced draw call\n"
+              << "  --sprites <count>     Number of animated tile sprites drawn over the scene (default 0)\n"
+              << "  --threads <n>         Number of threads running the frame's jobs (default one per hardware thread)\n"
+              << "  --job-load <agents>   Number of synthetic agents updated on all threads every tick (default 0)\n"
+              << "  --no-render-thread    Submit OpenGL work on the main thread instead of a render thread\n"
+              << "  --software <w>x<h>    Rasterize the cubes on the CPU at the given resolution (no terrain)\n"
+              << "  --unsorted            Execute draws in submission order instead of sorting them by state\n"
+              << "  --world <radius>      Generate terrain chunks up to <radius> chunks around the origin\n"
+              << "  --shader-cache <dir>  Cache linked shader programs in <dir> (default .shadercache)\n"
+              << "  --no-shader-cache     Always compile shaders from source\n"
+              << "  --reload-interval <n> Rebuild the shaders every n benchmark frames, as if they were edited\n"
+              << "  --validate-gl-state   Check the shadowed OpenGL state against glGet* on every change (slow)\n"
+              << "  --no-buffer-storage   Stream per-frame data by orphaning buffers instead of persistent mapping\n";
+  }
+}
+
+bool GameOptions::parse(int argc, char** argv, GameOptions& options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string argument = argv[i];
+    bool hasValue = i + 1 < argc;
+
+    if (argument == "--headless") {
+      options.windowMode = WindowMode::Headless;
+    } else if (argument == "--null-renderer") {
+      options.windowMode = WindowMode::Null;
+    } else if (argument == "--benchmark" && hasValue) {
+      options.benchmarkFrames = std::atoi(argv[++i]);
+    } else if (argument == "--dump-frames" && hasValue) {
+      options.dumpDirectory = argv[++i];
+    } else if (argument == "--dump-interval" && hasValue) {
+      options.dumpInterval = std::atoi(argv[++i]);
+    } else if (argument == "--cubes" && hasValue) {
+      options.cubeCount = std::atoi(argv[++i]);
+    } else if (argument == "--spinning" && hasValue) {
+      options.spinningCount = std::atoi(argv[++i]);
+    } else if (argument == "--buildings" && hasValue) {
+      options.buildingCount = std::atoi(argv[++i]);
+    } else if (argument == "--occlusion") {
+      options.occlusionCulling = true;
+    } else if (argument == "--instanced") {
+      options.instanced = true;
+    } else if (argument == "--sprites" && hasValue) {
+      options.spriteCount = std::atoi(argv[++i]);
+    } else if (argument == "--threads" && hasValue) {
+      options.threadCount = std::atoi(argv[++i]);
+    } else if (argument == "--job-load" && hasValue) {
+      options.jobLoad = std::atoi(argv[++i]);
+    } else if (argument == "--no-render-thread") {
+      options.renderThread = false;
+    } else if (argument == "--software" && hasValue) {
+      if (std::sscanf(argv[++i], "%dx%d", &options.softwareWidth, &options.softwareHeight) != 2
+          || options.softwareWidth < 1 || options.softwareHeight < 1) {
+        printUsage(argv[0]);
+        return false;
+      }
+    } else if (argument == "--unsorted") {
+      options.sortDraws = false;
+    } else if (argument == "--no-buffer-storage") {
+      options.persistentStreaming = false;
+    } else if (argument == "--validate-gl-state") {
+      options.validateGLState = true;
+    } else if (argument == "--world" && hasValue) {
+      options.worldRadius = std::atoi(argv[++i]);
+    } else if (argument == "--tick-rate" && hasValue) {
+      options.tickRate = std::atoi(argv[++i]);
+    } else if (argument == "--shader-cache" && hasValue) {
+      options.shaderCacheDirectory = argv[++i];
+    } else if (argument == "--no-shader-cache") {
+      options.shaderCacheDirectory.clear();
+    } else if (argument == "--reload-interval" && hasValue) {
+      options.reloadInterval = std::atoi(argv[++i]);
+    } else if (argument == "--profile" && hasValue) {
+      options.profileOutput = argv[++i];
+    } else if (argument == "--record-input" && hasValue) {
+      options.inputRecording = argv[++i];
+    } else if (argument == "--replay" && hasValue) {
+      options.inputReplay = argv[++i];
+    } else {
+      printUsage(argv[0]);
+      return false;
+    }
+  }
+
+  // Nobody can close a headless window, so it always runs as a benchmark. Replays last as long as their recording
+  if (options.windowMode != WindowMode::Windowed && options.benchmarkFrames <= 0 && options.inputReplay.empty()) {
+    options.benchmarkFrames = defaultHeadlessFrames;
+  }
+
+  if (options.benchmarkFrames < 0 || options.dumpInterval < 1 || options.tickRate < 1 || options.cubeCount < 0 || options.spinningCount < 0
+      || options.buildingCount < 0 || options.spriteCount < 0 || options.reloadInterval < 0 || options.threadCount < 0 || options.jobLoad < 0
+      || (options.windowMode == WindowMode::Null && !options.dumpDirectory.empty())
+      || (!options.inputRecording.empty() && (options.benchmarkFrames > 0 || !options.inputReplay.empty()))) {
+    printUsage(argv[0]);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file GameOptions.h
+ * @brief Declares the GameOptions struct, which holds the launch configuration parsed from the command line.
+ */
+
+#ifndef GAME_OPTIONS_H
+#define GAME_OPTIONS_H
+
+#include <string>
+#include "../window/Window.h"
+
+/**
+ * @struct GameOptions
+ * @brief Launch configuration for a Game, normally filled in from the command line by parse().
+ *
+ * The defaults describe a regular interactive session in a visible window.
+ */
+struct GameOptions {
+  /**
+   * Whether to open a visible window, render offscreen, or only record the OpenGL calls, which leaves no frames to dump.
+   */
+  WindowMode windowMode = WindowMode::Windowed;
+
+  /**
+   * Number of frames the benchmark runner should render before exiting, or 0 to play interactively.
+   */
+  int benchmarkFrames = 0;
+
+  /**
+   * Directory that benchmark frames are dumped into as PNG files, or empty to skip dumping.
+   */
+  std::string dumpDirectory;
+
+  /**
+   * Only every n-th benchmark frame is dumped when dumpDirectory is set.
+   */
+  int dumpInterval = 1;
+
+  /**
+   * Number of cubes in the scene, laid out in a lattice around the origin.
+   */
+  int cubeCount = 1;
+
+  /**
+   * Number of cubes, out of cubeCount, that spin in place, so that their transforms change every tick.
+   */
+  int spinningCount = 0;
+
+  /**
+   * Number of buildings standing among the cubes, tall boxes that hide much of the scene behind them.
+   */
+  int buildingCount = 0;
+
+  /**
+   * Whether cubes hidden behind the buildings are culled on the CPU before they are submitted.
+   */
+  bool occlusionCulling = false;
+
+  /**
+   * Whether to draw the cubes with a single instanced draw call instead of one draw call each.
+   */
+  bool instanced = false;
+
+  /**
+   * Number of animated tile sprites drawn over the scene each frame.
+   */
+  int spriteCount = 0;
+
+  /**
+   * Number of threads running the frame's jobs, including the main thread, or 0 for one per hardware thread.
+   */
+  int threadCount = 0;
+
+  /**
+   * Whether OpenGL work runs on a render thread of its own, overlapping the simulation of the next frame.
+   */
+  bool renderThread = true;
+
+  /**
+   * Size in pixels of the framebuffer the cubes are rasterized into on the CPU, or 0 to draw them with OpenGL.
+   */
+  int softwareWidth = 0;
+  int softwareHeight = 0;
+
+  /**
+   * Number of synthetic agents whose steering is updated on the job system every simulation tick, to load the
+   * frame with parallel work.
+   */
+  int jobLoad = 0;
+
+  /**
+   * Number of terrain chunks generated on each side of the center chunk, or a negative number for no terrain.
+   */
+  int worldRadius = -1;
+
+  /**
+   * Whether draws are sorted by pipeline state before execution, which minimizes state changes.
+   */
+  bool sortDraws = true;
+
+  /**
+   * Number of fixed simulation ticks per second, independent of the frame rate.
+   */
+  int tickRate = 120;
+
+  /**
+   * Directory that linked shader program binaries are cached in, or empty to always compile shaders.
+   */
+  std::string shaderCacheDirectory = ".shadercache";
+
+  /**
+   * Benchmarks rebuild the shaders every n frames when set, to check that hot reloads never stall a frame.
+   */
+  int reloadInterval = 0;
+
+  /**
+   * Whether every state change is checked against the real OpenGL state, reporting stale shadowed state.
+   */
+  bool validateGLState = false;
+
+  /**
+   * Whether per-frame data is streamed through persistently mapped buffers when supported, rather than by orphaning.
+   */
+  bool persistentStreaming = true;
+
+  /**
+   * Path prefix the profiler writes <prefix>.csv and <prefix>.json to when the game exits, or empty to skip.
+   */
+  std::string profileOutput;
+
+  /**
+   * File the input of every frame is recorded into when the game exits, or empty to skip recording.
+   */
+  std::string inputRecording;
+
+  /**
+   * File of recorded input to replay instead of taking live input, or empty to play normally.
+   */
+  std::string inputReplay;
+
+  /**
+   * @brief Parses command line arguments into a GameOptions.
+   * @param argc Number of arguments, as passed to main.
+   * @param argv Argument values, as passed to main.
+   * @param options Receives the parsed options.
+   * @return true if all arguments were understood; false otherwise, after printing usage to stderr.
+   */
+  static bool parse(int argc, char** argv, GameOptions& options);
+};
+
+#endif
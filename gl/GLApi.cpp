@@ -0,0 +1,33 @@
+/**
+ * @file GLApi.cpp
+ * @brief Implements the GL class, which dispatches the game's OpenGL calls through a table of entry points.
+ */
+
+#include "GLApi.h"
+
+namespace {
+  /**
+   * Entry points calling the driver. With GLEW most of them are function pointers loaded by glewInit(), so each one
+   * is read at the time of the call rather than when the table is built.
+   */
+  constexpr GLApi driverApi = {
+#define GL_API_DRIVER(returnType, name, parameters, arguments) \
+    [] parameters -> returnType { return gl##name arguments; },
+    GL_API_FUNCTIONS(GL_API_DRIVER)
+#undef GL_API_DRIVER
+  };
+}
+
+GLApi GL::api = driverApi;
+
+void GL::setApi(const GLApi& backend) {
+  api = backend;
+}
+
+void GL::useDriver() {
+  api = driverApi;
+}
+
+const GLApi& GL::getDriverApi() {
+  return driverApi;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file GLApi.h
+ * @brief Declares the GL class, through which the game makes every OpenGL call, and the table of entry points it
+ * dispatches to.
+ */
+
+#ifndef GL_API_H
+#define GL_API_H
+
+#include <GL/glew.h>
+#include <cstdint>
+
+/**
+ * Every OpenGL entry point the game uses, as X(return type, name without the gl prefix, parameters, arguments).
+ * Expanded into the table of entry points, the GL wrappers and the GLCommand identifiers.
+ */
+#define GL_API_FUNCTIONS(X) \
+  X(void, ActiveTexture, (GLenum texture), (texture)) \
+  X(void, AttachShader, (GLuint program, GLuint shader), (program, shader)) \
+  X(void, BeginQuery, (GLenum target, GLuint id), (target, id)) \
+  X(void, BindBuffer, (GLenum target, GLuint buffer), (target, buffer)) \
+  X(void, BindBufferBase, (GLenum target, GLuint index, GLuint buffer), (target, index, buffer)) \
+  X(void, BindFramebuffer, (GLenum target, GLuint framebuffer), (target, framebuffer)) \
+  X(void, BindRenderbuffer, (GLenum target, GLuint renderbuffer), (target, renderbuffer)) \
+  X(void, BindTexture, (GLenum target, GLuint texture), (target, texture)) \
+  X(void, BindVertexArray, (GLuint array), (array)) \
+  X(void, BlendFunc, (GLenum sfactor, GLenum dfactor), (sfactor, dfactor)) \
+  X(void, BlitFramebuffer, (GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter), (srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter)) \
+  X(void, BufferData, (GLenum target, GLsizeiptr size, const void* data, GLenum usage), (target, size, data, usage)) \
+  X(void, BufferStorage, (GLenum target, GLsizeiptr size, const void* data, GLbitfield flags), (target, size, data, flags)) \
+  X(void, BufferSubData, (GLenum target, GLintptr offset, GLsizeiptr size, const void* data), (target, offset, size, data)) \
+  X(GLenum, CheckFramebufferStatus, (GLenum target), (target)) \
+  X(void, Clear, (GLbitfield mask), (mask)) \
+  X(GLenum, ClientWaitSync, (GLsync sync, GLbitfield flags, GLuint64 timeout), (sync, flags, timeout)) \
+  X(void, CompileShader, (GLuint shader), (shader)) \
+  X(GLuint, CreateProgram, (), ()) \
+  X(GLuint, CreateShader, (GLenum type), (type)) \
+  X(void, DeleteBuffers, (GLsizei n, const GLuint* buffers), (n, buffers)) \
+  X(void, DeleteFramebuffers, (GLsizei n, const GLuint* framebuffers), (n, framebuffers)) \
+  X(void, DeleteProgram, (GLuint program), (program)) \
+  X(void, DeleteQueries, (GLsizei n, const GLuint* ids), (n, ids)) \
+  X(void, DeleteRenderbuffers, (GLsizei n, const GLuint* renderbuffers), (n, renderbuffers)) \
+  X(void, DeleteShader, (GLuint shader), (shader)) \
+  X(void, DeleteSync, (GLsync sync), (sync)) \
+  X(void, DeleteTextures, (GLsizei n, const GLuint* textures), (n, textures)) \
+  X(void, DeleteVertexArrays, (GLsizei n, const GLuint* arrays), (n, arrays)) \
+  X(void, DepthFunc, (GLenum func), (func)) \
+  X(void, DepthMask, (GLboolean flag), (flag)) \
+  X(void, Disable, (GLenum cap), (cap)) \
+  X(void, DisableVertexAttribArray, (GLuint index), (index)) \
+  X(void, DrawElements, (GLenum mode, GLsizei count, GLenum type, const void* indices), (mode, count, type, indices)) \
+  X(void, DrawElementsInstanced, (GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount), (mode, count, type, indices, instancecount)) \
+  X(void, Enable, (GLenum cap), (cap)) \
+  X(void, EnableVertexAttribArray, (GLuint index), (index)) \
+  X(void, EndQuery, (GLenum target), (target)) \
+  X(GLsync, FenceSync, (GLenum condition, GLbitfield flags), (condition, flags)) \
+  X(void, Finish, (), ()) \
+  X(void, Flush, (), ()) \
+  X(void, FramebufferRenderbuffer, (GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer), (target, attachment, renderbuffertarget, renderbuffer)) \
+  X(void, FramebufferTexture2D, (GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level), (target, attachment, textarget, texture, level)) \
+  X(void, GenBuffers, (GLsizei n, GLuint* buffers), (n, buffers)) \
+  X(void, GenFramebuffers, (GLsizei n, GLuint* framebuffers), (n, framebuffers)) \
+  X(void, GenQueries, (GLsizei n, GLuint* ids), (n, ids)) \
+  X(void, GenRenderbuffers, (GLsizei n, GLuint* renderbuffers), (n, renderbuffers)) \
+  X(void, GenTextures, (GLsizei n, GLuint* textures), (n, textures)) \
+  X(void, GenVertexArrays, (GLsizei n, GLuint* arrays), (n, arrays)) \
+  X(void, GetActiveUniform, (GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name), (program, index, bufSize, length, size, type, name)) \
+  X(void, GetActiveUniformBlockName, (GLuint program, GLuint uniformBlockIndex, GLsizei bufSize, GLsizei* length, GLchar* uniformBlockName), (program, uniformBlockIndex, bufSize, length, uniformBlockName)) \
+  X(void, GetActiveUniformBlockiv, (GLuint program, GLuint uniformBlockIndex, GLenum pname, GLint* params), (program, uniformBlockIndex, pname, params)) \
+  X(void, GetInteger64v, (GLenum pname, GLint64* data), (pname, data)) \
+  X(void, GetIntegerv, (GLenum pname, GLint* data), (pname, data)) \
+  X(void, GetProgramBinary, (GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary), (program, bufSize, length, binaryFormat, binary)) \
+  X(void, GetProgramInfoLog, (GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog), (program, bufSize, length, infoLog)) \
+  X(void, GetProgramiv, (GLuint program, GLenum pname, GLint* params), (program, pname, params)) \
+  X(void, GetQueryObjectiv, (GLuint id, GLenum pname, GLint* params), (id, pname, params)) \
+  X(void, GetQueryObjectui64v, (GLuint id, GLenum pname, GLuint64* params), (id, pname, params)) \
+  X(void, GetShaderInfoLog, (GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog), (shader, bufSize, length, infoLog)) \
+  X(void, GetShaderiv, (GLuint shader, GLenum pname, GLint* params), (shader, pname, params)) \
+  X(const GLubyte*, GetString, (GLenum name), (name)) \
+  X(GLint, GetUniformLocation, (GLuint program, const GLchar* name), (program, name)) \
+  X(GLboolean, IsEnabled, (GLenum cap), (cap)) \
+  X(void, LinkProgram, (GLuint program), (program)) \
+  X(void*, MapBufferRange, (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access), (target, offset, length, access)) \
+  X(void, MaxShaderCompilerThreadsARB, (GLuint count), (count)) \
+  X(void, MaxShaderCompilerThreadsKHR, (GLuint count), (count)) \
+  X(void, PixelStorei, (GLenum pname, GLint param), (pname, param)) \
+  X(void, ProgramBinary, (GLuint program, GLenum binaryFormat, const void* binary, GLsizei length), (program, binaryFormat, binary, length)) \
+  X(void, ProgramParameteri, (GLuint program, GLenum pname, GLint value), (program, pname, value)) \
+  X(void, QueryCounter, (GLuint id, GLenum target), (id, target)) \
+  X(void, ReadPixels, (GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels), (x, y, width, height, format, type, pixels)) \
+  X(void, RenderbufferStorage, (GLenum target, GLenum internalformat, GLsizei width, GLsizei height), (target, internalformat, width, height)) \
+  X(void, ShaderSource, (GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length), (shader, count, string, length)) \
+  X(void, TexImage2D, (GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels), (target, level, internalformat, width, height, border, format, type, pixels)) \
+  X(void, TexParameteri, (GLenum target, GLenum pname, GLint param), (target, pname, param)) \
+  X(void, TexSubImage2D, (GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels), (target, level, xoffset, yoffset, width, height, format, type, pixels)) \
+  X(void, Uniform1f, (GLint location, GLfloat v0), (location, v0)) \
+  X(void, Uniform1i, (GLint location, GLint v0), (location, v0)) \
+  X(void, Uniform2f, (GLint location, GLfloat v0, GLfloat v1), (location, v0, v1)) \
+  X(void, Uniform3f, (GLint location, GLfloat v0, GLfloat v1, GLfloat v2), (location, v0, v1, v2)) \
+  X(void, Uniform4f, (GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3), (location, v0, v1, v2, v3)) \
+  X(void, UniformBlockBinding, (GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding), (program, uniformBlockIndex, uniformBlockBinding)) \
+  X(void, UniformMatrix4fv, (GLint location, GLsizei count, GLboolean transpose, const GLfloat* value), (location, count, transpose, value)) \
+  X(GLboolean, UnmapBuffer, (GLenum target), (target)) \
+  X(void, UseProgram, (GLuint program), (program)) \
+  X(void, VertexAttrib4f, (GLuint index, GLfloat x, GLfloat y, GLfloat z, GLfloat w), (index, x, y, z, w)) \
+  X(void, VertexAttribDivisor, (GLuint index, GLuint divisor), (index, divisor)) \
+  X(void, VertexAttribPointer, (GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer), (index, size, type, normalized, stride, pointer)) \
+  X(void, Viewport, (GLint x, GLint y, GLsizei width, GLsizei height), (x, y, width, height))
+
+/**
+ * @enum GLCommand
+ * @brief Identifies an OpenGL entry point, e.g. in the command stream recorded by NullGL.
+ */
+enum class GLCommand : uint16_t {
+#define GL_API_COMMAND(returnType, name, parameters, arguments) name,
+  GL_API_FUNCTIONS(GL_API_COMMAND)
+#undef GL_API_COMMAND
+
+  /**
+   * Number of entry points; not a command.
+   */
+  Count
+};
+
+/**
+ * @struct GLApi
+ * @brief Table holding an implementation of every OpenGL entry point the game uses.
+ */
+struct GLApi {
+#define GL_API_POINTER(returnType, name, parameters, arguments) returnType (*name) parameters;
+  GL_API_FUNCTIONS(GL_API_POINTER)
+#undef GL_API_POINTER
+};
+
+/**
+ * @class GL
+ * @brief Entry points the game makes its OpenGL calls through, named as in OpenGL without the gl prefix, e.g.
+ * GL::DrawElements() for glDrawElements().
+ *
+ * Each call is forwarded through the current table of entry points. By default the table calls the driver, but a
+ * different backend can be installed with setApi(), such as NullGL, which records the calls instead. The one indirect
+ * call this adds is negligible next to the work of the driver behind it.
+ *
+ * Like the OpenGL context the calls go to, the table is shared by the whole game, so the class is static. It must
+ * only be changed while no thread makes OpenGL calls.
+ */
+class GL {
+public:
+#define GL_API_WRAPPER(returnType, name, parameters, arguments) \
+  static returnType name parameters { return api.name arguments; }
+  GL_API_FUNCTIONS(GL_API_WRAPPER)
+#undef GL_API_WRAPPER
+
+  /**
+   * @brief Forwards every later call to the given table of entry points.
+   */
+  static void setApi(const GLApi& backend);
+
+  /**
+   * @brief Forwards every later call to the driver again, as at startup.
+   */
+  static void useDriver();
+
+  /**
+   * @brief Get the table of entry points calling the driver.
+   */
+  static const GLApi& getDriverApi();
+
+private:
+  /**
+   * The table every call is currently forwarded through.
+   */
+  static GLApi api;
+};
+
+#endif
@@ -0,0 +1,283 @@
+/**
+ * @file GLState.cpp
+ * @brief Implements the GLState class, which shadows OpenGL binding and pipeline state to skip redundant calls.
+ */
+
+#include "GLState.h"
+#include "GLApi.h"
+#include <iostream>
+
+namespace {
+  /**
+   * Shadow value meaning the state is not known, so the next request must be passed on.
+   */
+  const GLuint unknown = 0xffffffff;
+
+  /**
+   * Number of texture units with shadowed bindings.
+   */
+  const GLuint textureUnitCount = 16;
+
+  /**
+   * Buffer targets with shadowed bindings, and the glGet query returning each one's binding.
+   */
+  const GLenum bufferTargets[][2] = {
+    { GL_ARRAY_BUFFER, GL_ARRAY_BUFFER_BINDING },
+    { GL_UNIFORM_BUFFER, GL_UNIFORM_BUFFER_BINDING },
+    { GL_PIXEL_UNPACK_BUFFER, GL_PIXEL_UNPACK_BUFFER_BINDING },
+    { GL_PIXEL_PACK_BUFFER, GL_PIXEL_PACK_BUFFER_BINDING },
+    { GL_COPY_READ_BUFFER, GL_COPY_READ_BUFFER_BINDING },
+    { GL_COPY_WRITE_BUFFER, GL_COPY_WRITE_BUFFER_BINDING }
+  };
+
+  const size_t bufferTargetCount = sizeof(bufferTargets) / sizeof(bufferTargets[0]);
+
+  /**
+   * Capabilities with shadowed switches.
+   */
+  const GLenum capabilities[] = { GL_DEPTH_TEST, GL_CULL_FACE, GL_BLEND, GL_SCISSOR_TEST };
+
+  const size_t capabilityCount = sizeof(capabilities) / sizeof(capabilities[0]);
+
+  /**
+   * The shadowed state of the context.
+   */
+  struct Shadow {
+    GLuint program = unknown;
+    GLuint vertexArray = unknown;
+    GLuint buffers[bufferTargetCount];
+    GLuint activeTextureUnit = unknown;
+    GLuint textures[textureUnitCount];
+    GLuint capabilityStates[capabilityCount];
+    GLuint depthFunction = unknown;
+    GLuint depthWrites = unknown;
+    GLuint blendSource = unknown;
+    GLuint blendDestination = unknown;
+
+    Shadow() {
+      for (GLuint& buffer : buffers) buffer = unknown;
+      for (GLuint& texture : textures) texture = unknown;
+      for (GLuint& capability : capabilityStates) capability = unknown;
+    }
+  };
+
+  Shadow shadow;
+  GLStateStats stats;
+  bool validation = false;
+
+  /**
+   * @brief Returns the shadow slot of a buffer target, or -1 if the target is not shadowed.
+   */
+  int bufferSlot(GLenum target) {
+    for (size_t i = 0; i < bufferTargetCount; ++i) {
+      if (bufferTargets[i][0] == target) {
+        return static_cast<int>(i);
+      }
+    }
+    return -1;
+  }
+
+  /**
+   * @brief Returns the shadow slot of a capability, or -1 if the capability is not shadowed.
+   */
+  int capabilitySlot(GLenum capability) {
+    for (size_t i = 0; i < capabilityCount; ++i) {
+      if (capabilities[i] == capability) {
+        return static_cast<int>(i);
+      }
+    }
+    return -1;
+  }
+
+  /**
+   * @brief In validation mode, compares a known shadow value with the real one from glGetIntegerv.
+   */
+  void validate(const char* what, GLuint shadowValue, GLenum query) {
+    if (!validation || shadowValue == unknown) {
+      return;
+    }
+
+    GLint actual = 0;
+    GL::GetIntegerv(query, &actual);
+    if (static_cast<GLuint>(actual) != shadowValue) {
+      ++stats.mismatches;
+      std::cerr << "GL state shadow mismatch: " << what << " is " << actual << ", shadow says " << shadowValue << std::endl;
+    }
+  }
+
+  /**
+   * @brief Updates a shadow value, returning whether the real state has to change.
+   */
+  bool change(GLuint& shadowValue, GLuint value) {
+    if (shadowValue == value) {
+      ++stats.skipped;
+      return false;
+    }
+    shadowValue = value;
+    ++stats.issued;
+    return true;
+  }
+}
+
+void GLState::useProgram(GLuint programId) {
+  validate("current program", shadow.program, GL_CURRENT_PROGRAM);
+  if (change(shadow.program, programId)) {
+    GL::UseProgram(programId);
+  }
+}
+
+void GLState::bindVertexArray(GLuint vertexArrayId) {
+  validate("vertex array binding", shadow.vertexArray, GL_VERTEX_ARRAY_BINDING);
+  if (change(shadow.vertexArray, vertexArrayId)) {
+    GL::BindVertexArray(vertexArrayId);
+  }
+}
+
+void GLState::bindBuffer(GLenum target, GLuint bufferId) {
+  int slot = bufferSlot(target);
+  if (slot < 0) {
+    ++stats.issued;
+    GL::BindBuffer(target, bufferId);
+    return;
+  }
+
+  validate("buffer binding", shadow.buffers[slot], bufferTargets[slot][1]);
+  if (change(shadow.buffers[slot], bufferId)) {
+    GL::BindBuffer(target, bufferId);
+  }
+}
+
+void GLState::bindBufferBase(GLenum target, GLuint index, GLuint bufferId) {
+  // Indexed bindings are not shadowed, but the call also changes the generic binding
+  ++stats.issued;
+  GL::BindBufferBase(target, index, bufferId);
+
+  int slot = bufferSlot(target);
+  if (slot >= 0) {
+    shadow.buffers[slot] = bufferId;
+  }
+}
+
+void GLState::bindTexture2D(GLuint unit, GLuint textureId) {
+  if (unit >= textureUnitCount) {
+    ++stats.issued;
+    GL::ActiveTexture(GL_TEXTURE0 + unit);
+    GL::BindTexture(GL_TEXTURE_2D, textureId);
+    shadow.activeTextureUnit = unit;
+    return;
+  }
+
+  // Skip the unit switch too when the texture is already bound there
+  if (shadow.textures[unit] == textureId) {
+    ++stats.skipped;
+    return;
+  }
+
+  GLuint activeUnit = shadow.activeTextureUnit == unknown ? unknown : GL_TEXTURE0 + shadow.activeTextureUnit;
+  validate("active texture unit", activeUnit, GL_ACTIVE_TEXTURE);
+  if (change(shadow.activeTextureUnit, unit)) {
+    GL::ActiveTexture(GL_TEXTURE0 + unit);
+  }
+
+  validate("2D texture binding", shadow.textures[unit], GL_TEXTURE_BINDING_2D);
+  shadow.textures[unit] = textureId;
+  ++stats.issued;
+  GL::BindTexture(GL_TEXTURE_2D, textureId);
+}
+
+void GLState::setEnabled(GLenum capability, bool enabled) {
+  int slot = capabilitySlot(capability);
+  if (slot >= 0) {
+    if (validation && shadow.capabilityStates[slot] != unknown
+        && static_cast<GLuint>(GL::IsEnabled(capability)) != shadow.capabilityStates[slot]) {
+      ++stats.mismatches;
+      std::cerr << "GL state shadow mismatch: capability 0x" << std::hex << capability << std::dec << std::endl;
+    }
+    if (!change(shadow.capabilityStates[slot], enabled ? 1 : 0)) {
+      return;
+    }
+  } else {
+    ++stats.issued;
+  }
+
+  if (enabled) {
+    GL::Enable(capability);
+  } else {
+    GL::Disable(capability);
+  }
+}
+
+void GLState::depthFunc(GLenum function) {
+  validate("depth function", shadow.depthFunction, GL_DEPTH_FUNC);
+  if (change(shadow.depthFunction, function)) {
+    GL::DepthFunc(function);
+  }
+}
+
+void GLState::depthMask(bool enabled) {
+  validate("depth writes", shadow.depthWrites, GL_DEPTH_WRITEMASK);
+  if (change(shadow.depthWrites, enabled ? 1 : 0)) {
+    GL::DepthMask(enabled ? GL_TRUE : GL_FALSE);
+  }
+}
+
+void GLState::blendFunc(GLenum sourceFactor, GLenum destinationFactor) {
+  validate("blend source factor", shadow.blendSource, GL_BLEND_SRC_RGB);
+  validate("blend destination factor", shadow.blendDestination, GL_BLEND_DST_RGB);
+  if (shadow.blendSource == sourceFactor && shadow.blendDestination == destinationFactor) {
+    ++stats.skipped;
+    return;
+  }
+
+  shadow.blendSource = sourceFactor;
+  shadow.blendDestination = destinationFactor;
+  ++stats.issued;
+  GL::BlendFunc(sourceFactor, destinationFactor);
+}
+
+void GLState::deleteProgram(GLuint programId) {
+  // A deleted program stays current until another one is used, so its shadow stays valid
+  GL::DeleteProgram(programId);
+}
+
+void GLState::deleteVertexArray(GLuint vertexArrayId) {
+  GL::DeleteVertexArrays(1, &vertexArrayId);
+  if (shadow.vertexArray == vertexArrayId) {
+    shadow.vertexArray = 0;
+  }
+}
+
+void GLState::deleteBuffer(GLuint bufferId) {
+  GL::DeleteBuffers(1, &bufferId);
+  for (GLuint& buffer : shadow.buffers) {
+    if (buffer == bufferId) {
+      buffer = 0;
+    }
+  }
+}
+
+void GLState::deleteTexture(GLuint textureId) {
+  GL::DeleteTextures(1, &textureId);
+  for (GLuint& texture : shadow.textures) {
+    if (texture == textureId) {
+      texture = 0;
+    }
+  }
+}
+
+void GLState::reset() {
+  shadow = Shadow();
+}
+
+void GLState::setValidation(bool enabled) {
+  validation = enabled;
+}
+
+const GLStateStats& GLState::getStats() {
+  return stats;
+}
+
+void GLState::resetStats() {
+  stats.issued = 0;
+  stats.skipped = 0;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file GLState.h
+ * @brief Declares the GLState class, which shadows OpenGL binding and pipeline state to skip redundant calls.
+ */
+
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <GL/glew.h>
+#include <cstddef>
+
+/**
+ * @struct GLStateStats
+ * @brief Counters of state changes requested through GLState since the last resetStats().
+ */
+struct GLStateStats {
+  /**
+   * Number of state changes passed on to OpenGL.
+   */
+  size_t issued = 0;
+
+  /**
+   * Number of state changes skipped because the state already had the requested value.
+   */
+  size_t skipped = 0;
+
+  /**
+   * Number of mismatches between the shadow and the real state found by validation, over the whole run.
+   */
+  size_t mismatches = 0;
+};
+
+/**
+ * @class GLState
+ * @brief Remembers the current program, vertex array, buffer and texture bindings and fixed-function switches, and
+ * only calls OpenGL when a request actually changes them.
+ *
+ * Every change of the tracked state must go through this class, or the shadow no longer matches the context; call
+ * reset() after code that bypasses it. Objects must also be deleted through it, since OpenGL silently unbinds deleted
+ * vertex arrays, buffers and textures. Element array buffer bindings belong to the bound vertex array, so they are
+ * always passed through.
+ *
+ * With validation enabled, each request first compares the shadow with the real state from glGet* and reports every
+ * mismatch to stderr. This costs a pipeline round trip per call and is meant for debugging only.
+ *
+ * All state is per OpenGL context, and the game has a single one, so the class is static.
+ */
+class GLState {
+public:
+  /**
+   * @brief Makes a program current, as glUseProgram.
+   */
+  static void useProgram(GLuint programId);
+
+  /**
+   * @brief Binds a vertex array, as glBindVertexArray.
+   */
+  static void bindVertexArray(GLuint vertexArrayId);
+
+  /**
+   * @brief Binds a buffer to a target, as glBindBuffer.
+   */
+  static void bindBuffer(GLenum target, GLuint bufferId);
+
+  /**
+   * @brief Binds a buffer to an indexed binding point, as glBindBufferBase. This also sets the generic binding.
+   */
+  static void bindBufferBase(GLenum target, GLuint index, GLuint bufferId);
+
+  /**
+   * @brief Binds a 2D texture to a texture unit, as glActiveTexture followed by glBindTexture.
+   * @param unit Texture unit index, starting at 0.
+   * @param textureId Texture to bind.
+   */
+  static void bindTexture2D(GLuint unit, GLuint textureId);
+
+  /**
+   * @brief Enables or disables a capability such as GL_DEPTH_TEST, GL_CULL_FACE or GL_BLEND, as glEnable/glDisable.
+   */
+  static void setEnabled(GLenum capability, bool enabled);
+
+  /**
+   * @brief Sets the depth comparison function, as glDepthFunc.
+   */
+  static void depthFunc(GLenum function);
+
+  /**
+   * @brief Enables or disables depth writes, as glDepthMask.
+   */
+  static void depthMask(bool enabled);
+
+  /**
+   * @brief Sets the blend factors, as glBlendFunc.
+   */
+  static void blendFunc(GLenum sourceFactor, GLenum destinationFactor);
+
+  /**
+   * @brief Deletes a program, as glDeleteProgram.
+   */
+  static void deleteProgram(GLuint programId);
+
+  /**
+   * @brief Deletes a vertex array, as glDeleteVertexArrays, forgetting its binding.
+   */
+  static void deleteVertexArray(GLuint vertexArrayId);
+
+  /**
+   * @brief Deletes a buffer, as glDeleteBuffers, forgetting its bindings.
+   */
+  static void deleteBuffer(GLuint bufferId);
+
+  /**
+   * @brief Deletes a texture, as glDeleteTextures, forgetting its bindings.
+   */
+  static void deleteTexture(GLuint textureId);
+
+  /**
+   * @brief Forgets all shadowed state, so that the next request of each kind is passed on to OpenGL.
+   */
+  static void reset();
+
+  /**
+   * @brief Enables or disables validation of the shadow against the real state.
+   */
+  static void setValidation(bool enabled);
+
+  /**
+   * @brief Get the counters since the last resetStats().
+   */
+  static const GLStateStats& getStats();
+
+  /**
+   * @brief Resets the issued and skipped counters, e.g. at the start of each frame.
+   */
+  static void resetStats();
+};
+
+#endif
@@ -0,0 +1,358 @@
+/**
+ * @file NullGL.cpp
+ * @brief Implements the NullGL class, which records OpenGL calls into a command stream instead of executing them.
+ */
+
+#include "NullGL.h"
+#include <chrono>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+
+namespace {
+  /**
+   * Words reserved for the command stream of a frame at install, enough for a few thousand draws.
+   */
+  const size_t initialStreamWords = 64 * 1024;
+
+  /**
+   * Command streams of the current frame and of the last finished one.
+   */
+  std::vector<uint32_t> currentFrame;
+  std::vector<uint32_t> lastFrame;
+
+  size_t commandCounts[static_cast<size_t>(GLCommand::Count)];
+  NullGLStats stats;
+
+  /**
+   * Last name given to an object of any kind.
+   */
+  GLuint lastName = 0;
+
+  /**
+   * Buffer bound to each target, and the memory backing each buffer.
+   */
+  std::unordered_map<GLenum, GLuint> boundBuffers;
+  std::unordered_map<GLuint, std::vector<unsigned char>> bufferMemory;
+
+  /**
+   * Result of each query, in nanoseconds.
+   */
+  std::unordered_map<GLuint, GLuint64> queryResults;
+
+  const char* const commandNames[] = {
+#define NULL_GL_NAME(returnType, name, parameters, arguments) #name,
+    GL_API_FUNCTIONS(NULL_GL_NAME)
+#undef NULL_GL_NAME
+  };
+
+  /**
+   * @brief Appends an argument to the current frame's stream.
+   */
+  template <typename Argument>
+  void appendArgument(Argument argument) {
+    uint64_t value;
+    if constexpr (std::is_pointer<Argument>::value) {
+      value = reinterpret_cast<uintptr_t>(argument);
+    } else if constexpr (std::is_floating_point<Argument>::value) {
+      float single = static_cast<float>(argument);
+      uint32_t bits;
+      std::memcpy(&bits, &single, sizeof(bits));
+      value = bits;
+    } else {
+      value = static_cast<uint64_t>(argument);
+    }
+
+    currentFrame.push_back(static_cast<uint32_t>(value));
+    if (sizeof(Argument) > sizeof(uint32_t)) {
+      currentFrame.push_back(static_cast<uint32_t>(value >> 32));
+    }
+  }
+
+  /**
+   * Records one command when called with its arguments, as in Recorder{ GLCommand::Clear }(mask).
+   */
+  struct Recorder {
+    GLCommand command;
+
+    template <typename... Arguments>
+    void operator()(Arguments... arguments) const {
+      size_t start = currentFrame.size();
+      currentFrame.push_back(0);
+      (appendArgument(arguments), ...);
+      currentFrame[start] = static_cast<uint32_t>(command) | static_cast<uint32_t>(currentFrame.size() - start) << 16;
+
+      ++commandCounts[static_cast<size_t>(command)];
+      ++stats.commands;
+    }
+  };
+
+  GLuint64 nowNanoseconds() {
+    return static_cast<GLuint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+  }
+
+  void generateNames(GLsizei n, GLuint* names) {
+    for (GLsizei i = 0; i < n; ++i) {
+      names[i] = ++lastName;
+    }
+  }
+
+  /**
+   * @brief Gives the buffer bound to a target the given size, keeping its memory when it is already large enough.
+   */
+  void allocateBuffer(GLenum target, GLsizeiptr size) {
+    std::vector<unsigned char>& memory = bufferMemory[boundBuffers[target]];
+    if (memory.size() < static_cast<size_t>(size)) {
+      memory.resize(static_cast<size_t>(size));
+    }
+  }
+
+  /**
+   * Entry points with results, or whose effects later calls depend on. They record themselves like every other one.
+   */
+  void bindBuffer(GLenum target, GLuint buffer) {
+    Recorder{ GLCommand::BindBuffer }(target, buffer);
+    boundBuffers[target] = buffer;
+  }
+
+  void bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    Recorder{ GLCommand::BindBufferBase }(target, index, buffer);
+    boundBuffers[target] = buffer;
+  }
+
+  void bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+    Recorder{ GLCommand::BufferData }(target, size, data, usage);
+    allocateBuffer(target, size);
+    if (data) {
+      stats.uploadBytes += static_cast<size_t>(size);
+    }
+  }
+
+  void bufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags) {
+    Recorder{ GLCommand::BufferStorage }(target, size, data, flags);
+    allocateBuffer(target, size);
+  }
+
+  void bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+    Recorder{ GLCommand::BufferSubData }(target, offset, size, data);
+    stats.uploadBytes += static_cast<size_t>(size);
+  }
+
+  void* mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+    Recorder{ GLCommand::MapBufferRange }(target, offset, length, access);
+    allocateBuffer(target, offset + length);
+    return bufferMemory[boundBuffers[target]].data() + offset;
+  }
+
+  GLboolean unmapBuffer(GLenum target) {
+    Recorder{ GLCommand::UnmapBuffer }(target);
+    return GL_TRUE;
+  }
+
+  void deleteBuffers(GLsizei n, const GLuint* buffers) {
+    Recorder{ GLCommand::DeleteBuffers }(n, buffers);
+    for (GLsizei i = 0; i < n; ++i) {
+      bufferMemory.erase(buffers[i]);
+    }
+  }
+
+  void drawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) {
+    Recorder{ GLCommand::DrawElements }(mode, count, type, indices);
+    ++stats.draws;
+    stats.indices += static_cast<size_t>(count);
+  }
+
+  void drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount) {
+    Recorder{ GLCommand::DrawElementsInstanced }(mode, count, type, indices, instanceCount);
+    ++stats.draws;
+    stats.indices += static_cast<size_t>(count) * static_cast<size_t>(instanceCount);
+  }
+
+  void genBuffers(GLsizei n, GLuint* buffers) {
+    generateNames(n, buffers);
+    Recorder{ GLCommand::GenBuffers }(n, buffers);
+  }
+
+  void genFramebuffers(GLsizei n, GLuint* framebuffers) {
+    generateNames(n, framebuffers);
+    Recorder{ GLCommand::GenFramebuffers }(n, framebuffers);
+  }
+
+  void genQueries(GLsizei n, GLuint* ids) {
+    generateNames(n, ids);
+    Recorder{ GLCommand::GenQueries }(n, ids);
+  }
+
+  void genRenderbuffers(GLsizei n, GLuint* renderbuffers) {
+    generateNames(n, renderbuffers);
+    Recorder{ GLCommand::GenRenderbuffers }(n, renderbuffers);
+  }
+
+  void genTextures(GLsizei n, GLuint* textures) {
+    generateNames(n, textures);
+    Recorder{ GLCommand::GenTextures }(n, textures);
+  }
+
+  void genVertexArrays(GLsizei n, GLuint* arrays) {
+    generateNames(n, arrays);
+    Recorder{ GLCommand::GenVertexArrays }(n, arrays);
+  }
+
+  GLuint createProgram() {
+    Recorder{ GLCommand::CreateProgram }();
+    return ++lastName;
+  }
+
+  GLuint createShader(GLenum type) {
+    Recorder{ GLCommand::CreateShader }(type);
+    return ++lastName;
+  }
+
+  void getShaderiv(GLuint shader, GLenum pname, GLint* params) {
+    Recorder{ GLCommand::GetShaderiv }(shader, pname, params);
+    *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+  }
+
+  void getProgramiv(GLuint program, GLenum pname, GLint* params) {
+    Recorder{ GLCommand::GetProgramiv }(program, pname, params);
+    *params = pname == GL_LINK_STATUS || pname == GL_COMPLETION_STATUS_KHR ? GL_TRUE : 0;
+  }
+
+  void getIntegerv(GLenum pname, GLint* data) {
+    Recorder{ GLCommand::GetIntegerv }(pname, data);
+    *data = 0;
+  }
+
+  void getInteger64v(GLenum pname, GLint64* data) {
+    Recorder{ GLCommand::GetInteger64v }(pname, data);
+    *data = pname == GL_TIMESTAMP ? static_cast<GLint64>(nowNanoseconds()) : 0;
+  }
+
+  const GLubyte* getString(GLenum name) {
+    Recorder{ GLCommand::GetString }(name);
+    return reinterpret_cast<const GLubyte*>(name == GL_VERSION ? "4.1 NullGL" : "NullGL");
+  }
+
+  GLenum checkFramebufferStatus(GLenum target) {
+    Recorder{ GLCommand::CheckFramebufferStatus }(target);
+    return GL_FRAMEBUFFER_COMPLETE;
+  }
+
+  GLsync fenceSync(GLenum condition, GLbitfield flags) {
+    Recorder{ GLCommand::FenceSync }(condition, flags);
+    return reinterpret_cast<GLsync>(static_cast<uintptr_t>(++lastName));
+  }
+
+  GLenum clientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+    Recorder{ GLCommand::ClientWaitSync }(sync, flags, timeout);
+    return GL_ALREADY_SIGNALED;
+  }
+
+  void beginQuery(GLenum target, GLuint id) {
+    Recorder{ GLCommand::BeginQuery }(target, id);
+    queryResults[id] = 0;
+  }
+
+  void queryCounter(GLuint id, GLenum target) {
+    Recorder{ GLCommand::QueryCounter }(id, target);
+    queryResults[id] = nowNanoseconds();
+  }
+
+  void getQueryObjectiv(GLuint id, GLenum pname, GLint* params) {
+    Recorder{ GLCommand::GetQueryObjectiv }(id, pname, params);
+    *params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : static_cast<GLint>(queryResults[id]);
+  }
+
+  void getQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params) {
+    Recorder{ GLCommand::GetQueryObjectui64v }(id, pname, params);
+    *params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : queryResults[id];
+  }
+
+  void deleteQueries(GLsizei n, const GLuint* ids) {
+    Recorder{ GLCommand::DeleteQueries }(n, ids);
+    for (GLsizei i = 0; i < n; ++i) {
+      queryResults.erase(ids[i]);
+    }
+  }
+}
+
+void NullGL::install() {
+  GLApi api = {
+#define NULL_GL_RECORD(returnType, name, parameters, arguments) \
+    [] parameters -> returnType { Recorder{ GLCommand::name } arguments; return static_cast<returnType>(0); },
+    GL_API_FUNCTIONS(NULL_GL_RECORD)
+#undef NULL_GL_RECORD
+  };
+
+  api.BindBuffer = bindBuffer;
+  api.BindBufferBase = bindBufferBase;
+  api.BufferData = bufferData;
+  api.BufferStorage = bufferStorage;
+  api.BufferSubData = bufferSubData;
+  api.MapBufferRange = mapBufferRange;
+  api.UnmapBuffer = unmapBuffer;
+  api.DeleteBuffers = deleteBuffers;
+  api.DrawElements = drawElements;
+  api.DrawElementsInstanced = drawElementsInstanced;
+  api.GenBuffers = genBuffers;
+  api.GenFramebuffers = genFramebuffers;
+  api.GenQueries = genQueries;
+  api.GenRenderbuffers = genRenderbuffers;
+  api.GenTextures = genTextures;
+  api.GenVertexArrays = genVertexArrays;
+  api.CreateProgram = createProgram;
+  api.CreateShader = createShader;
+  api.GetShaderiv = getShaderiv;
+  api.GetProgramiv = getProgramiv;
+  api.GetIntegerv = getIntegerv;
+  api.GetInteger64v = getInteger64v;
+  api.GetString = getString;
+  api.CheckFramebufferStatus = checkFramebufferStatus;
+  api.FenceSync = fenceSync;
+  api.ClientWaitSync = clientWaitSync;
+  api.BeginQuery = beginQuery;
+  api.QueryCounter = queryCounter;
+  api.GetQueryObjectiv = getQueryObjectiv;
+  api.GetQueryObjectui64v = getQueryObjectui64v;
+  api.DeleteQueries = deleteQueries;
+
+  currentFrame.clear();
+  currentFrame.reserve(initialStreamWords);
+  lastFrame.clear();
+  for (size_t& count : commandCounts) {
+    count = 0;
+  }
+  stats = NullGLStats();
+  lastName = 0;
+  boundBuffers.clear();
+  bufferMemory.clear();
+  queryResults.clear();
+
+  GL::setApi(api);
+}
+
+void NullGL::endFrame() {
+  ++stats.frames;
+  stats.streamWords += currentFrame.size();
+
+  // Swapping keeps the memory of both streams, so that recording allocates nothing once frames stop growing
+  lastFrame.swap(currentFrame);
+  currentFrame.clear();
+}
+
+const std::vector<uint32_t>& NullGL::getLastFrame() {
+  return lastFrame;
+}
+
+size_t NullGL::getCommandCount(GLCommand command) {
+  return commandCounts[static_cast<size_t>(command)];
+}
+
+const char* NullGL::getCommandName(GLCommand command) {
+  return command < GLCommand::Count ? commandNames[static_cast<size_t>(command)] : "";
+}
+
+const NullGLStats& NullGL::getStats() {
+  return stats;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file NullGL.h
+ * @brief Declares the NullGL class, an OpenGL backend that records the game's calls instead of executing them.
+ */
+
+#ifndef NULL_GL_H
+#define NULL_GL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "GLApi.h"
+
+/**
+ * @struct NullGLStats
+ * @brief Counters of the commands NullGL recorded since it was installed.
+ */
+struct NullGLStats {
+  /**
+   * Number of frames ended with endFrame().
+   */
+  size_t frames = 0;
+
+  /**
+   * Number of commands recorded, of any kind.
+   */
+  size_t commands = 0;
+
+  /**
+   * Number of draw commands, and the number of indices they would have drawn, counting every instance.
+   */
+  size_t draws = 0;
+  size_t indices = 0;
+
+  /**
+   * Number of bytes passed to glBufferData() and glBufferSubData(). Writes through mapped buffers are not seen.
+   */
+  size_t uploadBytes = 0;
+
+  /**
+   * Number of 32-bit words of the command streams of every frame.
+   */
+  size_t streamWords = 0;
+};
+
+/**
+ * @class NullGL
+ * @brief OpenGL backend for GL that executes nothing, so that the cost of preparing and submitting frames can be
+ * measured without any driver.
+ *
+ * Every call is appended to the command stream of the current frame: a header word holding the GLCommand in its low
+ * 16 bits and the length of the command in words in its high 16 bits, followed by the arguments. Arguments of up to
+ * 32 bits take one word; pointers and 64-bit values take two, low word first. Pointed-to data is not copied. Each
+ * command is also counted by kind, see getCommandCount().
+ *
+ * Queries are answered like a driver that accepts everything and finishes instantly: objects get fresh names, shaders
+ * compile and programs link (without any active uniforms), fences are signaled, and timer queries read the CPU clock.
+ * Buffers are backed by memory so that they can be mapped, although what is written there is never read. No
+ * extension is reported, since GLEW is not initialized.
+ *
+ * Like GL, the backend is static and must only be called by one thread at a time.
+ */
+class NullGL {
+public:
+  /**
+   * @brief Points GL at the null backend and resets its counters and objects.
+   */
+  static void install();
+
+  /**
+   * @brief Finishes the command stream of the current frame, making it available through getLastFrame().
+   */
+  static void endFrame();
+
+  /**
+   * @brief Get the command stream of the last frame ended with endFrame().
+   */
+  static const std::vector<uint32_t>& getLastFrame();
+
+  /**
+   * @brief Get the number of times a command was recorded since install().
+   */
+  static size_t getCommandCount(GLCommand command);
+
+  /**
+   * @brief Get the name of a command, e.g. "DrawElements".
+   */
+  static const char* getCommandName(GLCommand command);
+
+  /**
+   * @brief Get the counters of the commands recorded since install().
+   */
+  static const NullGLStats& getStats();
+};
+
+#endif
@@ -0,0 +1,79 @@
+/**
+ * @file EventQueue.h
+ * @brief Defines the EventQueue class template, a fixed-size lock-free queue between one producer and one consumer.
+ */
+
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class EventQueue
+ * @brief A bounded, wait-free queue for one producer thread and one consumer thread.
+ *
+ * The producer only writes the tail index and the consumer only writes the head index, so neither ever waits for
+ * the other and no read-modify-write instructions are needed. Pushing onto a full queue fails instead of
+ * overwriting, since losing the oldest input events would corrupt the state they build up (e.g. a key release).
+ *
+ * @tparam T Type of the queued values.
+ * @tparam Capacity Number of slots. Must be a power of two.
+ */
+template <typename T, size_t Capacity>
+class EventQueue {
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "EventQueue capacity must be a power of two");
+
+public:
+  EventQueue() : head(0), tail(0) {}
+
+  /**
+   * @brief Appends a value. Only called by the producer.
+   * @return false if the queue is full and the value was dropped.
+   */
+  bool push(const T& value) {
+    size_t currentTail = tail.load(std::memory_order_relaxed);
+    if (currentTail - head.load(std::memory_order_acquire) == Capacity) {
+      return false;
+    }
+
+    slots[currentTail & (Capacity - 1)] = value;
+    tail.store(currentTail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Removes the oldest value. Only called by the consumer.
+   * @param value Receives the value.
+   * @return false if the queue is empty.
+   */
+  bool pop(T& value) {
+    size_t currentHead = head.load(std::memory_order_relaxed);
+    if (currentHead == tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    value = slots[currentHead & (Capacity - 1)];
+    head.store(currentHead + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  /**
+   * Storage for the values.
+   */
+  std::array<T, Capacity> slots;
+
+  /**
+   * Number of values popped so far, written only by the consumer. Kept on its own cache line, away from the tail.
+   */
+  alignas(64) std::atomic<size_t> head;
+
+  /**
+   * Number of values pushed so far, written only by the producer.
+   */
+  alignas(64) std::atomic<size_t> tail;
+};
+
+#endif
@@ -0,0 +1,129 @@
+/**
+ * @file Input.cpp
+ * @brief Implements the Input class, which collects keyboard and raw mouse events from GLFW callbacks.
+ */
+
+#include "Input.h"
+
+Input::Input(Window* window)
+  : window(window),
+    lastCursorX(0),
+    lastCursorY(0),
+    hasCursorPosition(false),
+    pendingMotionX(0),
+    pendingMotionY(0),
+    pendingMotionTime(-1.0),
+    stats({ 0, 0 }),
+    droppedEvents(0) {
+  keysDown.fill(false);
+  keysPressed.fill(false);
+}
+
+Input::~Input() {
+  if (window -> getWindow()) {
+    glfwSetKeyCallback(window -> getWindow(), nullptr);
+    glfwSetCursorPosCallback(window -> getWindow(), nullptr);
+    glfwSetWindowUserPointer(window -> getWindow(), nullptr);
+  }
+}
+
+bool Input::init() {
+  GLFWwindow* glfwWindow = window -> getWindow();
+  if (!glfwWindow) {
+    return true;
+  }
+
+  glfwSetWindowUserPointer(glfwWindow, this);
+  glfwSetKeyCallback(glfwWindow, keyCallback);
+  glfwSetCursorPosCallback(glfwWindow, cursorPositionCallback);
+
+  // A disabled cursor is hidden and its position unbounded, so motion never stops at the window edge and the cursor
+  // never has to be warped back to the center
+  glfwSetInputMode(glfwWindow, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+  if (glfwRawMouseMotionSupported()) {
+    glfwSetInputMode(glfwWindow, GLFW_RAW_MOUSE_MOTION, GLFW_TRUE);
+  }
+  return true;
+}
+
+void Input::keyCallback(GLFWwindow* glfwWindow, int key, int, int action, int) {
+  Input* input = static_cast<Input*>(glfwGetWindowUserPointer(glfwWindow));
+  if (!input || key < 0 || key > GLFW_KEY_LAST) {
+    return;
+  }
+  input -> push({ InputEvent::Key, key, action, 0, 0, input -> window -> getTime() });
+}
+
+void Input::cursorPositionCallback(GLFWwindow* glfwWindow, double x, double y) {
+  Input* input = static_cast<Input*>(glfwGetWindowUserPointer(glfwWindow));
+  if (!input) {
+    return;
+  }
+
+  // The first position is where the cursor was captured, which is no motion at all
+  if (input -> hasCursorPosition) {
+    input -> push({ InputEvent::MouseMotion, 0, 0, x - input -> lastCursorX, y - input -> lastCursorY,
+      input -> window -> getTime() });
+  }
+  input -> lastCursorX = x;
+  input -> lastCursorY = y;
+  input -> hasCursorPosition = true;
+}
+
+void Input::push(const InputEvent& event) {
+  if (!events.push(event)) {
+    droppedEvents.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void Input::update() {
+  keysPressed.fill(false);
+
+  InputEvent event;
+  while (events.pop(event)) {
+    ++stats.events;
+
+    if (event.type == InputEvent::Key) {
+      if (event.action == GLFW_PRESS) {
+        keysDown[event.key] = true;
+        keysPressed[event.key] = true;
+      } else if (event.action == GLFW_RELEASE) {
+        keysDown[event.key] = false;
+      }
+      continue;
+    }
+
+    pendingMotionX += event.deltaX;
+    pendingMotionY += event.deltaY;
+    if (pendingMotionTime < 0) {
+      pendingMotionTime = event.time;
+    }
+  }
+  stats.dropped = droppedEvents.load(std::memory_order_relaxed);
+}
+
+bool Input::isKeyDown(int key) const {
+  return keysDown[key];
+}
+
+bool Input::wasKeyPressed(int key) const {
+  return keysPressed[key];
+}
+
+bool Input::takeMouseMotion(double& deltaX, double& deltaY, double& eventTime) {
+  if (pendingMotionTime < 0) {
+    return false;
+  }
+
+  deltaX = pendingMotionX;
+  deltaY = pendingMotionY;
+  eventTime = pendingMotionTime;
+  pendingMotionX = 0;
+  pendingMotionY = 0;
+  pendingMotionTime = -1.0;
+  return true;
+}
+
+const InputStats& Input::getStats() const {
+  return stats;
+}
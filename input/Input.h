@@ -0,0 +1,196 @@
+/**
+ * @file Input.h
+ * @brief Declares the Input class, which collects keyboard and raw mouse events from GLFW callbacks.
+ */
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "../window/Window.h"
+#include "EventQueue.h"
+
+/**
+ * @struct InputEvent
+ * @brief A keyboard or mouse event, stamped with the time it was received.
+ */
+struct InputEvent {
+  enum Type : uint8_t {
+    Key,
+    MouseMotion
+  };
+
+  /**
+   * Kind of event.
+   */
+  Type type;
+
+  /**
+   * GLFW key and action (GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT) of key events.
+   */
+  int key;
+  int action;
+
+  /**
+   * Distance the mouse moved, in raw counts when raw motion is available and screen pixels otherwise.
+   */
+  double deltaX;
+  double deltaY;
+
+  /**
+   * Time the event was received, on the window's clock.
+   */
+  double time;
+};
+
+/**
+ * @struct InputStats
+ * @brief Counts of the events received by an Input.
+ */
+struct InputStats {
+  /**
+   * Number of events processed.
+   */
+  uint64_t events;
+
+  /**
+   * Number of events lost because the queue was full.
+   */
+  uint64_t dropped;
+};
+
+/**
+ * @class Input
+ * @brief Tracks held keys and accumulated mouse motion from events, instead of polling the window every frame.
+ *
+ * GLFW calls back into the Input for every event while the window processes its events, and the callbacks only
+ * timestamp the events and push them onto a lock-free queue. update() drains the queue into the key state and the
+ * pending mouse motion, which the game takes as late as possible before rendering, so that every bit of motion
+ * received up to then reaches the frame. The cursor is disabled, which keeps it in the window without warping it
+ * back every frame, and raw motion is used where the platform has it, bypassing pointer acceleration.
+ */
+class Input {
+public:
+  /**
+   * @brief Constructs an Input for a window. Nothing is received until init().
+   */
+  Input(Window* window);
+
+  /**
+   * @brief Removes the callbacks from the window.
+   */
+  ~Input();
+
+  /**
+   * @brief Installs the event callbacks and captures the cursor. Does nothing for headless windows, which have no
+   * input.
+   * @return true on success.
+   */
+  bool init();
+
+  /**
+   * @brief Applies the queued events to the key state and the pending mouse motion.
+   *
+   * Key presses are remembered until the next update(), so wasKeyPressed() sees presses released again within a
+   * frame too.
+   */
+  void update();
+
+  /**
+   * @brief Checks whether a key is held down.
+   * @param key GLFW key code.
+   */
+  bool isKeyDown(int key) const;
+
+  /**
+   * @brief Checks whether a key was pressed during the events handled by the last update().
+   * @param key GLFW key code.
+   */
+  bool wasKeyPressed(int key) const;
+
+  /**
+   * @brief Takes the mouse motion accumulated since it was last taken.
+   * @param deltaX Receives the horizontal motion.
+   * @param deltaY Receives the vertical motion.
+   * @param eventTime Receives the time of the oldest motion event taken.
+   * @return false if the mouse has not moved.
+   */
+  bool takeMouseMotion(double& deltaX, double& deltaY, double& eventTime);
+
+  /**
+   * @brief Get the event counts.
+   */
+  const InputStats& getStats() const;
+
+private:
+  /**
+   * @brief GLFW key callback; queues the event for the Input the window belongs to.
+   */
+  static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+
+  /**
+   * @brief GLFW cursor position callback; queues the motion since the previous position.
+   */
+  static void cursorPositionCallback(GLFWwindow* window, double x, double y);
+
+  /**
+   * @brief Queues an event, counting it as dropped if the queue is full.
+   */
+  void push(const InputEvent& event);
+
+  /**
+   * Window the events come from.
+   */
+  Window* window;
+
+  /**
+   * Events received by the callbacks and not yet applied by update().
+   */
+  EventQueue<InputEvent, 1024> events;
+
+  /**
+   * Held state of every GLFW key code.
+   */
+  std::array<bool, GLFW_KEY_LAST + 1> keysDown;
+
+  /**
+   * Keys pressed during the events handled by the last update().
+   */
+  std::array<bool, GLFW_KEY_LAST + 1> keysPressed;
+
+  /**
+   * Cursor position of the previous motion event, which motion is measured from.
+   */
+  double lastCursorX;
+  double lastCursorY;
+
+  /**
+   * Whether a cursor position has been received yet; the first one only sets the origin.
+   */
+  bool hasCursorPosition;
+
+  /**
+   * Mouse motion applied by update() and not yet taken.
+   */
+  double pendingMotionX;
+  double pendingMotionY;
+
+  /**
+   * Time of the oldest motion event in the pending motion, or a negative value when there is none.
+   */
+  double pendingMotionTime;
+
+  /**
+   * Event counts.
+   */
+  InputStats stats;
+
+  /**
+   * Number of events lost because the queue was full; written by the callbacks.
+   */
+  std::atomic<uint64_t> droppedEvents;
+};
+
+#endif
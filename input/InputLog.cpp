@@ -0,0 +1,139 @@
+/**
+ * @file InputLog.cpp
+ * @brief Implements the InputLog class, which records the input of every frame so that a session can be replayed.
+ */
+
+#include "InputLog.h"
+#include <fstream>
+#include <iostream>
+
+namespace {
+  /**
+   * Identifies input logs.
+   */
+  const uint32_t logMagic = 0x4c494b52;  // "RKIL"
+
+  /**
+   * Version of the record layout, changed whenever it does.
+   */
+  const uint32_t logVersion = 1;
+
+  /**
+   * Bits of the flags byte starting each frame record.
+   */
+  enum FrameFlags : uint8_t {
+    Forward = 1 << 0,
+    Backward = 1 << 1,
+    Left = 1 << 2,
+    Right = 1 << 3,
+    MouseMoved = 1 << 4,
+    DeltaTimeChanged = 1 << 5
+  };
+
+  /**
+   * @brief Appends the bytes of a value to a buffer.
+   */
+  template <typename T>
+  void put(std::vector<char>& buffer, const T& value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+  }
+
+  /**
+   * @brief Reads a value from a file.
+   * @return false if the file ended first.
+   */
+  template <typename T>
+  bool get(std::ifstream& file, T& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+  }
+}
+
+void InputLog::append(const FrameInput& frame) {
+  frames.push_back(frame);
+}
+
+size_t InputLog::getFrameCount() const {
+  return frames.size();
+}
+
+const FrameInput& InputLog::getFrame(size_t index) const {
+  return frames[index];
+}
+
+bool InputLog::save(const std::string& path) const {
+  // Encode the whole log first; it is written once, when recording ends
+  std::vector<char> buffer;
+  put(buffer, logMagic);
+  put(buffer, logVersion);
+
+  double previousDeltaTime = 0;
+  for (const FrameInput& frame : frames) {
+    uint8_t flags = (frame.forward ? Forward : 0) | (frame.backward ? Backward : 0) | (frame.left ? Left : 0)
+                  | (frame.right ? Right : 0) | (frame.mouseMoved ? MouseMoved : 0)
+                  | (frame.deltaTime != previousDeltaTime ? DeltaTimeChanged : 0);
+    put(buffer, flags);
+    if (flags & DeltaTimeChanged) {
+      put(buffer, frame.deltaTime);
+      previousDeltaTime = frame.deltaTime;
+    }
+    if (flags & MouseMoved) {
+      put(buffer, frame.mouseDeltaX);
+      put(buffer, frame.mouseDeltaY);
+    }
+  }
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file.is_open() || !file.write(buffer.data(), buffer.size())) {
+    std::cerr << "Failed to write input log " << path << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool InputLog::load(const std::string& path) {
+  frames.clear();
+
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    std::cerr << "Failed to open input log " << path << std::endl;
+    return false;
+  }
+
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  if (!get(file, magic) || !get(file, version) || magic != logMagic || version != logVersion) {
+    std::cerr << "Not an input log of this version: " << path << std::endl;
+    return false;
+  }
+
+  // Only the end of the file may stop the records, never the middle of one
+  double deltaTime = 0;
+  bool truncated = false;
+  uint8_t flags;
+  while (get(file, flags)) {
+    FrameInput frame;
+    if ((flags & DeltaTimeChanged) && !get(file, deltaTime)) {
+      truncated = true;
+      break;
+    }
+    frame.deltaTime = deltaTime;
+    frame.forward = flags & Forward;
+    frame.backward = flags & Backward;
+    frame.left = flags & Left;
+    frame.right = flags & Right;
+    frame.mouseMoved = flags & MouseMoved;
+    if (frame.mouseMoved && (!get(file, frame.mouseDeltaX) || !get(file, frame.mouseDeltaY))) {
+      truncated = true;
+      break;
+    }
+    frames.push_back(frame);
+  }
+
+  if (truncated || !file.eof()) {
+    std::cerr << "Input log " << path << " is truncated" << std::endl;
+    frames.clear();
+    return false;
+  }
+  return true;
+}
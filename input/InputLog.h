@@ -0,0 +1,90 @@
+/**
+ * @file InputLog.h
+ * @brief Declares the InputLog class, which records the input of every frame so that a session can be replayed.
+ */
+
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct FrameInput
+ * @brief Everything the game took from the player and the clock in one frame.
+ */
+struct FrameInput {
+  /**
+   * Time the simulation advanced by during the frame, in seconds.
+   */
+  double deltaTime = 0;
+
+  /**
+   * Movement keys held during the frame.
+   */
+  bool forward = false;
+  bool backward = false;
+  bool left = false;
+  bool right = false;
+
+  /**
+   * Whether the camera was turned by mouse motion during the frame, and by how much.
+   */
+  bool mouseMoved = false;
+  double mouseDeltaX = 0;
+  double mouseDeltaY = 0;
+};
+
+/**
+ * @class InputLog
+ * @brief A sequence of FrameInput, stored in a compact binary file.
+ *
+ * The file starts with the magic bytes "RKIL" and a 32-bit format version, followed by one record per frame: a flags
+ * byte holding the four movement keys, whether the mouse moved and whether the frame time changed, then the frame
+ * time as a double only when it differs from the previous frame, then the mouse motion as two doubles only when the
+ * mouse moved. Frames paced to a steady rate without touching the mouse thus take a single byte. Values are stored
+ * in the byte order of the machine, so a log is only replayed where it was recorded or on a machine of the same
+ * endianness.
+ *
+ * Doubles are stored exactly, so replaying the same log advances the simulation through the same steps bit for bit.
+ */
+class InputLog {
+public:
+  /**
+   * @brief Appends the input of a frame.
+   */
+  void append(const FrameInput& frame);
+
+  /**
+   * @brief Get the number of frames in the log.
+   */
+  size_t getFrameCount() const;
+
+  /**
+   * @brief Get the input of a frame.
+   * @param index Index of the frame, less than getFrameCount().
+   */
+  const FrameInput& getFrame(size_t index) const;
+
+  /**
+   * @brief Writes the log to a file, replacing it.
+   * @return true on success.
+   */
+  bool save(const std::string& path) const;
+
+  /**
+   * @brief Replaces the frames of the log with those read from a file.
+   * @return true on success. On failure the log is left empty.
+   */
+  bool load(const std::string& path);
+
+private:
+  /**
+   * Recorded frames, in order.
+   */
+  std::vector<FrameInput> frames;
+};
+
+#endif
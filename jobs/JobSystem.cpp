@@ -0,0 +1,208 @@
+/**
+ * @file JobSystem.cpp
+ * @brief Implements the JobSystem class, a work-stealing scheduler for short jobs fanned out within a frame.
+ */
+
+#include "JobSystem.h"
+#include <algorithm>
+
+namespace {
+  /**
+   * The system the calling thread runs jobs for, or nullptr on threads outside any system.
+   */
+  thread_local const JobSystem* currentSystem = nullptr;
+
+  /**
+   * Index of the calling thread's deque in currentSystem.
+   */
+  thread_local size_t currentIndex = 0;
+}
+
+JobSystem::JobSystem(int threadCount)
+  : queuedJobs(0),
+    stealCount(0),
+    stopping(false) {
+  if (threadCount <= 0) {
+    threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+
+  for (int i = 0; i < threadCount; ++i) {
+    queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+  }
+
+  currentSystem = this;
+  currentIndex = 0;
+  for (int i = 1; i < threadCount; ++i) {
+    workers.emplace_back(&JobSystem::worker, this, static_cast<size_t>(i));
+  }
+}
+
+JobSystem::~JobSystem() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    stopping = true;
+  }
+  jobAvailable.notify_all();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  if (currentSystem == this) {
+    currentSystem = nullptr;
+  }
+}
+
+size_t JobSystem::currentThreadIndex() const {
+  return currentSystem == this ? currentIndex : 0;
+}
+
+void JobSystem::run(std::function<void()> job, JobCounter* counter) {
+  if (counter) {
+    counter -> pending.fetch_add(1, std::memory_order_relaxed);
+  }
+  push({ std::move(job), counter });
+}
+
+void JobSystem::runAfter(JobCounter& dependency, std::function<void()> job, JobCounter* counter) {
+  if (counter) {
+    counter -> pending.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // The last job of the dependency queues the continuations under the same lock, so exactly one side runs the job
+  {
+    std::lock_guard<std::mutex> lock(dependency.mutex);
+    if (!dependency.isDone()) {
+      dependency.continuations.emplace_back(std::move(job), counter);
+      return;
+    }
+  }
+  push({ std::move(job), counter });
+}
+
+void JobSystem::push(Job job) {
+  WorkerQueue& queue = *queues[currentThreadIndex()];
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.jobs.push_back(std::move(job));
+  }
+  queuedJobs.fetch_add(1, std::memory_order_release);
+
+  // Taking the lock orders the wake-up after a worker that is about to sleep has checked for jobs
+  if (!workers.empty()) {
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    jobAvailable.notify_one();
+  }
+}
+
+bool JobSystem::take(size_t threadIndex, Job& job) {
+  if (queuedJobs.load(std::memory_order_acquire) == 0) {
+    return false;
+  }
+
+  // Newest job of our own first, while its data is still in this core's cache
+  {
+    WorkerQueue& own = *queues[threadIndex];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.jobs.empty()) {
+      job = std::move(own.jobs.back());
+      own.jobs.pop_back();
+      queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+
+  // Otherwise the oldest job of another thread, starting with the next one so thieves spread out
+  for (size_t offset = 1; offset < queues.size(); ++offset) {
+    WorkerQueue& victim = *queues[(threadIndex + offset) % queues.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.jobs.empty()) {
+      job = std::move(victim.jobs.front());
+      victim.jobs.pop_front();
+      queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+      stealCount.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+void JobSystem::execute(Job& job) {
+  job.work();
+
+  JobCounter* counter = job.counter;
+  if (!counter) {
+    return;
+  }
+
+  std::vector<std::pair<std::function<void()>, JobCounter*>> continuations;
+  {
+    std::lock_guard<std::mutex> lock(counter -> mutex);
+    if (counter -> pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      continuations.swap(counter -> continuations);
+    }
+  }
+  for (auto& continuation : continuations) {
+    push({ std::move(continuation.first), continuation.second });
+  }
+}
+
+void JobSystem::wait(JobCounter& counter) {
+  size_t threadIndex = currentThreadIndex();
+  while (!counter.isDone()) {
+    Job job;
+    if (take(threadIndex, job)) {
+      execute(job);
+    } else {
+      // The remaining jobs are running on other threads
+      std::this_thread::yield();
+    }
+  }
+
+  // The last job drops the counter to zero while holding its lock; take it once, so the counter is no longer in use
+  // when the caller destroys it
+  std::lock_guard<std::mutex> lock(counter.mutex);
+}
+
+void JobSystem::parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body) {
+  grainSize = std::max<size_t>(grainSize, 1);
+  if (count <= grainSize) {
+    body(0, count);
+    return;
+  }
+
+  JobCounter counter;
+  for (size_t begin = 0; begin < count; begin += grainSize) {
+    size_t end = std::min(count, begin + grainSize);
+    run([&body, begin, end]() { body(begin, end); }, &counter);
+  }
+  wait(counter);
+}
+
+void JobSystem::worker(size_t threadIndex) {
+  currentSystem = this;
+  currentIndex = threadIndex;
+
+  while (true) {
+    Job job;
+    if (take(threadIndex, job)) {
+      execute(job);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    jobAvailable.wait(lock, [this] {
+      return stopping.load() || queuedJobs.load(std::memory_order_acquire) > 0;
+    });
+    if (stopping) {
+      return;
+    }
+  }
+}
+
+size_t JobSystem::getThreadCount() const {
+  return queues.size();
+}
+
+size_t JobSystem::getStealCount() const {
+  return stealCount.load(std::memory_order_relaxed);
+}
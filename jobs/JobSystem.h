@@ -0,0 +1,204 @@
+/**
+ * @file JobSystem.h
+ * @brief Declares the JobSystem class, a work-stealing scheduler for short jobs fanned out within a frame.
+ */
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+
+/**
+ * @class JobCounter
+ * @brief Counts the unfinished jobs of a group, so that other work can wait for or follow the whole group.
+ *
+ * Each job started with a counter increments it and decrements it when done. JobSystem::wait() returns once the
+ * counter is back at zero, and jobs started with JobSystem::runAfter() are held until then. A counter may only be
+ * destroyed after waiting for it.
+ */
+class JobCounter {
+public:
+  /**
+   * @brief Checks whether every job counted so far has finished.
+   */
+  bool isDone() const {
+    return pending.load(std::memory_order_acquire) == 0;
+  }
+
+private:
+  friend class JobSystem;
+
+  /**
+   * Number of unfinished jobs.
+   */
+  std::atomic<int> pending { 0 };
+
+  /**
+   * Guards continuations, and the transition of pending to zero against runAfter().
+   */
+  std::mutex mutex;
+
+  /**
+   * Jobs started by runAfter(), queued once pending reaches zero, with the counters they signal.
+   */
+  std::vector<std::pair<std::function<void()>, JobCounter*>> continuations;
+};
+
+/**
+ * @class JobSystem
+ * @brief Runs jobs on every core: one worker thread per extra core, plus the main thread whenever it waits.
+ *
+ * Every thread has its own deque of jobs. A thread pushes the jobs it starts onto the back of its own deque and takes
+ * work from the back too, so related jobs stay on the core whose cache holds their data. A thread whose deque is empty
+ * steals from the front of another's, where the oldest and usually largest pieces of work sit, so the load balances
+ * without a central queue every thread contends on. Idle workers sleep until jobs are queued.
+ *
+ * Jobs are meant to be short, a fraction of a frame: a thread waiting for a counter runs other jobs meanwhile, so a
+ * long job picked up by the main thread delays the frame. Long running background work such as file loading belongs
+ * on a ThreadPool instead.
+ */
+class JobSystem {
+public:
+  /**
+   * @brief Starts the worker threads.
+   * @param threadCount Total number of threads running jobs, including the calling thread, or 0 to use one per
+   * hardware thread. 1 runs every job on the calling thread when it waits.
+   *
+   * The constructing thread becomes the system's main thread. Other threads outside the system, such as the render
+   * thread, may call wait() and parallelFor() too; they share the main thread's deque.
+   */
+  explicit JobSystem(int threadCount = 0);
+
+  /**
+   * @brief Stops the worker threads. Every started job must have been waited for.
+   */
+  ~JobSystem();
+
+  /**
+   * @brief Starts a job.
+   * @param job Work to run on any thread.
+   * @param counter Counter incremented now and decremented when the job is done, or nullptr.
+   */
+  void run(std::function<void()> job, JobCounter* counter = nullptr);
+
+  /**
+   * @brief Starts a job once every job counted by a dependency has finished.
+   * @param dependency Counter of the jobs that must finish first.
+   * @param job Work to run on any thread.
+   * @param counter Counter incremented now and decremented when the job is done, or nullptr.
+   */
+  void runAfter(JobCounter& dependency, std::function<void()> job, JobCounter* counter = nullptr);
+
+  /**
+   * @brief Runs jobs until every job counted by the counter has finished.
+   */
+  void wait(JobCounter& counter);
+
+  /**
+   * @brief Runs body over [0, count) split into ranges of grainSize items, on all threads, and waits for them.
+   * @param count Number of items.
+   * @param grainSize Number of items per job; large enough that a job takes a few microseconds at least.
+   * @param body Called with the begin and end of each range.
+   */
+  void parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body);
+
+  /**
+   * @brief Get the total number of threads running jobs, including the main thread.
+   */
+  size_t getThreadCount() const;
+
+  /**
+   * @brief Get the number of jobs taken from another thread's deque since the system started.
+   */
+  size_t getStealCount() const;
+
+private:
+  /**
+   * A job with the counter it signals.
+   */
+  struct Job {
+    std::function<void()> work;
+    JobCounter* counter;
+  };
+
+  /**
+   * The job deque of one thread. The owner pushes and pops at the back, thieves steal from the front.
+   */
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+
+  /**
+   * @brief Queues a job on the calling thread's deque, or the main thread's for threads outside the system.
+   */
+  void push(Job job);
+
+  /**
+   * @brief Takes a job from the calling thread's own deque, or steals one from another thread.
+   * @return true if a job was found.
+   */
+  bool take(size_t threadIndex, Job& job);
+
+  /**
+   * @brief Runs a job and signals its counter, queueing the counter's continuations when it reaches zero.
+   */
+  void execute(Job& job);
+
+  /**
+   * @brief Body of each worker thread: runs jobs until the system is destroyed, sleeping while there are none.
+   */
+  void worker(size_t threadIndex);
+
+  /**
+   * @brief Returns the index of the calling thread's deque, or 0 for threads outside the system.
+   */
+  size_t currentThreadIndex() const;
+
+  /**
+   * One deque per thread; index 0 belongs to the main thread.
+   */
+  std::vector<std::unique_ptr<WorkerQueue>> queues;
+
+  /**
+   * Worker threads, running deques 1 and up.
+   */
+  std::vector<std::thread> workers;
+
+  /**
+   * Number of jobs sitting in any deque.
+   */
+  std::atomic<size_t> queuedJobs;
+
+  /**
+   * Number of jobs stolen from another thread's deque.
+   */
+  std::atomic<size_t> stealCount;
+
+  /**
+   * Guards sleeping workers against missing a wake-up.
+   */
+  std::mutex sleepMutex;
+
+  /**
+   * Wakes sleeping workers when jobs are queued or the system is destroyed.
+   */
+  std::condition_variable jobAvailable;
+
+  /**
+   * Set when the system is destroyed, telling the workers to exit.
+   */
+  std::atomic<bool> stopping;
+};
+
+#endif
@@ -0,0 +1,63 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief Implements the ThreadPool class, which runs tasks on a fixed set of worker threads.
+ */
+
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int workerCount)
+  : stopping(false) {
+  if (workerCount <= 0) {
+    workerCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+  }
+
+  for (int i = 0; i < workerCount; ++i) {
+    workers.emplace_back(&ThreadPool::worker, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  taskAvailable.notify_all();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks.push_back(std::move(task));
+  }
+  taskAvailable.notify_one();
+}
+
+size_t ThreadPool::getQueueDepth() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return tasks.size();
+}
+
+size_t ThreadPool::getWorkerCount() const {
+  return workers.size();
+}
+
+void ThreadPool::worker() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      taskAvailable.wait(lock, [this] { return stopping || !tasks.empty(); });
+      if (stopping) {
+        return;
+      }
+      task = std::move(tasks.front());
+      tasks.pop_front();
+    }
+
+    task();
+  }
+}
@@ -0,0 +1,83 @@
+/**
+ * @file ThreadPool.h
+ * @brief Declares the ThreadPool class, which runs tasks on a fixed set of worker threads.
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief A fixed set of worker threads running submitted tasks in submission order.
+ *
+ * Tasks must not touch OpenGL, whose context belongs to the main thread; they hand their results back to it instead.
+ */
+class ThreadPool {
+public:
+  /**
+   * @brief Starts the worker threads.
+   * @param workerCount Number of worker threads, or 0 to use one less than the number of hardware threads.
+   */
+  explicit ThreadPool(int workerCount = 0);
+
+  /**
+   * @brief Waits for the running tasks to finish and stops the worker threads. Tasks not started yet are discarded.
+   */
+  ~ThreadPool();
+
+  /**
+   * @brief Queues a task to run on the next free worker thread.
+   */
+  void submit(std::function<void()> task);
+
+  /**
+   * @brief Get the number of tasks queued but not started yet.
+   */
+  size_t getQueueDepth() const;
+
+  /**
+   * @brief Get the number of worker threads.
+   */
+  size_t getWorkerCount() const;
+
+private:
+  /**
+   * @brief Body of each worker thread: runs queued tasks until the pool is destroyed.
+   */
+  void worker();
+
+  /**
+   * Worker threads.
+   */
+  std::vector<std::thread> workers;
+
+  /**
+   * Tasks waiting for a worker, guarded by mutex.
+   */
+  std::deque<std::function<void()>> tasks;
+
+  /**
+   * Guards tasks and stopping.
+   */
+  mutable std::mutex mutex;
+
+  /**
+   * Wakes the workers when tasks are queued or the pool is destroyed.
+   */
+  std::condition_variable taskAvailable;
+
+  /**
+   * Set when the pool is destroyed, telling the workers to exit.
+   */
+  bool stopping;
+};
+
+#endif
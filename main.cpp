@@ -1,7 +1,13 @@
 #include "game/Game.h"
+#include "game/GameOptions.h"
 
-int main() {
-  Game game(800, 600, "RetroKanto");
+int main(int argc, char** argv) {
+  GameOptions options;
+  if (!GameOptions::parse(argc, argv, options)) {
+    return -1;
+  }
+
+  Game game(800, 600, "RetroKanto", options);
   int returnCode = game.run();
   return returnCode;
-}
\ No newline at end of file
+}
@@ -4,56 +4,199 @@
  */
 
 #include "Mesh.h"
+#include "../gl/GLApi.h"
+#include "../gl/GLState.h"
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+  /**
+   * Refers to one vertex inside the source data, so vertices of any layout can be used as hash map keys.
+   */
+  struct VertexKey {
+    const unsigned char* bytes;
+  };
+
+  /**
+   * Hashes the raw bytes of a vertex (FNV-1a), so that only bit-identical vertices are merged.
+   */
+  struct VertexHash {
+    size_t stride;
+
+    size_t operator()(const VertexKey& key) const {
+      uint64_t hash = 14695981039346656037ull;
+      for (size_t i = 0; i < stride; ++i) {
+        hash = (hash ^ key.bytes[i]) * 1099511628211ull;
+      }
+      return static_cast<size_t>(hash);
+    }
+  };
+
+  struct VertexEqual {
+    size_t stride;
+
+    bool operator()(const VertexKey& a, const VertexKey& b) const {
+      return std::memcmp(a.bytes, b.bytes, stride) == 0;
+    }
+  };
+}
 
 Mesh::Mesh(const float* vertices, const float* colors, size_t size) {
-  // Create a new Vertex Array Object (VAO) and assign it a unique ID, which is stored in the referenced variable 
-  glGenVertexArrays(1, &vertexArrayObjectId);
+  uploadColorVertices(vertices, colors, size, nullptr, 0);
+}
+
+Mesh::Mesh(const float* vertices, const float* colors, size_t size, const GLuint* indices, size_t indexCount) {
+  uploadColorVertices(vertices, colors, size, indices, indexCount);
+}
+
+void Mesh::uploadColorVertices(const float* vertices, const float* colors, size_t size, const GLuint* indices, size_t sourceIndexCount) {
+  size_t sourceVertexCount = size / sizeof(float) / 3;
+
+  std::vector<ColorVertex> colorVertices(sourceVertexCount);
+  for (size_t i = 0; i < sourceVertexCount; ++i) {
+    std::memcpy(colorVertices[i].position, vertices + i * 3, sizeof(colorVertices[i].position));
+    std::memcpy(colorVertices[i].color, colors + i * 3, sizeof(colorVertices[i].color));
+  }
+
+  upload(colorVertices.data(), sourceVertexCount, sizeof(ColorVertex), indices, sourceIndexCount, &expandVertex<ColorVertex>);
+  ColorVertex::Format::enableAttributes();
+  unbind();
+}
+
+void Mesh::upload(const void* vertices, size_t sourceVertexCount, size_t stride, const GLuint* indices, size_t sourceIndexCount,
+                  ColorVertex (*expand)(const void*)) {
+  const unsigned char* sourceBytes = static_cast<const unsigned char*>(vertices);
+
+  // Merge identical vertices, mapping every source vertex to the index of its first occurrence
+  std::vector<unsigned char> uniqueVertices;
+  std::vector<GLuint> remap(sourceVertexCount);
+  std::unordered_map<VertexKey, GLuint, VertexHash, VertexEqual> vertexIndices(
+    sourceVertexCount, VertexHash{ stride }, VertexEqual{ stride });
+  uniqueVertices.reserve(sourceVertexCount * stride);
+
+  for (size_t i = 0; i < sourceVertexCount; ++i) {
+    const unsigned char* vertex = sourceBytes + i * stride;
+
+    auto inserted = vertexIndices.emplace(VertexKey{ vertex }, static_cast<GLuint>(uniqueVertices.size() / stride));
+    if (inserted.second) {
+      uniqueVertices.insert(uniqueVertices.end(), vertex, vertex + stride);
+    }
+    remap[i] = inserted.first -> second;
+  }
+
+  // Without an index buffer every source vertex is used once, in order
+  std::vector<GLuint> meshIndices;
+  if (indices) {
+    meshIndices.reserve(sourceIndexCount);
+    for (size_t i = 0; i < sourceIndexCount; ++i) {
+      meshIndices.push_back(remap[indices[i]]);
+    }
+  } else {
+    meshIndices = remap;
+  }
+
+  vertexCount = static_cast<int>(uniqueVertices.size() / stride);
+  indexCount = static_cast<int>(meshIndices.size());
+
+  if (expand) {
+    cpuVertices.reserve(vertexCount);
+    for (size_t offset = 0; offset < uniqueVertices.size(); offset += stride) {
+      cpuVertices.push_back(expand(uniqueVertices.data() + offset));
+    }
+    cpuIndices = meshIndices;
+  }
+
+  // Create a new Vertex Array Object (VAO) and assign it a unique ID, which is stored in the referenced variable
+  GL::GenVertexArrays(1, &vertexArrayObjectId);
 
   // Bind the VAO, making it the active VAO
-  glBindVertexArray(vertexArrayObjectId);
+  GLState::bindVertexArray(vertexArrayObjectId);
 
   // Create a new Vertex Buffer Object (VBO) and assign it a unique ID, which is stored in the referenced variable
-  glGenBuffers(1, &vertexBufferObjectId);
+  GL::GenBuffers(1, &vertexBufferObjectId);
 
   // Bind the VBO to the GL_ARRAY_BUFFER target, which is the buffer type used for vertex data
-  glBindBuffer(GL_ARRAY_BUFFER, vertexBufferObjectId);
+  GLState::bindBuffer(GL_ARRAY_BUFFER, vertexBufferObjectId);
 
-  // Upload the vertex data to the bound GL_ARRAY_BUFFER
-  glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+  // Upload the interleaved vertex data to the bound GL_ARRAY_BUFFER
+  GL::BufferData(GL_ARRAY_BUFFER, uniqueVertices.size(), uniqueVertices.data(), GL_STATIC_DRAW);
 
-  // Enable the vertex attribute at location 0 (typically the first attribute) in the shader. 
-  glEnableVertexAttribArray(0);
+  // Set up the Element Buffer Object (EBO). Its binding is recorded in the VAO, so it stays attached to the mesh
+  GL::GenBuffers(1, &indexBufferObjectId);
+  GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferObjectId);
 
-  // Define how OpenGL should interpret the vertex data in the bound VBO for the specified attribute location
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
-
-  // Set up color buffer object mirroring position VBO above
-  glGenBuffers(1, &colorBufferObjectId);
-  glBindBuffer(GL_ARRAY_BUFFER, colorBufferObjectId);
-  glBufferData(GL_ARRAY_BUFFER, size, colors, GL_STATIC_DRAW);
-  glEnableVertexAttribArray(1);
-  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
-
-  vertexCount = size / sizeof(float) / 3;
+  if (vertexCount <= 65536) {
+    std::vector<GLushort> shortIndices(meshIndices.begin(), meshIndices.end());
+    GL::BufferData(GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(GLushort), shortIndices.data(), GL_STATIC_DRAW);
+    indexType = GL_UNSIGNED_SHORT;
+  } else {
+    GL::BufferData(GL_ELEMENT_ARRAY_BUFFER, meshIndices.size() * sizeof(GLuint), meshIndices.data(), GL_STATIC_DRAW);
+    indexType = GL_UNSIGNED_INT;
+  }
 }
 
 Mesh::~Mesh() {
-  glDeleteBuffers(1, &vertexBufferObjectId);
-  glDeleteBuffers(1, &colorBufferObjectId);
-  glDeleteVertexArrays(1, &vertexArrayObjectId);
+  GLState::deleteBuffer(vertexBufferObjectId);
+  GLState::deleteBuffer(indexBufferObjectId);
+  GLState::deleteVertexArray(vertexArrayObjectId);
 }
 
 void Mesh::bind() {
-  glBindVertexArray(vertexArrayObjectId);
+  GLState::bindVertexArray(vertexArrayObjectId);
 }
 
 void Mesh::unbind() {
   // In OpenGL, the ID 0 is a special reserved value, meaning "no object" or "unbound."
-  glBindVertexArray(0);
+  GLState::bindVertexArray(0);
 }
 
 void Mesh::draw() {
+  // The VAO stays bound, so drawing the same mesh again skips the bind
   bind();
-  glDrawArrays(GL_TRIANGLES, 0, vertexCount);
-  unbind();
-}
\ No newline at end of file
+  drawBound();
+}
+
+void Mesh::drawBound() {
+  GL::DrawElements(GL_TRIANGLES, indexCount, indexType, (void*)0);
+}
+
+void Mesh::drawInstanced(GLuint instanceBufferId, GLsizei instanceCount, size_t instanceOffset) {
+  bind();
+
+  // A mat4 attribute occupies four consecutive locations, one vec4 column each, advancing once per instance
+  GLState::bindBuffer(GL_ARRAY_BUFFER, instanceBufferId);
+  for (GLuint column = 0; column < 4; ++column) {
+    GLuint location = instanceMatrixLocation + column;
+    GL::EnableVertexAttribArray(location);
+    GL::VertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, 16 * sizeof(float), (void*)(instanceOffset + column * 4 * sizeof(float)));
+    GL::VertexAttribDivisor(location, 1);
+  }
+
+  GL::DrawElementsInstanced(GL_TRIANGLES, indexCount, indexType, (void*)0, instanceCount);
+
+  for (GLuint column = 0; column < 4; ++column) {
+    GL::DisableVertexAttribArray(instanceMatrixLocation + column);
+  }
+}
+
+GLuint Mesh::getVertexArrayId() const {
+  return vertexArrayObjectId;
+}
+
+int Mesh::getVertexCount() const {
+  return vertexCount;
+}
+
+int Mesh::getIndexCount() const {
+  return indexCount;
+}
+
+const std::vector<ColorVertex>& Mesh::getCpuVertices() const {
+  return cpuVertices;
+}
+
+const std::vector<GLuint>& Mesh::getCpuIndices() const {
+  return cpuIndices;
+}
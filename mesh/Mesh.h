@@ -7,23 +7,66 @@
 #define MESH_H
 
 #include <GL/glew.h>
+#include <cstddef>
+#include <vector>
+#include "VertexFormat.h"
 
 /**
  * @class Mesh
- * @brief Represents a basic mesh object that encapsulates Vertex Array Object (VAO), Vertex Buffer Object (VBO), and Color Buffer Object (CBO).
+ * @brief Represents a basic mesh object that encapsulates Vertex Array Object (VAO), Vertex Buffer Object (VBO), and Element Buffer Object (EBO).
  *
- * The Mesh class handles VAO, VBO, and CBO setup and binding.
+ * The Mesh class handles VAO, VBO, and EBO setup and binding. Vertex attributes are stored interleaved in a single
+ * VBO so the GPU fetches each vertex from one contiguous stream, and identical vertices are merged at construction
+ * so that each one is stored and shaded only once, with the EBO describing the triangles. The attribute layout comes
+ * from the vertex type's compile-time VertexFormat, which allows compact formats such as PackedVertex.
+ *
+ * Meshes can also keep their merged vertices and indices in memory, expanded to ColorVertex, so that the
+ * SoftwareRenderer can draw them without reading anything back from the GPU.
  */
 class Mesh {
 public:
   /**
-   * @brief Constructs a Mesh object with given vertices.
-   * @param vertices Pointer to the vertex data array.
+   * @brief Constructs a Mesh object with given vertices, building the index buffer by merging identical vertices.
+   * @param vertices Pointer to the vertex data array, three floats per vertex, three vertices per triangle.
    * @param colors Pointer to the color data array.
    * @param size Size of the vertex (and color) data array in bytes.
    */
   Mesh(const float* vertices, const float* colors, size_t size);
 
+  /**
+   * @brief Constructs a Mesh object with given vertices and an index buffer describing its triangles.
+   * @param vertices Pointer to the vertex data array, three floats per vertex.
+   * @param colors Pointer to the color data array.
+   * @param size Size of the vertex (and color) data array in bytes.
+   * @param indices Pointer to the index array, three indices per triangle.
+   * @param indexCount Number of indices in the index array.
+   *
+   * Identical vertices are still merged, with the indices remapped accordingly.
+   */
+  Mesh(const float* vertices, const float* colors, size_t size, const GLuint* indices, size_t indexCount);
+
+  /**
+   * @brief Constructs a Mesh object from interleaved vertices of any type with a VertexFormat.
+   * @tparam Vertex Vertex type providing a nested Format typedef, e.g. ColorVertex or PackedVertex.
+   * @param vertices Pointer to the vertex array.
+   * @param vertexCount Number of vertices in the vertex array.
+   * @param indices Pointer to the index array, three indices per triangle, or nullptr if every three consecutive
+   * vertices form a triangle.
+   * @param indexCount Number of indices in the index array.
+   * @param keepCpuCopy Whether to also keep the merged vertices and indices in memory, for getCpuVertices().
+   *
+   * Identical vertices are merged, with the indices remapped accordingly.
+   */
+  template <typename Vertex>
+  Mesh(const Vertex* vertices, size_t vertexCount, const GLuint* indices = nullptr, size_t indexCount = 0,
+       bool keepCpuCopy = false) {
+    static_assert(sizeof(Vertex) == Vertex::Format::stride, "Vertex type does not match its format");
+
+    upload(vertices, vertexCount, sizeof(Vertex), indices, indexCount, keepCpuCopy ? &expandVertex<Vertex> : nullptr);
+    Vertex::Format::enableAttributes();
+    unbind();
+  }
+
   /**
    * @brief Destructor to clean up allocated OpenGL resources.
    */
@@ -35,16 +78,93 @@ public:
   void bind();
 
   /**
-   * @brief Unbinds any VAO, restoring the previous state.
+   * @brief Unbinds any VAO, so that later buffer binds cannot change the mesh's index buffer.
    */
   void unbind();
 
   /**
-   * @brief Draws the mesh using stored VAO, VBO, and CBO configurations.
+   * @brief Draws the mesh using stored VAO, VBO, and EBO configurations, leaving its VAO bound.
    */
   void draw();
 
+  /**
+   * @brief Draws the mesh, assuming its VAO is already bound.
+   *
+   * Lets a caller drawing the same mesh several times in a row bind it once.
+   */
+  void drawBound();
+
+  /**
+   * @brief Draws many copies of the mesh in a single draw call.
+   * @param instanceBufferId Buffer holding one model matrix (a column-major mat4) per instance.
+   * @param instanceCount Number of instances to draw.
+   * @param instanceOffset Offset of the first matrix within the instance buffer in bytes.
+   *
+   * The instance buffer is attached to the per-instance attribute locations only for the duration of the call, so
+   * regular draw() calls keep seeing the constant value of those attributes.
+   */
+  void drawInstanced(GLuint instanceBufferId, GLsizei instanceCount, size_t instanceOffset = 0);
+
+  /**
+   * @brief Get the ID of the mesh's Vertex Array Object.
+   */
+  GLuint getVertexArrayId() const;
+
+  /**
+   * @brief Get the number of unique vertices stored in the VBO.
+   */
+  int getVertexCount() const;
+
+  /**
+   * @brief Get the number of indices drawn, three per triangle.
+   */
+  int getIndexCount() const;
+
+  /**
+   * @brief Get the merged vertices kept in memory at full precision, or an empty array if the mesh was constructed
+   * without keeping them.
+   */
+  const std::vector<ColorVertex>& getCpuVertices() const;
+
+  /**
+   * @brief Get the indices into getCpuVertices(), three per triangle, or an empty array if no vertices were kept.
+   */
+  const std::vector<GLuint>& getCpuIndices() const;
+
+  /**
+   * First of the four consecutive attribute locations holding the per-instance model matrix, one column each.
+   */
+  static const GLuint instanceMatrixLocation = 4;
+
 private:
+  /**
+   * @brief Converts separate float position and color arrays into ColorVertex data and uploads it.
+   */
+  void uploadColorVertices(const float* vertices, const float* colors, size_t size, const GLuint* indices, size_t sourceIndexCount);
+
+  /**
+   * @brief Merges identical vertices and uploads vertices and indices to the GPU, leaving the VAO and VBO bound.
+   * @param vertices Pointer to the interleaved vertex data.
+   * @param sourceVertexCount Number of vertices in the vertex data.
+   * @param stride Size of one vertex in bytes.
+   * @param indices Pointer to the index array, or nullptr if every three consecutive vertices form a triangle.
+   * @param sourceIndexCount Number of indices in the index array; ignored when indices is nullptr.
+   * @param expand Function converting one vertex to ColorVertex, to also keep the merged vertices and indices in
+   * memory, or nullptr.
+   *
+   * The caller describes the vertex attributes afterwards and then unbinds the VAO.
+   */
+  void upload(const void* vertices, size_t sourceVertexCount, size_t stride, const GLuint* indices, size_t sourceIndexCount,
+              ColorVertex (*expand)(const void*));
+
+  /**
+   * @brief Expands a vertex of the given type, passed as raw bytes, to ColorVertex.
+   */
+  template <typename Vertex>
+  static ColorVertex expandVertex(const void* vertex) {
+    return unpackVertex(*static_cast<const Vertex*>(vertex));
+  }
+
   /**
    * Vertex Array Object ID.
    *
@@ -57,25 +177,40 @@ private:
   /**
    * Vertex Buffer Object ID.
    *
-   * Stores vertex position data on the GPU,
+   * Stores the interleaved attributes of each unique vertex on the GPU,
    * allowing for efficient rendering by minimizing data
    * transfer between the CPU and GPU.
    */
   GLuint vertexBufferObjectId;
 
   /**
-   * Color Buffer Object ID.
+   * Element Buffer Object ID.
    *
-   * Stores the color data for each vertex on the GPU,
-   * allowing for efficient rendering by minimizing data
-   * transfer between the CPU and GPU.
+   * Stores the indices into the VBO that make up each triangle, so shared
+   * vertices are stored and transformed only once.
    */
-  GLuint colorBufferObjectId;
+  GLuint indexBufferObjectId;
 
   /**
-   * The number of vertices passed to the Mesh class.
+   * The number of unique vertices stored in the VBO.
    */
   int vertexCount;
+
+  /**
+   * The number of indices in the EBO.
+   */
+  int indexCount;
+
+  /**
+   * The type of the indices in the EBO; 16-bit whenever the vertex count allows it, halving the index data.
+   */
+  GLenum indexType;
+
+  /**
+   * Copies of the merged vertices and indices for rendering on the CPU, empty unless they were asked for.
+   */
+  std::vector<ColorVertex> cpuVertices;
+  std::vector<GLuint> cpuIndices;
 };
 
-#endif
\ No newline at end of file
+#endif
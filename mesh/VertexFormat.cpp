@@ -0,0 +1,119 @@
+/**
+ * @file VertexFormat.cpp
+ * @brief Implements the attribute packing helpers used to build compact vertices, and their inverses.
+ */
+
+#include "VertexFormat.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+uint16_t packHalf(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+
+  uint32_t sign = (bits >> 16) & 0x8000;
+  uint32_t floatExponent = (bits >> 23) & 0xff;
+  uint32_t mantissa = bits & 0x7fffff;
+  int32_t exponent = static_cast<int32_t>(floatExponent) - 127 + 15;
+
+  // Infinity and NaN keep their class; NaN keeps a mantissa bit so it does not turn into infinity
+  if (floatExponent == 0xff) {
+    return sign | 0x7c00 | (mantissa ? 0x200 : 0);
+  }
+
+  // Too large for a half becomes infinity
+  if (exponent >= 31) {
+    return sign | 0x7c00;
+  }
+
+  // Too small for a normal half becomes a subnormal, or zero once even the subnormals run out
+  if (exponent <= 0) {
+    if (exponent < -10) {
+      return sign;
+    }
+    mantissa |= 0x800000;
+    uint32_t shift = 14 - exponent;
+    uint32_t half = mantissa >> shift;
+    uint32_t remainder = mantissa & ((1u << shift) - 1);
+    uint32_t halfway = 1u << (shift - 1);
+    if (remainder > halfway || (remainder == halfway && (half & 1))) {
+      ++half;
+    }
+    return sign | half;
+  }
+
+  // Round the mantissa to 10 bits; a carry correctly rolls over into the exponent
+  uint32_t half = sign | (exponent << 10) | (mantissa >> 13);
+  uint32_t remainder = mantissa & 0x1fff;
+  if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+    ++half;
+  }
+  return half;
+}
+
+uint8_t packUnorm8(float value) {
+  return static_cast<uint8_t>(std::lround(std::min(std::max(value, 0.0f), 1.0f) * 255.0f));
+}
+
+uint32_t packSnorm1010102(float x, float y, float z, float w) {
+  auto snorm = [](float value, float scale, uint32_t mask) {
+    return static_cast<uint32_t>(std::lround(std::min(std::max(value, -1.0f), 1.0f) * scale)) & mask;
+  };
+
+  return snorm(x, 511.0f, 0x3ff)
+       | snorm(y, 511.0f, 0x3ff) << 10
+       | snorm(z, 511.0f, 0x3ff) << 20
+       | snorm(w, 1.0f, 0x3) << 30;
+}
+
+PackedVertex packVertex(const float* position, const float* color, const float* normal) {
+  PackedVertex vertex;
+  vertex.position[0] = packHalf(position[0]);
+  vertex.position[1] = packHalf(position[1]);
+  vertex.position[2] = packHalf(position[2]);
+  vertex.position[3] = packHalf(1.0f);
+  vertex.color[0] = packUnorm8(color[0]);
+  vertex.color[1] = packUnorm8(color[1]);
+  vertex.color[2] = packUnorm8(color[2]);
+  vertex.color[3] = 255;
+  vertex.normal = normal ? packSnorm1010102(normal[0], normal[1], normal[2]) : 0;
+  return vertex;
+}
+
+float unpackHalf(uint16_t value) {
+  uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+  uint32_t exponent = (value >> 10) & 0x1f;
+  uint32_t mantissa = value & 0x3ff;
+  uint32_t bits;
+
+  if (exponent == 0x1f) {
+    // Infinity and NaN
+    bits = sign | 0x7f800000 | (mantissa << 13);
+  } else if (exponent != 0) {
+    bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+  } else if (mantissa == 0) {
+    bits = sign;
+  } else {
+    // Subnormal halves are normal floats: shift the mantissa up until its leading one becomes implicit
+    int32_t floatExponent = 127 - 14;
+    while (!(mantissa & 0x400)) {
+      mantissa <<= 1;
+      --floatExponent;
+    }
+    bits = sign | (static_cast<uint32_t>(floatExponent) << 23) | ((mantissa & 0x3ff) << 13);
+  }
+
+  float result;
+  std::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+ColorVertex unpackVertex(const PackedVertex& vertex) {
+  ColorVertex result;
+  for (int i = 0; i < 3; ++i) {
+    result.position[i] = unpackHalf(vertex.position[i]);
+    result.color[i] = vertex.color[i] / 255.0f;
+  }
+  return result;
+}
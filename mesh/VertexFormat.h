@@ -0,0 +1,188 @@
+/**
+ * @file VertexFormat.h
+ * @brief Defines compile-time vertex layout descriptions and the vertex types built from them.
+ */
+
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <GL/glew.h>
+#include "../gl/GLApi.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/**
+ * @brief Returns the size in bytes of one component of the given OpenGL attribute type.
+ */
+constexpr size_t vertexComponentSize(GLenum type) {
+  return type == GL_BYTE || type == GL_UNSIGNED_BYTE ? 1
+       : type == GL_SHORT || type == GL_UNSIGNED_SHORT || type == GL_HALF_FLOAT ? 2
+       : 4;
+}
+
+/**
+ * @brief Checks whether the given OpenGL attribute type packs all components into a single 32-bit value.
+ */
+constexpr bool isPackedVertexType(GLenum type) {
+  return type == GL_INT_2_10_10_10_REV || type == GL_UNSIGNED_INT_2_10_10_10_REV;
+}
+
+/**
+ * @struct VertexAttribute
+ * @brief Describes one vertex attribute: where the shader reads it and how it is stored.
+ *
+ * @tparam Location Attribute location in the vertex shader.
+ * @tparam Type OpenGL component type, e.g. GL_FLOAT, GL_HALF_FLOAT, GL_UNSIGNED_BYTE or GL_INT_2_10_10_10_REV.
+ * @tparam Count Number of components.
+ * @tparam Normalized Whether integer components are mapped to [0, 1] (unsigned) or [-1, 1] (signed) when read.
+ */
+template <GLuint Location, GLenum Type, GLint Count, bool Normalized = false>
+struct VertexAttribute {
+  static_assert(!isPackedVertexType(Type) || Count == 4, "Packed 10:10:10:2 attributes always have four components");
+
+  static constexpr GLuint location = Location;
+  static constexpr GLenum type = Type;
+  static constexpr GLint count = Count;
+  static constexpr GLboolean normalized = Normalized ? GL_TRUE : GL_FALSE;
+
+  /**
+   * Size of the attribute in bytes.
+   */
+  static constexpr size_t size = isPackedVertexType(Type) ? 4 : vertexComponentSize(Type) * Count;
+};
+
+/**
+ * @struct VertexFormat
+ * @brief An interleaved vertex layout built from a list of VertexAttribute types, in memory order.
+ *
+ * The stride and every attribute offset are computed at compile time, and enableAttributes() expands to a fixed
+ * sequence of glVertexAttribPointer calls with constant arguments, so there is no per-mesh layout bookkeeping left
+ * to do at runtime.
+ */
+template <typename... Attributes>
+struct VertexFormat {
+  /**
+   * Number of attributes in the format.
+   */
+  static constexpr size_t attributeCount = sizeof...(Attributes);
+
+  /**
+   * Distance in bytes between consecutive vertices.
+   */
+  static constexpr size_t stride = (Attributes::size + ...);
+
+  /**
+   * Byte offset of each attribute within a vertex.
+   */
+  static constexpr std::array<size_t, sizeof...(Attributes)> offsets = [] {
+    std::array<size_t, sizeof...(Attributes)> result = {};
+    size_t sizes[] = { Attributes::size... };
+    size_t offset = 0;
+    for (size_t i = 0; i < sizeof...(Attributes); ++i) {
+      result[i] = offset;
+      offset += sizes[i];
+    }
+    return result;
+  }();
+
+  /**
+   * @brief Enables and describes every attribute for the VBO bound to GL_ARRAY_BUFFER and the currently bound VAO.
+   * @param baseOffset Offset of the first vertex within the VBO in bytes.
+   * @param divisor Attribute divisor; 1 advances the attributes once per instance instead of once per vertex.
+   */
+  static void enableAttributes(size_t baseOffset = 0, GLuint divisor = 0) {
+    enableAttributes(baseOffset, divisor, std::index_sequence_for<Attributes...>());
+  }
+
+private:
+  template <size_t... Indices>
+  static void enableAttributes(size_t baseOffset, GLuint divisor, std::index_sequence<Indices...>) {
+    (enableAttribute<Attributes>(baseOffset + offsets[Indices], divisor), ...);
+  }
+
+  template <typename Attribute>
+  static void enableAttribute(size_t offset, GLuint divisor) {
+    GL::EnableVertexAttribArray(Attribute::location);
+    GL::VertexAttribPointer(Attribute::location, Attribute::count, Attribute::type, Attribute::normalized, stride, (void*)offset);
+    if (divisor != 0) {
+      GL::VertexAttribDivisor(Attribute::location, divisor);
+    }
+  }
+};
+
+/**
+ * @struct ColorVertex
+ * @brief A full precision vertex: float position and float color (24 bytes).
+ */
+struct ColorVertex {
+  float position[3];
+  float color[3];
+
+  typedef VertexFormat<
+    VertexAttribute<0, GL_FLOAT, 3>,
+    VertexAttribute<1, GL_FLOAT, 3>
+  > Format;
+};
+
+/**
+ * @struct PackedVertex
+ * @brief A compact vertex for large static geometry (16 bytes).
+ *
+ * Positions are half floats (exact for integer coordinates up to 2048, plenty for chunk-local world geometry), the
+ * color is four normalized bytes and the normal is packed into signed normalized 10:10:10:2. The fourth position
+ * component only pads the color to a 4-byte boundary; the shader reads the first three.
+ */
+struct PackedVertex {
+  uint16_t position[4];
+  uint8_t color[4];
+  uint32_t normal;
+
+  typedef VertexFormat<
+    VertexAttribute<0, GL_HALF_FLOAT, 4>,
+    VertexAttribute<1, GL_UNSIGNED_BYTE, 4, true>,
+    VertexAttribute<2, GL_INT_2_10_10_10_REV, 4, true>
+  > Format;
+};
+
+static_assert(sizeof(ColorVertex) == ColorVertex::Format::stride, "ColorVertex does not match its format");
+static_assert(sizeof(PackedVertex) == PackedVertex::Format::stride, "PackedVertex does not match its format");
+
+/**
+ * @brief Converts a float to an IEEE 754 half float, rounding to nearest even.
+ */
+uint16_t packHalf(float value);
+
+/**
+ * @brief Converts a float in [0, 1] to a normalized unsigned byte.
+ */
+uint8_t packUnorm8(float value);
+
+/**
+ * @brief Packs a vector with components in [-1, 1] into signed normalized 10:10:10:2 (x in the lowest bits).
+ */
+uint32_t packSnorm1010102(float x, float y, float z, float w = 0.0f);
+
+/**
+ * @brief Builds a PackedVertex from full precision attributes.
+ * @param position Pointer to three position floats.
+ * @param color Pointer to three color floats in [0, 1].
+ * @param normal Pointer to three normal floats, or nullptr for a zero normal.
+ */
+PackedVertex packVertex(const float* position, const float* color, const float* normal = nullptr);
+
+/**
+ * @brief Converts an IEEE 754 half float to a float, exactly.
+ */
+float unpackHalf(uint16_t value);
+
+/**
+ * @brief Expands a vertex to full precision position and color, with the values the GPU reads from it.
+ */
+ColorVertex unpackVertex(const PackedVertex& vertex);
+inline ColorVertex unpackVertex(const ColorVertex& vertex) {
+  return vertex;
+}
+
+#endif
@@ -0,0 +1,74 @@
+/**
+ * @file GpuTimer.cpp
+ * @brief Implements the GpuTimer class, which measures GPU execution time of render passes with timer queries.
+ */
+
+#include "GpuTimer.h"
+#include "../gl/GLApi.h"
+
+GpuTimer::GpuTimer(Profiler* profiler)
+  : profiler(profiler), currentSet(0), active(false), droppedCount(0) {}
+
+GpuTimer::~GpuTimer() {
+  for (QuerySet& set : querySets) {
+    for (Query& query : set.queries) {
+      GL::DeleteQueries(1, &query.id);
+    }
+  }
+}
+
+void GpuTimer::beginFrame() {
+  currentSet = (currentSet + 1) % frameLatency;
+  QuerySet& set = querySets[currentSet];
+
+  // These queries were issued frameLatency frames ago; read back whatever has finished without waiting
+  for (size_t i = 0; i < set.used; ++i) {
+    Query& query = set.queries[i];
+
+    GLint available = GL_FALSE;
+    GL::GetQueryObjectiv(query.id, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+      ++droppedCount;
+      continue;
+    }
+
+    GLuint64 elapsedNanoseconds = 0;
+    GL::GetQueryObjectui64v(query.id, GL_QUERY_RESULT, &elapsedNanoseconds);
+    profiler -> record(query.name, set.frame, query.cpuStart, elapsedNanoseconds / 1e9, ProfileTrack::Gpu);
+  }
+
+  set.used = 0;
+  set.frame = profiler -> getFrameIndex();
+}
+
+void GpuTimer::begin(const char* name) {
+  if (active) {
+    return;
+  }
+
+  QuerySet& set = querySets[currentSet];
+  if (set.used == set.queries.size()) {
+    Query query = {};
+    GL::GenQueries(1, &query.id);
+    set.queries.push_back(query);
+  }
+
+  Query& query = set.queries[set.used++];
+  query.name = name;
+  query.cpuStart = profiler -> now();
+  GL::BeginQuery(GL_TIME_ELAPSED, query.id);
+  active = true;
+}
+
+void GpuTimer::end() {
+  if (!active) {
+    return;
+  }
+
+  GL::EndQuery(GL_TIME_ELAPSED);
+  active = false;
+}
+
+uint64_t GpuTimer::getDroppedCount() const {
+  return droppedCount;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file GpuTimer.h
+ * @brief Declares the GpuTimer class, which measures GPU execution time of render passes with timer queries.
+ */
+
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <vector>
+#include "Profiler.h"
+
+/**
+ * @class GpuTimer
+ * @brief Wraps GL_TIME_ELAPSED timer queries and feeds their results into a Profiler.
+ *
+ * Query results only become available once the GPU has caught up, and asking for them earlier blocks the CPU until
+ * it does. To avoid that stall, queries are double-buffered per frame: the queries issued in frame N are read back
+ * at the start of frame N + 2, and any that are still not available then are dropped rather than waited on.
+ *
+ * GL_TIME_ELAPSED measures durations only, so each GPU sample is placed on the timeline at the CPU time its query
+ * was issued. Only one query can be active at a time; passes must not be nested.
+ */
+class GpuTimer {
+public:
+  /**
+   * @brief Constructs a GpuTimer. Requires a current OpenGL context.
+   * @param profiler The profiler that resolved GPU samples are recorded into.
+   */
+  GpuTimer(Profiler* profiler);
+
+  /**
+   * @brief Deletes all timer queries.
+   */
+  ~GpuTimer();
+
+  /**
+   * @brief Collects the results of the queries issued two frames ago and starts a new frame.
+   */
+  void beginFrame();
+
+  /**
+   * @brief Starts timing a GPU pass.
+   * @param name Name of the pass, with static storage duration.
+   */
+  void begin(const char* name);
+
+  /**
+   * @brief Stops timing the current GPU pass.
+   */
+  void end();
+
+  /**
+   * @brief Returns the number of query results dropped because they were not ready in time.
+   */
+  uint64_t getDroppedCount() const;
+
+private:
+  /**
+   * Number of frames of queries kept in flight.
+   */
+  static const int frameLatency = 2;
+
+  /**
+   * A timer query and the pass it measures.
+   */
+  struct Query {
+    GLuint id;
+    const char* name;
+    double cpuStart;
+  };
+
+  /**
+   * Queries issued during one frame. Query objects are reused from frame to frame and only grow in number.
+   */
+  struct QuerySet {
+    std::vector<Query> queries;
+    size_t used = 0;
+    uint64_t frame = 0;
+  };
+
+  /**
+   * The profiler GPU samples are recorded into.
+   */
+  Profiler* profiler;
+
+  /**
+   * One set of queries per frame in flight.
+   */
+  QuerySet querySets[frameLatency];
+
+  /**
+   * Index of the query set used by the current frame.
+   */
+  int currentSet;
+
+  /**
+   * Whether a query is currently active.
+   */
+  bool active;
+
+  /**
+   * Number of results dropped because they were not ready in time.
+   */
+  uint64_t droppedCount;
+};
+
+#endif
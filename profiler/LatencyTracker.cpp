@@ -0,0 +1,95 @@
+/**
+ * @file LatencyTracker.cpp
+ * @brief Implements the LatencyTracker class, which measures the time from input to the GPU finishing the frame.
+ */
+
+#include "LatencyTracker.h"
+#include "../gl/GLApi.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+LatencyTracker::LatencyTracker(Window* window)
+  : window(window),
+    currentQuery(0),
+    frameInputTime(-1.0),
+    clockOffset(0),
+    droppedCount(0) {
+  for (Query& query : queries) {
+    GL::GenQueries(1, &query.id);
+    query.inputTime = 0;
+    query.pending = false;
+  }
+  calibrate();
+}
+
+LatencyTracker::~LatencyTracker() {
+  for (Query& query : queries) {
+    GL::DeleteQueries(1, &query.id);
+  }
+}
+
+void LatencyTracker::calibrate() {
+  // GL_TIMESTAMP reads the GPU clock without waiting for queued commands, so this costs a round trip at most
+  GLint64 gpuTime = 0;
+  GL::GetInteger64v(GL_TIMESTAMP, &gpuTime);
+  clockOffset = window -> getTime() - gpuTime / 1e9;
+}
+
+void LatencyTracker::beginFrame() {
+  calibrate();
+
+  currentQuery = (currentQuery + 1) % frameLatency;
+  Query& query = queries[currentQuery];
+  if (query.pending) {
+    GLint available = GL_FALSE;
+    GL::GetQueryObjectiv(query.id, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available) {
+      GLuint64 finishedNanoseconds = 0;
+      GL::GetQueryObjectui64v(query.id, GL_QUERY_RESULT, &finishedNanoseconds);
+      latencies.push(finishedNanoseconds / 1e9 + clockOffset - query.inputTime);
+    } else {
+      ++droppedCount;
+    }
+    query.pending = false;
+  }
+
+  frameInputTime = -1.0;
+}
+
+void LatencyTracker::addInput(double time) {
+  if (frameInputTime < 0 || time < frameInputTime) {
+    frameInputTime = time;
+  }
+}
+
+void LatencyTracker::endFrame() {
+  if (frameInputTime < 0) {
+    return;
+  }
+
+  Query& query = queries[currentQuery];
+  GL::QueryCounter(query.id, GL_TIMESTAMP);
+
+  // Submit the query right away; otherwise it waits for the next frame's commands, and records when those finish
+  GL::Flush();
+  query.inputTime = frameInputTime;
+  query.pending = true;
+}
+
+LatencyStats LatencyTracker::getStats() const {
+  std::vector<double> snapshot;
+  latencies.snapshot(snapshot);
+
+  LatencyStats stats = { snapshot.size(), 0, 0, 0, droppedCount };
+  if (snapshot.empty()) {
+    return stats;
+  }
+
+  std::sort(snapshot.begin(), snapshot.end());
+  stats.meanLatency = std::accumulate(snapshot.begin(), snapshot.end(), 0.0) / snapshot.size();
+  stats.p99Latency = snapshot[static_cast<size_t>(std::ceil(0.99 * snapshot.size())) - 1];
+  stats.maxLatency = snapshot.back();
+  return stats;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file LatencyTracker.h
+ * @brief Declares the LatencyTracker class, which measures the time from input to the GPU finishing the frame.
+ */
+
+#ifndef LATENCY_TRACKER_H
+#define LATENCY_TRACKER_H
+
+#include <GL/glew.h>
+#include <cstdint>
+#include "RingBuffer.h"
+#include "../window/Window.h"
+
+/**
+ * @struct LatencyStats
+ * @brief Summary of the input latency of recent frames.
+ */
+struct LatencyStats {
+  /**
+   * Number of frames measured in the summary.
+   */
+  size_t samples;
+
+  /**
+   * Mean latency in seconds.
+   */
+  double meanLatency;
+
+  /**
+   * 99th percentile latency in seconds.
+   */
+  double p99Latency;
+
+  /**
+   * Largest latency in seconds.
+   */
+  double maxLatency;
+
+  /**
+   * Number of measurements dropped because the GPU had not finished the frame in time.
+   */
+  uint64_t dropped;
+};
+
+/**
+ * @class LatencyTracker
+ * @brief Measures input-to-photon latency as the time from an input event until the GPU has finished the frame
+ * showing it.
+ *
+ * Frames that applied input carry the time of their oldest input event. After the frame is presented, a GL_TIMESTAMP
+ * query records when the GPU has executed everything before it, and the difference is the frame's latency. The
+ * display's own scanout and compositor delay come on top and cannot be observed from OpenGL, but they do not depend
+ * on how the game handles input, so changes in the measured latency are changes in the real one.
+ *
+ * Query results are read back frameLatency frames later so that asking never stalls the CPU, and GPU timestamps are
+ * converted to the window's clock with an offset sampled every frame.
+ */
+class LatencyTracker {
+public:
+  /**
+   * @brief Constructs a LatencyTracker. Requires a current OpenGL context.
+   * @param window Window whose clock input events are stamped with.
+   */
+  LatencyTracker(Window* window);
+
+  /**
+   * @brief Deletes the timestamp queries.
+   */
+  ~LatencyTracker();
+
+  /**
+   * @brief Collects the measurements of frames presented frameLatency frames ago.
+   */
+  void beginFrame();
+
+  /**
+   * @brief Records that the frame being rendered shows input received at the given time. The oldest input of a frame
+   * counts.
+   * @param time Time the input was received, on the window's clock.
+   */
+  void addInput(double time);
+
+  /**
+   * @brief Marks the frame as presented; called right after swapping buffers.
+   */
+  void endFrame();
+
+  /**
+   * @brief Summarizes the latency of recent frames.
+   */
+  LatencyStats getStats() const;
+
+private:
+  /**
+   * Number of frames of queries kept in flight.
+   */
+  static const int frameLatency = 3;
+
+  /**
+   * A timestamp query and the input time of the frame it follows.
+   */
+  struct Query {
+    GLuint id;
+    double inputTime;
+    bool pending;
+  };
+
+  /**
+   * @brief Samples the offset from the GPU's timestamp clock to the window's clock.
+   */
+  void calibrate();
+
+  /**
+   * Window whose clock input events are stamped with.
+   */
+  Window* window;
+
+  /**
+   * One query per frame in flight.
+   */
+  Query queries[frameLatency];
+
+  /**
+   * Index of the query used by the current frame.
+   */
+  int currentQuery;
+
+  /**
+   * Time of the oldest input shown by the current frame, or a negative value if it shows none.
+   */
+  double frameInputTime;
+
+  /**
+   * Window clock time minus GPU clock time, in seconds.
+   */
+  double clockOffset;
+
+  /**
+   * Latencies of recent frames, in seconds.
+   */
+  RingBuffer<double, 1024> latencies;
+
+  /**
+   * Number of measurements dropped because the GPU had not finished the frame in time.
+   */
+  uint64_t droppedCount;
+};
+
+#endif
@@ -0,0 +1,143 @@
+/**
+ * @file Profiler.cpp
+ * @brief Implements the Profiler class, which records per-frame CPU and GPU stage timings.
+ */
+
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+namespace {
+  const char* trackName(ProfileTrack track) {
+    switch (track) {
+      case ProfileTrack::Gpu:
+        return "gpu";
+      case ProfileTrack::RenderThread:
+        return "render";
+      default:
+        return "cpu";
+    }
+  }
+
+  /**
+   * Row of each track in the Chrome trace.
+   */
+  int traceThreadId(ProfileTrack track) {
+    return static_cast<int>(track) + 1;
+  }
+
+  /**
+   * Track and frame set by setThreadFrame() on the calling thread; a negative frame follows the current one.
+   */
+  thread_local ProfileTrack threadTrack = ProfileTrack::Cpu;
+  thread_local int64_t threadFrame = -1;
+}
+
+Profiler::Profiler()
+  : origin(std::chrono::steady_clock::now()),
+    frameIndex(0),
+    frameStart(0) {}
+
+void Profiler::beginFrame() {
+  frameStart = now();
+}
+
+void Profiler::endFrame() {
+  record(frameSampleName, frameIndex, frameStart, now() - frameStart, ProfileTrack::Cpu);
+  ++frameIndex;
+}
+
+void Profiler::record(const char* name, uint64_t frame, double start, double duration, ProfileTrack track) {
+  samples.push({ name, frame, start, duration, track });
+}
+
+double Profiler::now() const {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - origin).count();
+}
+
+uint64_t Profiler::getFrameIndex() const {
+  return threadFrame >= 0 ? static_cast<uint64_t>(threadFrame) : frameIndex.load(std::memory_order_relaxed);
+}
+
+void Profiler::setThreadFrame(ProfileTrack track, uint64_t frame) {
+  threadTrack = track;
+  threadFrame = static_cast<int64_t>(frame);
+}
+
+ProfileTrack Profiler::getThreadTrack() {
+  return threadTrack;
+}
+
+double Profiler::getFrameTimePercentile(double percentile) const {
+  std::vector<ProfileSample> snapshot;
+  samples.snapshot(snapshot);
+
+  std::vector<double> frameTimes;
+  for (const ProfileSample& sample : snapshot) {
+    if (sample.name == frameSampleName) {
+      frameTimes.push_back(sample.duration);
+    }
+  }
+  if (frameTimes.empty()) {
+    return 0;
+  }
+
+  size_t index = static_cast<size_t>(std::ceil(percentile / 100.0 * frameTimes.size()));
+  index = std::min(std::max<size_t>(index, 1), frameTimes.size()) - 1;
+  std::nth_element(frameTimes.begin(), frameTimes.begin() + index, frameTimes.end());
+  return frameTimes[index];
+}
+
+bool Profiler::writeCsv(const std::string& path) const {
+  std::ofstream output(path);
+  if (!output.is_open()) {
+    std::cerr << "Failed to open " << path << " for writing" << std::endl;
+    return false;
+  }
+
+  std::vector<ProfileSample> snapshot;
+  samples.snapshot(snapshot);
+
+  output << "frame,track,name,start_ms,duration_ms\n";
+  for (const ProfileSample& sample : snapshot) {
+    output << sample.frame << ',' << trackName(sample.track) << ',' << sample.name << ','
+           << sample.start * 1000.0 << ',' << sample.duration * 1000.0 << '\n';
+  }
+  return output.good();
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) const {
+  std::ofstream output(path);
+  if (!output.is_open()) {
+    std::cerr << "Failed to open " << path << " for writing" << std::endl;
+    return false;
+  }
+
+  std::vector<ProfileSample> snapshot;
+  samples.snapshot(snapshot);
+
+  // CPU, GPU and render thread samples go on separate named rows (thread ids 1 to 3) of the same process
+  output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+         << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n"
+         << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}},\n"
+         << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":3,\"args\":{\"name\":\"Render thread\"}}";
+  for (const ProfileSample& sample : snapshot) {
+    output << ",\n{\"name\":\"" << sample.name << "\",\"cat\":\"" << trackName(sample.track)
+           << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << traceThreadId(sample.track)
+           << ",\"ts\":" << sample.start * 1000000.0 << ",\"dur\":" << sample.duration * 1000000.0
+           << ",\"args\":{\"frame\":" << sample.frame << "}}";
+  }
+  output << "\n]}\n";
+  return output.good();
+}
+
+ProfileScope::ProfileScope(Profiler* profiler, const char* name)
+  : profiler(profiler), name(name), start(profiler ? profiler -> now() : 0) {}
+
+ProfileScope::~ProfileScope() {
+  if (profiler) {
+    profiler -> record(name, profiler -> getFrameIndex(), start, profiler -> now() - start, Profiler::getThreadTrack());
+  }
+}
@@ -0,0 +1,209 @@
+/**
+ * @file Profiler.h
+ * @brief Declares the Profiler class, which records per-frame CPU and GPU stage timings.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "RingBuffer.h"
+
+/**
+ * @enum ProfileTrack
+ * @brief Identifies which timeline a sample belongs to.
+ */
+enum class ProfileTrack : uint8_t {
+  Cpu,
+  Gpu,
+  RenderThread
+};
+
+/**
+ * @struct ProfileSample
+ * @brief A single timed region of a frame.
+ */
+struct ProfileSample {
+  /**
+   * Name of the region. Must point to a string with static storage duration, e.g. a literal.
+   */
+  const char* name;
+
+  /**
+   * Index of the frame the region belongs to.
+   */
+  uint64_t frame;
+
+  /**
+   * Start of the region in seconds since the profiler was created.
+   */
+  double start;
+
+  /**
+   * Duration of the region in seconds.
+   */
+  double duration;
+
+  /**
+   * Timeline the region was measured on.
+   */
+  ProfileTrack track;
+};
+
+/**
+ * @class Profiler
+ * @brief Collects CPU and GPU stage timings for every frame into a lock-free ring buffer.
+ *
+ * Samples are cheap to record and the buffer only keeps the most recent ones, so profiling can stay enabled at all
+ * times. The buffer can be dumped on demand as CSV or as Chrome trace_event JSON (load it in chrome://tracing or
+ * Perfetto), and frame time percentiles are available for spotting spikes that an averaged FPS count hides.
+ */
+class Profiler {
+public:
+  /**
+   * Name of the sample recorded for every whole frame.
+   */
+  static constexpr const char* frameSampleName = "frame";
+
+  /**
+   * @brief Constructs a Profiler whose clock starts at zero.
+   */
+  Profiler();
+
+  /**
+   * @brief Marks the start of a new frame.
+   */
+  void beginFrame();
+
+  /**
+   * @brief Marks the end of the current frame, recording its total duration.
+   */
+  void endFrame();
+
+  /**
+   * @brief Records a timed region.
+   * @param name Name of the region, with static storage duration.
+   * @param frame Index of the frame the region belongs to.
+   * @param start Start of the region in seconds, on the profiler clock.
+   * @param duration Duration of the region in seconds.
+   * @param track Timeline the region was measured on.
+   */
+  void record(const char* name, uint64_t frame, double start, double duration, ProfileTrack track);
+
+  /**
+   * @brief Returns the current time in seconds on the profiler clock.
+   */
+  double now() const;
+
+  /**
+   * @brief Returns the index of the frame the calling thread is working on: the current frame, unless the thread
+   * set its own with setThreadFrame().
+   */
+  uint64_t getFrameIndex() const;
+
+  /**
+   * @brief Makes the CPU samples of the calling thread go to a track of their own and belong to the given frame,
+   * for threads that work on an earlier frame than the main thread, such as the render thread.
+   * @param track Track the thread's scopes are recorded on.
+   * @param frame Index of the frame the thread is working on.
+   */
+  static void setThreadFrame(ProfileTrack track, uint64_t frame);
+
+  /**
+   * @brief Returns the track the calling thread's scopes are recorded on.
+   */
+  static ProfileTrack getThreadTrack();
+
+  /**
+   * @brief Computes a percentile of the whole-frame durations still held in the buffer.
+   * @param percentile Percentile in the range [0, 100].
+   * @return The frame duration in seconds, or 0 if no frames have been recorded.
+   */
+  double getFrameTimePercentile(double percentile) const;
+
+  /**
+   * @brief Writes all buffered samples as CSV with one row per sample.
+   * @param path Destination file path.
+   * @return true if the file was written successfully; false otherwise.
+   */
+  bool writeCsv(const std::string& path) const;
+
+  /**
+   * @brief Writes all buffered samples in the Chrome trace_event JSON format.
+   * @param path Destination file path.
+   * @return true if the file was written successfully; false otherwise.
+   */
+  bool writeChromeTrace(const std::string& path) const;
+
+private:
+  /**
+   * Number of samples kept in the ring buffer; enough for several seconds of frames at full detail.
+   */
+  static const size_t sampleCapacity = 16384;
+
+  /**
+   * Time the profiler was created, the origin of the profiler clock.
+   */
+  std::chrono::steady_clock::time_point origin;
+
+  /**
+   * Index of the current frame, read by other threads.
+   */
+  std::atomic<uint64_t> frameIndex;
+
+  /**
+   * Start of the current frame on the profiler clock.
+   */
+  double frameStart;
+
+  /**
+   * The most recent samples.
+   */
+  RingBuffer<ProfileSample, sampleCapacity> samples;
+};
+
+/**
+ * @class ProfileScope
+ * @brief Records the lifetime of a scope as a CPU sample, on the calling thread's track.
+ *
+ * Does nothing when constructed with a null profiler, so call sites do not need to check whether profiling is set up.
+ */
+class ProfileScope {
+public:
+  /**
+   * @brief Starts timing a scope.
+   * @param profiler The profiler to record into, or nullptr to disable.
+   * @param name Name of the scope, with static storage duration.
+   */
+  ProfileScope(Profiler* profiler, const char* name);
+
+  /**
+   * @brief Stops timing and records the sample.
+   */
+  ~ProfileScope();
+
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+  /**
+   * The profiler the sample is recorded into.
+   */
+  Profiler* profiler;
+
+  /**
+   * Name of the scope.
+   */
+  const char* name;
+
+  /**
+   * Start of the scope on the profiler clock.
+   */
+  double start;
+};
+
+#endif
@@ -0,0 +1,104 @@
+/**
+ * @file RingBuffer.h
+ * @brief Defines the RingBuffer class template, a fixed-size lock-free buffer that keeps the most recent samples.
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class RingBuffer
+ * @brief A lock-free, overwriting ring buffer for trivially copyable values.
+ *
+ * Writers claim a slot with a single atomic increment and never wait, so pushing is cheap enough to do from hot
+ * paths. Once the buffer is full the oldest values are overwritten. Each slot carries a sequence number that works
+ * like a seqlock: readers copy a slot and then re-check its sequence, discarding values that were being overwritten
+ * while they were read. This lets a reader take a snapshot at any time without ever blocking the writers.
+ *
+ * @tparam T Type of the stored values. Must be trivially copyable.
+ * @tparam Capacity Number of slots. Must be a power of two.
+ */
+template <typename T, size_t Capacity>
+class RingBuffer {
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "RingBuffer capacity must be a power of two");
+
+public:
+  RingBuffer() : writeIndex(0) {
+    for (Slot& slot : slots) {
+      slot.sequence.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Appends a value, overwriting the oldest one if the buffer is full.
+   * @param value The value to store.
+   */
+  void push(const T& value) {
+    uint64_t index = writeIndex.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots[index & (Capacity - 1)];
+
+    // An odd sequence marks the slot as being written; readers skip it until the matching even value is published
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.value = value;
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+  }
+
+  /**
+   * @brief Copies the currently stored values, oldest first, into the output vector.
+   * @param output Vector the values are appended to.
+   */
+  void snapshot(std::vector<T>& output) const {
+    uint64_t end = writeIndex.load(std::memory_order_acquire);
+    uint64_t begin = end > Capacity ? end - Capacity : 0;
+    output.reserve(output.size() + (end - begin));
+
+    for (uint64_t index = begin; index < end; ++index) {
+      const Slot& slot = slots[index & (Capacity - 1)];
+      uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+      if (sequence != 2 * index + 2) {
+        continue;
+      }
+
+      T value = slot.value;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+        output.push_back(value);
+      }
+    }
+  }
+
+  /**
+   * @brief Returns the total number of values ever pushed, including overwritten ones.
+   */
+  uint64_t totalPushed() const {
+    return writeIndex.load(std::memory_order_relaxed);
+  }
+
+private:
+  /**
+   * A stored value together with the sequence number guarding it.
+   */
+  struct Slot {
+    std::atomic<uint64_t> sequence;
+    T value;
+  };
+
+  /**
+   * Storage for the values.
+   */
+  std::array<Slot, Capacity> slots;
+
+  /**
+   * Index of the next slot to be written, increasing monotonically.
+   */
+  std::atomic<uint64_t> writeIndex;
+};
+
+#endif
@@ -0,0 +1,86 @@
+/**
+ * @file CommandList.cpp
+ * @brief Implements the CommandList class, a linearly allocated list of deferred rendering commands.
+ */
+
+#include "CommandList.h"
+#include <algorithm>
+
+CommandList::CommandList(size_t blockSize)
+  : blockSize(blockSize),
+    currentBlock(0),
+    blockOffset(0),
+    usedBefore(0),
+    head(nullptr),
+    tail(nullptr),
+    commandCount(0) {}
+
+CommandList::~CommandList() {
+  clear(false);
+}
+
+void* CommandList::allocateBytes(size_t size, size_t alignment) {
+  while (currentBlock < blocks.size()) {
+    Block& block = blocks[currentBlock];
+    size_t address = reinterpret_cast<size_t>(block.memory.get()) + blockOffset;
+    size_t padding = (alignment - address % alignment) % alignment;
+    if (blockOffset + padding + size <= block.size) {
+      blockOffset += padding + size;
+      return reinterpret_cast<void*>(address + padding);
+    }
+
+    // Leave the rest of this block unused; blocks kept from earlier frames are tried before adding one
+    usedBefore += blockOffset;
+    ++currentBlock;
+    blockOffset = 0;
+  }
+
+  Block block;
+  block.size = std::max(blockSize, size + alignment);
+  block.memory.reset(new char[block.size]);
+  blocks.push_back(std::move(block));
+  return allocateBytes(size, alignment);
+}
+
+void CommandList::append(Node* node) {
+  if (tail) {
+    tail -> next = node;
+  } else {
+    head = node;
+  }
+  tail = node;
+  ++commandCount;
+}
+
+void CommandList::execute() {
+  clear(true);
+}
+
+void CommandList::reset() {
+  clear(false);
+}
+
+void CommandList::clear(bool run) {
+  // Commands may not record into the list they run from, so the chain is fixed while it is walked
+  Node* node = head;
+  while (node) {
+    Node* next = node -> next;
+    node -> invoke(node, run);
+    node = next;
+  }
+
+  head = nullptr;
+  tail = nullptr;
+  commandCount = 0;
+  currentBlock = 0;
+  blockOffset = 0;
+  usedBefore = 0;
+}
+
+size_t CommandList::getCommandCount() const {
+  return commandCount;
+}
+
+size_t CommandList::getSize() const {
+  return usedBefore + blockOffset;
+}
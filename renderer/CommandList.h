@@ -0,0 +1,175 @@
+/**
+ * @file CommandList.h
+ * @brief Declares the CommandList class, a linearly allocated list of deferred rendering commands.
+ */
+
+#ifndef COMMAND_LIST_H
+#define COMMAND_LIST_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * @class CommandList
+ * @brief Records commands on one thread to be executed in order on another, e.g. the render thread.
+ *
+ * Commands are callables stored inline in a linear arena together with the data they refer to (camera snapshots,
+ * draw packets, copies of transforms), so recording a frame costs a few pointer bumps rather than an allocation per
+ * command. reset() rewinds the arena and keeps its memory, so after the first frames a list allocates nothing at all.
+ *
+ * Anything a command reads must either be copied into the list or left unchanged by the recording thread until the
+ * list has executed.
+ */
+class CommandList {
+public:
+  /**
+   * @brief Constructs an empty list.
+   * @param blockSize Size of each arena block in bytes; larger allocations get a block of their own.
+   */
+  explicit CommandList(size_t blockSize = 1024 * 1024);
+
+  /**
+   * @brief Destroys the commands that have not been executed.
+   */
+  ~CommandList();
+
+  CommandList(const CommandList&) = delete;
+  CommandList& operator=(const CommandList&) = delete;
+
+  /**
+   * @brief Allocates uninitialized storage in the list for trivially copyable data the commands refer to.
+   * @param count Number of values.
+   * @return Storage that stays valid until the list is reset.
+   */
+  template <typename T>
+  T* allocate(size_t count) {
+    return static_cast<T*>(allocateBytes(count * sizeof(T), alignof(T)));
+  }
+
+  /**
+   * @brief Appends a command to the list.
+   * @param command Callable taking no arguments, moved into the list.
+   */
+  template <typename F>
+  void record(F&& command) {
+    using Command = typename std::decay<F>::type;
+    void* storage = allocateBytes(sizeof(Node) + alignof(Command) + sizeof(Command), alignof(Node));
+    Node* node = new (storage) Node();
+    new (node -> payload<Command>()) Command(std::forward<F>(command));
+    node -> invoke = [](Node* self, bool run) {
+      Command* callable = self -> payload<Command>();
+      if (run) {
+        (*callable)();
+      }
+      callable -> ~Command();
+    };
+    append(node);
+  }
+
+  /**
+   * @brief Runs the commands in the order they were recorded, then resets the list.
+   */
+  void execute();
+
+  /**
+   * @brief Destroys the commands without running them and rewinds the arena.
+   */
+  void reset();
+
+  /**
+   * @brief Get the number of commands recorded since the last reset.
+   */
+  size_t getCommandCount() const;
+
+  /**
+   * @brief Get the number of arena bytes used since the last reset.
+   */
+  size_t getSize() const;
+
+private:
+  /**
+   * Header preceding every command in the arena. The callable follows it, suitably aligned.
+   */
+  struct Node {
+    /**
+     * Runs the callable when asked to, then destroys it.
+     */
+    void (*invoke)(Node* self, bool run);
+
+    /**
+     * The next command, or nullptr for the last one.
+     */
+    Node* next = nullptr;
+
+    template <typename Command>
+    Command* payload() {
+      size_t address = reinterpret_cast<size_t>(this + 1);
+      size_t alignment = alignof(Command);
+      return reinterpret_cast<Command*>((address + alignment - 1) & ~(alignment - 1));
+    }
+  };
+
+  /**
+   * A chunk of arena memory.
+   */
+  struct Block {
+    std::unique_ptr<char[]> memory;
+    size_t size;
+  };
+
+  /**
+   * @brief Allocates from the arena, moving on to the next block or adding one when the current one is full.
+   */
+  void* allocateBytes(size_t size, size_t alignment);
+
+  /**
+   * @brief Links a command in at the end of the list.
+   */
+  void append(Node* node);
+
+  /**
+   * @brief Destroys every command, running them first when asked to, and rewinds the arena.
+   */
+  void clear(bool run);
+
+  /**
+   * Arena blocks, kept across resets.
+   */
+  std::vector<Block> blocks;
+
+  /**
+   * Size of newly added blocks.
+   */
+  size_t blockSize;
+
+  /**
+   * Index of the block being allocated from.
+   */
+  size_t currentBlock;
+
+  /**
+   * Bytes used in the current block.
+   */
+  size_t blockOffset;
+
+  /**
+   * Bytes used in the blocks before the current one, for getSize().
+   */
+  size_t usedBefore;
+
+  /**
+   * First and last recorded commands.
+   */
+  Node* head;
+  Node* tail;
+
+  /**
+   * Number of recorded commands.
+   */
+  size_t commandCount;
+};
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * @file RenderQueue.cpp
+ * @brief Implements the RenderQueue class, which collects draws for a frame and orders them by pipeline state.
+ */
+
+#include "RenderQueue.h"
+#include <algorithm>
+
+uint64_t RenderQueue::makeKey(unsigned pass, GLuint programId, GLuint vertexArrayId, GLuint textureId, float depth) {
+  uint64_t quantizedDepth = static_cast<uint64_t>(std::min(std::max(depth, 0.0f), 1023.999f) * 1024.0f);
+
+  return (static_cast<uint64_t>(pass & 0xf) << 60)
+       | (static_cast<uint64_t>(programId & 0xfff) << 48)
+       | (static_cast<uint64_t>(vertexArrayId & 0xffff) << 32)
+       | (static_cast<uint64_t>(textureId & 0xfff) << 20)
+       | (quantizedDepth & 0xfffff);
+}
+
+void RenderQueue::submit(uint64_t key, const DrawPacket& packet) {
+  entries.push_back({ key, static_cast<uint32_t>(packets.size()) });
+  packets.push_back(packet);
+}
+
+void RenderQueue::sort() {
+  scratch.resize(entries.size());
+
+  // One stable counting sort per key byte, least significant first
+  for (int shift = 0; shift < 64; shift += 8) {
+    size_t counts[256] = {};
+    for (const SortEntry& entry : entries) {
+      ++counts[(entry.key >> shift) & 0xff];
+    }
+
+    // When every key has the same byte here, this pass would not move anything
+    if (counts[(entries.empty() ? 0 : entries[0].key >> shift) & 0xff] == entries.size()) {
+      continue;
+    }
+
+    size_t offset = 0;
+    for (size_t& count : counts) {
+      size_t bucketSize = count;
+      count = offset;
+      offset += bucketSize;
+    }
+
+    for (const SortEntry& entry : entries) {
+      scratch[counts[(entry.key >> shift) & 0xff]++] = entry;
+    }
+    entries.swap(scratch);
+  }
+}
+
+void RenderQueue::clear() {
+  packets.clear();
+  entries.clear();
+}
+
+size_t RenderQueue::size() const {
+  return entries.size();
+}
+
+const DrawPacket& RenderQueue::operator[](size_t i) const {
+  return packets[entries[i].packetIndex];
+}
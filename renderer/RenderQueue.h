@@ -0,0 +1,102 @@
+/**
+ * @file RenderQueue.h
+ * @brief Declares the RenderQueue class, which collects draws for a frame and orders them by pipeline state.
+ */
+
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../mesh/Mesh.h"
+#include "../shader/ShaderProgram.h"
+
+/**
+ * @struct DrawPacket
+ * @brief Everything needed to issue one draw, recorded when it is submitted and executed after sorting.
+ */
+struct DrawPacket {
+  ShaderProgram* program;
+  Mesh* mesh;
+  glm::mat4 modelMatrix;
+};
+
+/**
+ * @class RenderQueue
+ * @brief Collects the draw packets of a frame and sorts them by a 64-bit key encoding their pipeline state.
+ *
+ * From the most significant bits down, a key holds the pass (4 bits), program (12 bits), vertex array (16 bits),
+ * texture (12 bits) and quantized view depth (20 bits). Sorting by key therefore groups draws first by pass, then by
+ * the state that is most expensive to change, so executing them in order changes each piece of state only where the
+ * key does. Within equal state, draws run front to back, which lets the depth test reject hidden fragments early.
+ *
+ * Keys are sorted with an LSD radix sort over (key, packet index) pairs, which is linear in the number of draws and
+ * skips the byte positions in which all keys agree.
+ */
+class RenderQueue {
+public:
+  /**
+   * @brief Builds a sort key.
+   * @param pass Render pass, in execution order; only the low 4 bits are used.
+   * @param programId OpenGL program ID; only the low 12 bits are used.
+   * @param vertexArrayId OpenGL vertex array ID; only the low 16 bits are used.
+   * @param textureId OpenGL texture ID, or 0; only the low 12 bits are used.
+   * @param depth Distance from the camera, clamped to [0, 1024) and quantized to 1/1024 units.
+   */
+  static uint64_t makeKey(unsigned pass, GLuint programId, GLuint vertexArrayId, GLuint textureId, float depth);
+
+  /**
+   * @brief Adds a draw to the queue.
+   * @param key Sort key built with makeKey().
+   * @param packet The draw to execute.
+   */
+  void submit(uint64_t key, const DrawPacket& packet);
+
+  /**
+   * @brief Sorts the queued draws by key. Draws with equal keys keep their submission order.
+   */
+  void sort();
+
+  /**
+   * @brief Removes all queued draws, keeping the allocated memory for the next frame.
+   */
+  void clear();
+
+  /**
+   * @brief Get the number of queued draws.
+   */
+  size_t size() const;
+
+  /**
+   * @brief Returns the i-th queued draw: in sorted order after sort(), otherwise in submission order.
+   */
+  const DrawPacket& operator[](size_t i) const;
+
+private:
+  /**
+   * A sort key and the index of the packet it belongs to, so sorting moves 16 bytes instead of whole packets.
+   */
+  struct SortEntry {
+    uint64_t key;
+    uint32_t packetIndex;
+  };
+
+  /**
+   * Queued draws, in submission order.
+   */
+  std::vector<DrawPacket> packets;
+
+  /**
+   * Keys of the queued draws.
+   */
+  std::vector<SortEntry> entries;
+
+  /**
+   * Scratch buffer for the radix sort.
+   */
+  std::vector<SortEntry> scratch;
+};
+
+#endif
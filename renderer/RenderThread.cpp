@@ -0,0 +1,140 @@
+/**
+ * @file RenderThread.cpp
+ * @brief Implements the RenderThread class, which executes the frames' command lists on a thread owning the GL context.
+ */
+
+#include "RenderThread.h"
+#include <algorithm>
+
+RenderThread::RenderThread(Window* window, Profiler* profiler, bool threaded)
+  : window(window),
+    profiler(profiler),
+    threaded(threaded),
+    recordingList(0),
+    submittedList(nullptr),
+    submittedFrame(0),
+    busy(false),
+    stopping(false),
+    recordStart(profiler -> now()),
+    executeStart(0),
+    executeEnd(0),
+    stats({ 0, 0, 0, 0, 0 }) {
+  if (threaded) {
+    window -> releaseContext();
+    thread = std::thread(&RenderThread::run, this);
+  }
+}
+
+RenderThread::~RenderThread() {
+  if (!threaded) {
+    return;
+  }
+
+  finish();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  listSubmitted.notify_one();
+  thread.join();
+  window -> makeContextCurrent();
+}
+
+CommandList& RenderThread::getCommandList() {
+  return lists[recordingList];
+}
+
+void RenderThread::submit() {
+  CommandList& list = lists[recordingList];
+  uint64_t frame = profiler -> getFrameIndex();
+
+  if (!threaded) {
+    execute(list, frame);
+    std::lock_guard<std::mutex> lock(mutex);
+    ++stats.frames;
+    recordStart = profiler -> now();
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+  double submitStart = profiler -> now();
+  listFinished.wait(lock, [this] { return !busy && !submittedList; });
+  double waitEnd = profiler -> now();
+
+  // The previous frame's execution overlapped the recording of this one as far as both intervals intersect
+  stats.overlapTime += std::max(0.0, std::min(executeEnd, submitStart) - std::max(executeStart, recordStart));
+  stats.waitTime += waitEnd - submitStart;
+  stats.maxWaitTime = std::max(stats.maxWaitTime, waitEnd - submitStart);
+  ++stats.frames;
+
+  submittedList = &list;
+  submittedFrame = frame;
+  recordingList = 1 - recordingList;
+  recordStart = waitEnd;
+  lock.unlock();
+  listSubmitted.notify_one();
+}
+
+void RenderThread::finish() {
+  if (!threaded) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+  listFinished.wait(lock, [this] { return !busy && !submittedList; });
+}
+
+void RenderThread::run() {
+  window -> makeContextCurrent();
+
+  while (true) {
+    CommandList* list;
+    uint64_t frame;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      listSubmitted.wait(lock, [this] { return stopping || submittedList; });
+      if (!submittedList) {
+        break;
+      }
+      list = submittedList;
+      frame = submittedFrame;
+      submittedList = nullptr;
+      busy = true;
+    }
+
+    execute(*list, frame);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      busy = false;
+    }
+    listFinished.notify_all();
+  }
+
+  window -> releaseContext();
+}
+
+void RenderThread::execute(CommandList& list, uint64_t frame) {
+  if (threaded) {
+    Profiler::setThreadFrame(ProfileTrack::RenderThread, frame);
+  }
+
+  double start = profiler -> now();
+  list.execute();
+  double end = profiler -> now();
+  profiler -> record("executeCommands", frame, start, end - start, threaded ? ProfileTrack::RenderThread : ProfileTrack::Cpu);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  executeStart = start;
+  executeEnd = end;
+  stats.executeTime += end - start;
+}
+
+bool RenderThread::isThreaded() const {
+  return threaded;
+}
+
+RenderThreadStats RenderThread::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return stats;
+}
@@ -0,0 +1,184 @@
+/**
+ * @file RenderThread.h
+ * @brief Declares the RenderThread class, which executes the frames' command lists on a thread owning the GL context.
+ */
+
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "CommandList.h"
+#include "../window/Window.h"
+#include "../profiler/Profiler.h"
+
+/**
+ * @struct RenderThreadStats
+ * @brief Totals of how the simulation and render threads overlapped, and what the handoff cost.
+ */
+struct RenderThreadStats {
+  /**
+   * Number of frames submitted.
+   */
+  uint64_t frames;
+
+  /**
+   * Time the render thread spent executing command lists, in seconds.
+   */
+  double executeTime;
+
+  /**
+   * Time the render thread executed a frame while the simulation thread was already building the next one, in
+   * seconds; the work taken off the frame's critical path.
+   */
+  double overlapTime;
+
+  /**
+   * Time the simulation thread waited for the render thread to finish the previous frame before submitting, in
+   * seconds. This is all the latency the pipelining adds to a frame.
+   */
+  double waitTime;
+
+  /**
+   * Longest single wait, in seconds; never more than the execution time of one frame.
+   */
+  double maxWaitTime;
+};
+
+/**
+ * @class RenderThread
+ * @brief Runs all OpenGL work on a dedicated thread, one frame behind the simulation.
+ *
+ * The simulation thread records each frame into a CommandList and submits it; the render thread executes it while
+ * the simulation thread goes on to build the next frame in the other list. Submitting waits until the render thread
+ * has finished the previous frame, so at most one frame is in flight and a frame is shown at most one frame's
+ * execution time later than it would be on a single thread.
+ *
+ * When constructed unthreaded, submit() executes the list right away on the calling thread instead, which makes the
+ * two modes easy to compare.
+ */
+class RenderThread {
+public:
+  /**
+   * @brief Starts the render thread and moves the window's OpenGL context to it.
+   * @param window Window whose context the commands use; it must be current on the calling thread.
+   * @param profiler Profiler the render thread's scopes are recorded into.
+   * @param threaded Whether to execute the lists on a thread of their own, or inline on submit().
+   */
+  RenderThread(Window* window, Profiler* profiler, bool threaded = true);
+
+  /**
+   * @brief Finishes the submitted frames, stops the thread and makes the context current on the calling thread again.
+   */
+  ~RenderThread();
+
+  /**
+   * @brief Get the list the simulation thread records the current frame into.
+   */
+  CommandList& getCommandList();
+
+  /**
+   * @brief Hands the recorded list to the render thread, first waiting for it to finish the previous frame.
+   */
+  void submit();
+
+  /**
+   * @brief Waits until every submitted frame has executed.
+   */
+  void finish();
+
+  /**
+   * @brief Checks whether the lists execute on a thread of their own.
+   */
+  bool isThreaded() const;
+
+  /**
+   * @brief Get the overlap and handoff totals; exact once finish() has returned.
+   */
+  RenderThreadStats getStats() const;
+
+private:
+  /**
+   * @brief Body of the render thread: executes submitted lists until stopped.
+   */
+  void run();
+
+  /**
+   * @brief Executes a list and records its timing.
+   */
+  void execute(CommandList& list, uint64_t frame);
+
+  /**
+   * Window whose context the commands use.
+   */
+  Window* window;
+
+  /**
+   * Profiler the render thread's scopes are recorded into.
+   */
+  Profiler* profiler;
+
+  /**
+   * Whether the lists execute on a thread of their own.
+   */
+  bool threaded;
+
+  /**
+   * The two command lists; one is recorded while the other executes.
+   */
+  CommandList lists[2];
+
+  /**
+   * Index of the list being recorded.
+   */
+  int recordingList;
+
+  /**
+   * The list handed to the render thread and the frame it belongs to, or nullptr when there is none.
+   */
+  CommandList* submittedList;
+  uint64_t submittedFrame;
+
+  /**
+   * Whether the render thread is executing a list.
+   */
+  bool busy;
+
+  /**
+   * Set to stop the render thread.
+   */
+  bool stopping;
+
+  /**
+   * Time the current list started being recorded, and the times the render thread last started and finished one,
+   * on the profiler clock.
+   */
+  double recordStart;
+  double executeStart;
+  double executeEnd;
+
+  /**
+   * Overlap and handoff totals.
+   */
+  RenderThreadStats stats;
+
+  /**
+   * Guards the handoff state above.
+   */
+  mutable std::mutex mutex;
+
+  /**
+   * Signals the render thread that a list was submitted, and the simulation thread that one finished.
+   */
+  std::condition_variable listSubmitted;
+  std::condition_variable listFinished;
+
+  /**
+   * The render thread, when threaded.
+   */
+  std::thread thread;
+};
+
+#endif
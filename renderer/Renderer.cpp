@@ -4,23 +4,174 @@
  */
 
 #include "Renderer.h"
+#include "../shader/UniformBlocks.h"
+#include "../gl/GLApi.h"
+#include "../gl/GLState.h"
+#include <cstring>
 
-Renderer::Renderer(Camera* camera, ShaderProgram* shaderProgram)
-  : camera(camera), shaderProgram(shaderProgram) {}
+namespace {
+  /**
+   * Uniform holding the model matrix of the mesh being drawn.
+   */
+  constexpr UniformName modelUniform("model");
 
-void Renderer::render(Mesh& mesh, const glm::mat4& modelMatrix) {
-  glm::mat4 projectionMatrix = camera -> getProjectionMatrix();
-  glm::mat4 viewMatrix = camera -> getViewMatrix();
+  /**
+   * Initial size of each frame's region of the instance stream in bytes; it grows when a frame needs more.
+   */
+  const size_t instanceStreamRegionSize = 1024 * 1024;
+}
+
+Renderer::Renderer(Camera* camera, ShaderProgram* shaderProgram, bool persistentStreaming)
+  : camera(camera),
+    shaderProgram(shaderProgram),
+    gpuTimer(nullptr),
+    sorting(true),
+    instanceOffset(0) {
+  cameraBuffer = new UniformBuffer(CameraBlockBinding, sizeof(CameraBlock));
+  instanceStream = new StreamBuffer(GL_ARRAY_BUFFER, instanceStreamRegionSize, 3, persistentStreaming);
+
+  // Meshes drawn one at a time leave the instance matrix attribute disabled, so the vertex shader reads its constant
+  // value instead. Make that constant the identity matrix, one column per attribute location
+  for (GLuint column = 0; column < 4; ++column) {
+    GL::VertexAttrib4f(Mesh::instanceMatrixLocation + column,
+      column == 0 ? 1.0f : 0.0f, column == 1 ? 1.0f : 0.0f, column == 2 ? 1.0f : 0.0f, column == 3 ? 1.0f : 0.0f);
+  }
+}
+
+Renderer::~Renderer() {
+  delete instanceStream;
+  delete cameraBuffer;
+}
 
-  // Calculate the Model-View-Projection (MVP) matrix
-  glm::mat4 modelViewProjectionMatrix = projectionMatrix * viewMatrix * modelMatrix;
+void Renderer::beginFrame() {
+  CameraBlock block;
+  block.view = camera -> getViewMatrix();
+  block.projection = camera -> getProjectionMatrix();
+  block.viewProjection = block.projection * block.view;
+  block.position = glm::vec4(camera -> getPosition(), 1.0f);
+  cameraBuffer -> update(&block);
+  instanceStream -> beginFrame();
 
+  stats = RenderStats();
+  GLState::resetStats();
+}
+
+void Renderer::endFrame() {
+  instanceStream -> endFrame();
+}
+
+void Renderer::render(Mesh& mesh, const glm::mat4& modelMatrix) {
   // Apply the shaders when rendering objects to the screen
   shaderProgram -> use();
 
-  // Set the MVP uniform in the shader
-  shaderProgram -> setUniform("modelViewProjection", modelViewProjectionMatrix);
+  // The view and projection come from the Camera uniform block, so only the model matrix changes per draw
+  shaderProgram -> setUniform(modelUniform, modelMatrix);
 
   // Draw the mesh with the active shader
   mesh.draw();
+
+  ++stats.draws;
+  ++stats.programSwitches;
+  ++stats.vertexArrayBinds;
+}
+
+void Renderer::submit(Mesh& mesh, const glm::mat4& modelMatrix, unsigned pass) {
+  float depth = glm::length(glm::vec3(modelMatrix[3]) - camera -> getPosition());
+  uint64_t key = RenderQueue::makeKey(pass, shaderProgram -> getProgramId(), mesh.getVertexArrayId(), 0, depth);
+  queue.submit(key, { shaderProgram, &mesh, modelMatrix });
+}
+
+void Renderer::flush() {
+  if (!sorting) {
+    for (size_t i = 0; i < queue.size(); ++i) {
+      render(*queue[i].mesh, queue[i].modelMatrix);
+    }
+    queue.clear();
+    return;
+  }
+
+  queue.sort();
+
+  // Equal state is adjacent after sorting, so comparing with the previous draw finds every necessary change
+  ShaderProgram* currentProgram = nullptr;
+  Mesh* currentMesh = nullptr;
+  for (size_t i = 0; i < queue.size(); ++i) {
+    const DrawPacket& packet = queue[i];
+
+    if (packet.program != currentProgram) {
+      packet.program -> use();
+      currentProgram = packet.program;
+      ++stats.programSwitches;
+    }
+
+    if (!currentMesh || packet.mesh -> getVertexArrayId() != currentMesh -> getVertexArrayId()) {
+      packet.mesh -> bind();
+      currentMesh = packet.mesh;
+      ++stats.vertexArrayBinds;
+    }
+
+    currentProgram -> setUniform(modelUniform, packet.modelMatrix);
+    packet.mesh -> drawBound();
+    ++stats.draws;
+  }
+
+  queue.clear();
+}
+
+void Renderer::setSorting(bool enabled) {
+  sorting = enabled;
+}
+
+const RenderStats& Renderer::getStats() const {
+  return stats;
+}
+
+void Renderer::renderInstanced(Mesh& mesh, const glm::mat4* modelMatrices, size_t instanceCount) {
+  if (instanceCount == 0) {
+    return;
+  }
+
+  std::memcpy(beginInstances(instanceCount), modelMatrices, instanceCount * sizeof(glm::mat4));
+  renderInstances(mesh, instanceCount);
+}
+
+glm::mat4* Renderer::beginInstances(size_t maxInstanceCount) {
+  return static_cast<glm::mat4*>(instanceStream -> map(maxInstanceCount * sizeof(glm::mat4), sizeof(glm::vec4), instanceOffset));
+}
+
+void Renderer::renderInstances(Mesh& mesh, size_t instanceCount) {
+  instanceStream -> unmap();
+  if (instanceCount == 0) {
+    return;
+  }
+
+  // The model transform comes from the instance attribute, so the uniform one is left at identity
+  shaderProgram -> use();
+  shaderProgram -> setUniform(modelUniform, glm::mat4(1.0f));
+
+  mesh.drawInstanced(instanceStream -> getBufferId(), static_cast<GLsizei>(instanceCount), instanceOffset);
+
+  ++stats.draws;
+  ++stats.programSwitches;
+  ++stats.vertexArrayBinds;
+}
+
+const StreamBuffer& Renderer::getInstanceStream() const {
+  return *instanceStream;
+}
+
+void Renderer::beginPass(const char* name) {
+  if (gpuTimer) {
+    gpuTimer -> begin(name);
+  }
+}
+
+void Renderer::endPass() {
+  if (gpuTimer) {
+    gpuTimer -> end();
+  }
+}
+
+void Renderer::setGpuTimer(GpuTimer* timer) {
+  gpuTimer = timer;
 }
\ No newline at end of file
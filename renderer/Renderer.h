@@ -6,10 +6,36 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include <cstddef>
 #include <glm/glm.hpp>
 #include "../camera/Camera.h"
 #include "../mesh/Mesh.h"
 #include "../shader/ShaderProgram.h"
+#include "../profiler/GpuTimer.h"
+#include "UniformBuffer.h"
+#include "StreamBuffer.h"
+#include "RenderQueue.h"
+
+/**
+ * @struct RenderStats
+ * @brief Counters of the work the Renderer issued to OpenGL since the last beginFrame().
+ */
+struct RenderStats {
+  /**
+   * Number of draw calls, instanced draws counting once.
+   */
+  size_t draws = 0;
+
+  /**
+   * Number of times a shader program was made current.
+   */
+  size_t programSwitches = 0;
+
+  /**
+   * Number of times a vertex array was bound.
+   */
+  size_t vertexArrayBinds = 0;
+};
 
 /**
  * @class Renderer
@@ -17,6 +43,12 @@
  *
  * The Renderer class applies transformations and shaders, providing a
  * way to render 3D objects with model, view, and projection matrices.
+ *
+ * The camera matrices are uploaded once per frame by beginFrame() into the shared Camera uniform block, so each draw
+ * only sets its model matrix.
+ *
+ * Meshes are normally drawn through submit(), which queues them in a RenderQueue, and flush(), which sorts the queue
+ * by pipeline state and switches programs and vertex arrays only where the state actually changes.
  */
 class Renderer {
 public:
@@ -24,16 +56,110 @@ public:
    * @brief Constructs a Renderer object with the specified camera and shader program.
    * @param camera Pointer to a Camera object that provides view and projection matrices.
    * @param shaderProgram Pointer to a ShaderProgram object for handling shaders during rendering.
+   * @param persistentStreaming Whether instance data is streamed through a persistently mapped buffer when the context
+   * supports it, rather than by orphaning.
+   *
+   * Requires a current OpenGL context, as it creates the instance and camera buffers.
+   */
+  Renderer(Camera* camera, ShaderProgram* shaderProgram, bool persistentStreaming = true);
+
+  /**
+   * @brief Destructor that releases the instance and camera buffers.
+   */
+  ~Renderer();
+
+  /**
+   * @brief Uploads the camera matrices for the frame into the shared Camera uniform block.
+   *
+   * Call once per frame, after the camera has been moved and before anything is rendered.
    */
-  Renderer(Camera* camera, ShaderProgram* shaderProgram);
+  void beginFrame();
 
   /**
-   * @brief Renders a given mesh with a specified model matrix.
+   * @brief Marks the end of the frame's rendering, so that its streamed instance data can be reused once the GPU is
+   * done with it.
+   */
+  void endFrame();
+
+  /**
+   * @brief Renders a given mesh with a specified model matrix immediately.
    * @param mesh The mesh to render.
    * @param modelMatrix The model transformation matrix for the mesh.
    */
   void render(Mesh& mesh, const glm::mat4& modelMatrix);
 
+  /**
+   * @brief Queues a mesh to be rendered by the next flush().
+   * @param mesh The mesh to render. It must stay alive until flush().
+   * @param modelMatrix The model transformation matrix for the mesh.
+   * @param pass Render pass; passes are executed in increasing order.
+   */
+  void submit(Mesh& mesh, const glm::mat4& modelMatrix, unsigned pass = 0);
+
+  /**
+   * @brief Renders all queued meshes and empties the queue.
+   *
+   * With sorting enabled the queue is sorted by pipeline state first and redundant program and vertex array changes
+   * are skipped. Without it, every mesh is rendered in submission order exactly as render() would.
+   */
+  void flush();
+
+  /**
+   * @brief Enables or disables sorting of queued draws, for comparing the two.
+   */
+  void setSorting(bool enabled);
+
+  /**
+   * @brief Get the counters of the work issued since the last beginFrame().
+   */
+  const RenderStats& getStats() const;
+
+  /**
+   * @brief Renders many copies of a mesh with one draw call.
+   * @param mesh The mesh to render.
+   * @param modelMatrices Array of model transformation matrices, one per instance.
+   * @param instanceCount Number of matrices in modelMatrices.
+   *
+   * The matrices are copied into the instance stream every call, so they may change freely from frame to frame.
+   */
+  void renderInstanced(Mesh& mesh, const glm::mat4* modelMatrices, size_t instanceCount);
+
+  /**
+   * @brief Allocates room for instance matrices in the instance stream, for writing them without an extra copy.
+   * @param maxInstanceCount Maximum number of matrices the caller will write.
+   * @return Write-only pointer to the matrices, valid until renderInstances().
+   */
+  glm::mat4* beginInstances(size_t maxInstanceCount);
+
+  /**
+   * @brief Renders many copies of a mesh with one draw call, using the matrices written since beginInstances().
+   * @param mesh The mesh to render.
+   * @param instanceCount Number of matrices written, at most the count passed to beginInstances().
+   */
+  void renderInstances(Mesh& mesh, size_t instanceCount);
+
+  /**
+   * @brief Get the stream that instance matrices are written to, e.g. for its statistics.
+   */
+  const StreamBuffer& getInstanceStream() const;
+
+  /**
+   * @brief Starts a render pass, timing it on the GPU when a GpuTimer is set.
+   * @param name Name of the pass, with static storage duration.
+   */
+  void beginPass(const char* name);
+
+  /**
+   * @brief Ends the current render pass.
+   */
+  void endPass();
+
+  /**
+   * @brief Sets the timer used to measure the GPU time of each render pass.
+   * @param timer Pointer to a GpuTimer, or nullptr to disable GPU timing.
+   */
+  void setGpuTimer(GpuTimer* timer);
+
 private:
   /**
    * Pointer to the Camera object, used to retrieve view and projection matrices.
@@ -44,6 +170,41 @@ private:
    * Pointer to the ShaderProgram object, which manages shader compilation, linking, and usage.
    */
   ShaderProgram* shaderProgram;
+
+  /**
+   * Pointer to the GpuTimer measuring render passes, or nullptr when GPU timing is disabled.
+   */
+  GpuTimer* gpuTimer;
+
+  /**
+   * Draws submitted since the last flush().
+   */
+  RenderQueue queue;
+
+  /**
+   * Whether flush() sorts the queue by pipeline state.
+   */
+  bool sorting;
+
+  /**
+   * Counters of the work issued since the last beginFrame().
+   */
+  RenderStats stats;
+
+  /**
+   * Pointer to the buffer holding the Camera uniform block shared by all programs.
+   */
+  UniformBuffer* cameraBuffer;
+
+  /**
+   * Pointer to the buffer that per-instance model matrices are streamed into.
+   */
+  StreamBuffer* instanceStream;
+
+  /**
+   * Offset within the instance stream of the matrices allocated by the last beginInstances().
+   */
+  size_t instanceOffset;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,610 @@
+/**
+ * @file SoftwareRenderer.cpp
+ * @brief Implements the SoftwareRenderer class, which rasterizes meshes on the CPU.
+ */
+
+#include "SoftwareRenderer.h"
+#include "../gl/GLApi.h"
+#include "../gl/GLState.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+  /**
+   * Width and height of a screen tile in pixels; a tile's colors and depths fit comfortably in the L1 cache.
+   */
+  const int tileSize = 32;
+
+  /**
+   * Number of fractional bits of the window coordinates that vertices are snapped to.
+   */
+  const int subpixelBits = 4;
+  const int32_t subpixelScale = 1 << subpixelBits;
+
+  /**
+   * How far beyond the view triangles may reach, as a multiple of the view size, before they are clipped. Wide enough
+   * that few visible triangles need clipping, and small enough to keep snapped coordinates far from overflowing.
+   */
+  const float guardBand = 4.0f;
+
+  /**
+   * Number of instances set up by each job of renderInstanced().
+   */
+  const size_t instanceGrainSize = 64;
+
+  /**
+   * Planes the triangles are clipped against, in clip space: a vertex is inside when the dot product with (x, y, z, w)
+   * is not negative. Near and far first, then the guard band.
+   */
+  const glm::vec4 clipPlanes[] = {
+    glm::vec4(0.0f, 0.0f, 1.0f, 1.0f),
+    glm::vec4(0.0f, 0.0f, -1.0f, 1.0f),
+    glm::vec4(1.0f, 0.0f, 0.0f, guardBand),
+    glm::vec4(-1.0f, 0.0f, 0.0f, guardBand),
+    glm::vec4(0.0f, 1.0f, 0.0f, guardBand),
+    glm::vec4(0.0f, -1.0f, 0.0f, guardBand)
+  };
+  const int clipPlaneCount = sizeof(clipPlanes) / sizeof(clipPlanes[0]);
+
+  /**
+   * Largest number of vertices a triangle can have after being clipped by every plane.
+   */
+  const int maxClippedVertices = 3 + clipPlaneCount;
+
+  float planeDistance(const glm::vec4& plane, const glm::vec4& position) {
+    return plane.x * position.x + plane.y * position.y + plane.z * position.z + plane.w * position.w;
+  }
+
+  /**
+   * @brief Returns a mask with a bit set for every clip plane the position lies outside of.
+   */
+  unsigned computeOutcode(const glm::vec4& position) {
+    unsigned outcode = 0;
+    for (int plane = 0; plane < clipPlaneCount; ++plane) {
+      if (planeDistance(clipPlanes[plane], position) < 0.0f) {
+        outcode |= 1u << plane;
+      }
+    }
+    return outcode;
+  }
+
+  /**
+   * @brief Transforms the positions of vertices to clip space, the way the vertex shader does.
+   *
+   * Each result is a sum of the matrix columns weighted by the position's coordinates, so the columns are loaded
+   * once and every vertex costs three broadcasts and multiply-adds.
+   */
+  void transformPositions(const glm::mat4& matrix, const ColorVertex* vertices, size_t count, glm::vec4* output) {
+#if defined(__SSE2__) || defined(_M_X64)
+    __m128 c0 = _mm_loadu_ps(&matrix[0][0]);
+    __m128 c1 = _mm_loadu_ps(&matrix[1][0]);
+    __m128 c2 = _mm_loadu_ps(&matrix[2][0]);
+    __m128 c3 = _mm_loadu_ps(&matrix[3][0]);
+    for (size_t i = 0; i < count; ++i) {
+      const float* position = vertices[i].position;
+      __m128 result = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(position[0])), _mm_mul_ps(c1, _mm_set1_ps(position[1]))),
+        _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(position[2])), c3));
+      _mm_storeu_ps(&output[i][0], result);
+    }
+#elif defined(__ARM_NEON)
+    float32x4_t c0 = vld1q_f32(&matrix[0][0]);
+    float32x4_t c1 = vld1q_f32(&matrix[1][0]);
+    float32x4_t c2 = vld1q_f32(&matrix[2][0]);
+    float32x4_t c3 = vld1q_f32(&matrix[3][0]);
+    for (size_t i = 0; i < count; ++i) {
+      const float* position = vertices[i].position;
+      float32x4_t result = vmlaq_n_f32(c3, c0, position[0]);
+      result = vmlaq_n_f32(result, c1, position[1]);
+      result = vmlaq_n_f32(result, c2, position[2]);
+      vst1q_f32(&output[i][0], result);
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+      const float* position = vertices[i].position;
+      output[i] = matrix * glm::vec4(position[0], position[1], position[2], 1.0f);
+    }
+#endif
+  }
+
+  /**
+   * Indices of the interpolated attributes in Triangle::planes.
+   */
+  enum Attribute {
+    DepthAttribute,
+    InverseWAttribute,
+    RedAttribute,
+    GreenAttribute,
+    BlueAttribute,
+    AttributeCount
+  };
+
+  /**
+   * @brief Converts a color to RGBA bytes in memory order, with full opacity, rounding as OpenGL does.
+   */
+  uint32_t packColor(float red, float green, float blue) {
+    uint32_t r = static_cast<uint32_t>(std::min(std::max(red, 0.0f), 1.0f) * 255.0f + 0.5f);
+    uint32_t g = static_cast<uint32_t>(std::min(std::max(green, 0.0f), 1.0f) * 255.0f + 0.5f);
+    uint32_t b = static_cast<uint32_t>(std::min(std::max(blue, 0.0f), 1.0f) * 255.0f + 0.5f);
+    return r | (g << 8) | (b << 16) | (255u << 24);
+  }
+
+  /**
+   * @brief Depth tests and shades one pixel of a span.
+   * @param start Value of every attribute at the first pixel of the span.
+   * @param step Change of every attribute from one pixel to the next.
+   * @param offset Position of the pixel within the span.
+   */
+  void shadePixel(const float* start, const float* step, int offset, float& depth, uint32_t& color) {
+    float position = static_cast<float>(offset);
+    float fragmentDepth = start[DepthAttribute] + step[DepthAttribute] * position;
+    if (fragmentDepth < depth) {
+      depth = fragmentDepth;
+      float w = 1.0f / (start[InverseWAttribute] + step[InverseWAttribute] * position);
+      color = packColor((start[RedAttribute] + step[RedAttribute] * position) * w,
+                        (start[GreenAttribute] + step[GreenAttribute] * position) * w,
+                        (start[BlueAttribute] + step[BlueAttribute] * position) * w);
+    }
+  }
+
+  /**
+   * @brief Depth tests and shades a span of covered pixels within a row, the way the fragment shader does.
+   * @param start Value of every attribute at the first pixel of the span.
+   * @param step Change of every attribute from one pixel to the next.
+   * @param count Number of pixels in the span.
+   * @param depths Depths of the span's pixels.
+   * @param colors Colors of the span's pixels.
+   *
+   * Four pixels are shaded at once; the ones failing the depth test keep their values through masking.
+   */
+  void shadeSpan(const float* start, const float* step, int count, float* depths, uint32_t* colors) {
+    int offset = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+    __m128 lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    __m128 zero = _mm_setzero_ps();
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 scale = _mm_set1_ps(255.0f);
+    __m128 half = _mm_set1_ps(0.5f);
+    __m128i alpha = _mm_set1_epi32(static_cast<int>(0xff000000u));
+    for (; offset + 4 <= count; offset += 4) {
+      __m128 position = _mm_add_ps(_mm_set1_ps(static_cast<float>(offset)), lanes);
+      __m128 depth = _mm_add_ps(_mm_set1_ps(start[DepthAttribute]), _mm_mul_ps(_mm_set1_ps(step[DepthAttribute]), position));
+      __m128 storedDepth = _mm_loadu_ps(depths + offset);
+      __m128 passed = _mm_cmplt_ps(depth, storedDepth);
+      if (_mm_movemask_ps(passed) == 0) {
+        continue;
+      }
+
+      __m128 inverseW = _mm_add_ps(_mm_set1_ps(start[InverseWAttribute]), _mm_mul_ps(_mm_set1_ps(step[InverseWAttribute]), position));
+      __m128 w = _mm_div_ps(one, inverseW);
+      __m128i channels[3];
+      for (int channel = 0; channel < 3; ++channel) {
+        __m128 value = _mm_add_ps(_mm_set1_ps(start[RedAttribute + channel]),
+                                  _mm_mul_ps(_mm_set1_ps(step[RedAttribute + channel]), position));
+        value = _mm_min_ps(_mm_max_ps(_mm_mul_ps(value, w), zero), one);
+        channels[channel] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, scale), half));
+      }
+      __m128i color = _mm_or_si128(_mm_or_si128(channels[0], _mm_slli_epi32(channels[1], 8)),
+                                   _mm_or_si128(_mm_slli_epi32(channels[2], 16), alpha));
+
+      __m128i mask = _mm_castps_si128(passed);
+      __m128i storedColor = _mm_loadu_si128(reinterpret_cast<const __m128i*>(colors + offset));
+      _mm_storeu_ps(depths + offset, _mm_or_ps(_mm_and_ps(passed, depth), _mm_andnot_ps(passed, storedDepth)));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(colors + offset),
+                       _mm_or_si128(_mm_and_si128(mask, color), _mm_andnot_si128(mask, storedColor)));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const float lanesValues[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+    float32x4_t lanes = vld1q_f32(lanesValues);
+    float32x4_t zero = vdupq_n_f32(0.0f);
+    float32x4_t one = vdupq_n_f32(1.0f);
+    uint32x4_t alpha = vdupq_n_u32(0xff000000u);
+    for (; offset + 4 <= count; offset += 4) {
+      float32x4_t position = vaddq_f32(vdupq_n_f32(static_cast<float>(offset)), lanes);
+      float32x4_t depth = vmlaq_n_f32(vdupq_n_f32(start[DepthAttribute]), position, step[DepthAttribute]);
+      float32x4_t storedDepth = vld1q_f32(depths + offset);
+      uint32x4_t passed = vcltq_f32(depth, storedDepth);
+      if (vmaxvq_u32(passed) == 0) {
+        continue;
+      }
+
+      float32x4_t inverseW = vmlaq_n_f32(vdupq_n_f32(start[InverseWAttribute]), position, step[InverseWAttribute]);
+      float32x4_t w = vdivq_f32(one, inverseW);
+      uint32x4_t channels[3];
+      for (int channel = 0; channel < 3; ++channel) {
+        float32x4_t value = vmlaq_n_f32(vdupq_n_f32(start[RedAttribute + channel]), position, step[RedAttribute + channel]);
+        value = vminq_f32(vmaxq_f32(vmulq_f32(value, w), zero), one);
+        channels[channel] = vcvtq_u32_f32(vmlaq_n_f32(vdupq_n_f32(0.5f), value, 255.0f));
+      }
+      uint32x4_t color = vorrq_u32(vorrq_u32(channels[0], vshlq_n_u32(channels[1], 8)),
+                                   vorrq_u32(vshlq_n_u32(channels[2], 16), alpha));
+
+      vst1q_f32(depths + offset, vbslq_f32(passed, depth, storedDepth));
+      vst1q_u32(colors + offset, vbslq_u32(passed, color, vld1q_u32(colors + offset)));
+    }
+#endif
+    for (; offset < count; ++offset) {
+      shadePixel(start, step, offset, depths[offset], colors[offset]);
+    }
+  }
+
+  double secondsSince(std::chrono::steady_clock::time_point start) {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+  }
+}
+
+SoftwareRenderer::SoftwareRenderer(Camera* camera, JobSystem* jobSystem, int width, int height)
+  : camera(camera),
+    jobSystem(jobSystem),
+    width(width),
+    height(height),
+    tileColumns((width + tileSize - 1) / tileSize),
+    tileRows((height + tileSize - 1) / tileSize),
+    viewProjection(1.0f),
+    colorBuffer(static_cast<size_t>(width) * height, 0),
+    depthBuffer(static_cast<size_t>(width) * height, 1.0f),
+    bins(static_cast<size_t>(tileColumns) * tileRows),
+    textureId(0),
+    framebufferId(0) {}
+
+SoftwareRenderer::~SoftwareRenderer() {
+  if (framebufferId) {
+    GL::DeleteFramebuffers(1, &framebufferId);
+    GLState::deleteTexture(textureId);
+  }
+}
+
+void SoftwareRenderer::beginFrame() {
+  viewProjection = camera -> getProjectionMatrix() * camera -> getViewMatrix();
+  triangles.clear();
+  for (std::vector<uint32_t>& bin : bins) {
+    bin.clear();
+  }
+  stats = SoftwareRenderStats();
+}
+
+void SoftwareRenderer::endFrame() {
+  auto start = std::chrono::steady_clock::now();
+
+  // Tiles cover disjoint pixels, so they need no synchronization
+  jobSystem -> parallelFor(bins.size(), 1, [this](size_t begin, size_t end) {
+    for (size_t tile = begin; tile < end; ++tile) {
+      rasterizeTile(tile);
+    }
+  });
+
+  stats.rasterTime += secondsSince(start);
+}
+
+void SoftwareRenderer::render(Mesh& mesh, const glm::mat4& modelMatrix) {
+  auto start = std::chrono::steady_clock::now();
+
+  if (jobTriangles.empty()) {
+    jobTriangles.resize(1);
+  }
+  jobTriangles[0].clear();
+  setupInstances(mesh, &modelMatrix, 1, jobTriangles[0], stats);
+  binTriangles(jobTriangles[0]);
+  ++stats.draws;
+
+  stats.setupTime += secondsSince(start);
+}
+
+void SoftwareRenderer::renderInstanced(Mesh& mesh, const glm::mat4* modelMatrices, size_t instanceCount) {
+  auto start = std::chrono::steady_clock::now();
+
+  // Every job sets up its own range of instances; binning their triangles job by job afterwards keeps the
+  // submission order, and with it the image, independent of which thread ran which job
+  size_t jobCount = (instanceCount + instanceGrainSize - 1) / instanceGrainSize;
+  if (jobTriangles.size() < jobCount) {
+    jobTriangles.resize(jobCount);
+  }
+  std::vector<SoftwareRenderStats> jobCounters(jobCount);
+
+  jobSystem -> parallelFor(instanceCount, instanceGrainSize, [&](size_t begin, size_t end) {
+    size_t job = begin / instanceGrainSize;
+    jobTriangles[job].clear();
+    setupInstances(mesh, modelMatrices + begin, end - begin, jobTriangles[job], jobCounters[job]);
+  });
+
+  for (size_t job = 0; job < jobCount; ++job) {
+    binTriangles(jobTriangles[job]);
+    stats.trianglesSubmitted += jobCounters[job].trianglesSubmitted;
+    stats.trianglesCulled += jobCounters[job].trianglesCulled;
+    stats.trianglesClipped += jobCounters[job].trianglesClipped;
+  }
+  stats.draws += instanceCount;
+
+  stats.setupTime += secondsSince(start);
+}
+
+void SoftwareRenderer::setupInstances(const Mesh& mesh, const glm::mat4* modelMatrices, size_t instanceCount,
+                                      std::vector<Triangle>& output, SoftwareRenderStats& counters) const {
+  const std::vector<ColorVertex>& vertices = mesh.getCpuVertices();
+  const std::vector<GLuint>& indices = mesh.getCpuIndices();
+
+  // Scratch space of the calling thread, reused from draw to draw
+  thread_local std::vector<glm::vec4> positions;
+  thread_local std::vector<unsigned> outcodes;
+  positions.resize(vertices.size());
+  outcodes.resize(vertices.size());
+
+  for (size_t instance = 0; instance < instanceCount; ++instance) {
+    transformPositions(viewProjection * modelMatrices[instance], vertices.data(), vertices.size(), positions.data());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+      outcodes[i] = computeOutcode(positions[i]);
+    }
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+      GLuint a = indices[i], b = indices[i + 1], c = indices[i + 2];
+      ++counters.trianglesSubmitted;
+
+      // Entirely outside one of the planes
+      if (outcodes[a] & outcodes[b] & outcodes[c]) {
+        ++counters.trianglesCulled;
+        continue;
+      }
+
+      glm::vec4 clipPositions[maxClippedVertices] = { positions[a], positions[b], positions[c] };
+      glm::vec3 clipColors[maxClippedVertices] = {
+        glm::vec3(vertices[a].color[0], vertices[a].color[1], vertices[a].color[2]),
+        glm::vec3(vertices[b].color[0], vertices[b].color[1], vertices[b].color[2]),
+        glm::vec3(vertices[c].color[0], vertices[c].color[1], vertices[c].color[2])
+      };
+
+      // Entirely inside every plane, the common case
+      unsigned crossed = outcodes[a] | outcodes[b] | outcodes[c];
+      if (!crossed) {
+        if (!setupTriangle(clipPositions, clipColors, output)) {
+          ++counters.trianglesCulled;
+        }
+        continue;
+      }
+
+      // Cut the polygon by every plane it crosses, keeping the part inside
+      ++counters.trianglesClipped;
+      int vertexCount = 3;
+      for (int plane = 0; plane < clipPlaneCount && vertexCount >= 3; ++plane) {
+        if (!(crossed & (1u << plane))) {
+          continue;
+        }
+
+        glm::vec4 keptPositions[maxClippedVertices];
+        glm::vec3 keptColors[maxClippedVertices];
+        int keptCount = 0;
+        for (int current = 0; current < vertexCount; ++current) {
+          int next = (current + 1) % vertexCount;
+          float currentDistance = planeDistance(clipPlanes[plane], clipPositions[current]);
+          float nextDistance = planeDistance(clipPlanes[plane], clipPositions[next]);
+
+          if (currentDistance >= 0.0f) {
+            keptPositions[keptCount] = clipPositions[current];
+            keptColors[keptCount++] = clipColors[current];
+          }
+          if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f)) {
+            float t = currentDistance / (currentDistance - nextDistance);
+            keptPositions[keptCount] = clipPositions[current] + (clipPositions[next] - clipPositions[current]) * t;
+            keptColors[keptCount++] = clipColors[current] + (clipColors[next] - clipColors[current]) * t;
+          }
+        }
+
+        vertexCount = keptCount;
+        std::copy(keptPositions, keptPositions + keptCount, clipPositions);
+        std::copy(keptColors, keptColors + keptCount, clipColors);
+      }
+
+      // The clipped polygon is convex, so a fan around its first vertex covers it
+      for (int i = 1; i + 1 < vertexCount; ++i) {
+        glm::vec4 fanPositions[3] = { clipPositions[0], clipPositions[i], clipPositions[i + 1] };
+        glm::vec3 fanColors[3] = { clipColors[0], clipColors[i], clipColors[i + 1] };
+        setupTriangle(fanPositions, fanColors, output);
+      }
+    }
+  }
+}
+
+bool SoftwareRenderer::setupTriangle(const glm::vec4* positions, const glm::vec3* colors, std::vector<Triangle>& output) const {
+  Triangle triangle;
+  float attributes[3][AttributeCount];
+  for (int i = 0; i < 3; ++i) {
+    // Perspective divide and viewport transform, snapping to the subpixel grid
+    float inverseW = 1.0f / positions[i].w;
+    float windowX = (positions[i].x * inverseW * 0.5f + 0.5f) * width;
+    float windowY = (positions[i].y * inverseW * 0.5f + 0.5f) * height;
+    triangle.x[i] = static_cast<int32_t>(std::floor(windowX * subpixelScale + 0.5f));
+    triangle.y[i] = static_cast<int32_t>(std::floor(windowY * subpixelScale + 0.5f));
+
+    attributes[i][DepthAttribute] = positions[i].z * inverseW * 0.5f + 0.5f;
+    attributes[i][InverseWAttribute] = inverseW;
+    attributes[i][RedAttribute] = colors[i].x * inverseW;
+    attributes[i][GreenAttribute] = colors[i].y * inverseW;
+    attributes[i][BlueAttribute] = colors[i].z * inverseW;
+  }
+
+  // Counter-clockwise triangles face the camera, and have a positive area with y pointing up
+  triangle.area = static_cast<int64_t>(triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0])
+                - static_cast<int64_t>(triangle.y[1] - triangle.y[0]) * (triangle.x[2] - triangle.x[0]);
+  if (triangle.area <= 0) {
+    return false;
+  }
+
+  // Pixels whose centers, at half pixel offsets, lie within the bounding box
+  int32_t half = subpixelScale / 2;
+  int32_t minX = std::min(triangle.x[0], std::min(triangle.x[1], triangle.x[2]));
+  int32_t maxX = std::max(triangle.x[0], std::max(triangle.x[1], triangle.x[2]));
+  int32_t minY = std::min(triangle.y[0], std::min(triangle.y[1], triangle.y[2]));
+  int32_t maxY = std::max(triangle.y[0], std::max(triangle.y[1], triangle.y[2]));
+  triangle.minX = std::max(0, (minX - half + subpixelScale - 1) >> subpixelBits);
+  triangle.maxX = std::min(width - 1, (maxX - half) >> subpixelBits);
+  triangle.minY = std::max(0, (minY - half + subpixelScale - 1) >> subpixelBits);
+  triangle.maxY = std::min(height - 1, (maxY - half) >> subpixelBits);
+  if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) {
+    return false;
+  }
+
+  // The gradients of each attribute over the window, from the snapped vertex positions in pixels
+  double deltaX1 = static_cast<double>(triangle.x[1] - triangle.x[0]) / subpixelScale;
+  double deltaY1 = static_cast<double>(triangle.y[1] - triangle.y[0]) / subpixelScale;
+  double deltaX2 = static_cast<double>(triangle.x[2] - triangle.x[0]) / subpixelScale;
+  double deltaY2 = static_cast<double>(triangle.y[2] - triangle.y[0]) / subpixelScale;
+  double inverseArea = 1.0 / (deltaX1 * deltaY2 - deltaX2 * deltaY1);
+  for (int attribute = 0; attribute < AttributeCount; ++attribute) {
+    double change1 = static_cast<double>(attributes[1][attribute]) - attributes[0][attribute];
+    double change2 = static_cast<double>(attributes[2][attribute]) - attributes[0][attribute];
+    triangle.planes[attribute][0] = attributes[0][attribute];
+    triangle.planes[attribute][1] = static_cast<float>((change1 * deltaY2 - change2 * deltaY1) * inverseArea);
+    triangle.planes[attribute][2] = static_cast<float>((change2 * deltaX1 - change1 * deltaX2) * inverseArea);
+  }
+
+  output.push_back(triangle);
+  return true;
+}
+
+void SoftwareRenderer::binTriangles(const std::vector<Triangle>& setup) {
+  for (const Triangle& triangle : setup) {
+    uint32_t index = static_cast<uint32_t>(triangles.size());
+    triangles.push_back(triangle);
+
+    for (int row = triangle.minY / tileSize; row <= triangle.maxY / tileSize; ++row) {
+      for (int column = triangle.minX / tileSize; column <= triangle.maxX / tileSize; ++column) {
+        bins[row * tileColumns + column].push_back(index);
+        ++stats.tileTriangles;
+      }
+    }
+  }
+}
+
+void SoftwareRenderer::rasterizeTile(size_t tile) {
+  int tileMinX = static_cast<int>(tile % tileColumns) * tileSize;
+  int tileMinY = static_cast<int>(tile / tileColumns) * tileSize;
+  int tileMaxX = std::min(width, tileMinX + tileSize) - 1;
+  int tileMaxY = std::min(height, tileMinY + tileSize) - 1;
+
+  // Clear to transparent black and the far plane, as glClear() does with the default clear values
+  for (int y = tileMinY; y <= tileMaxY; ++y) {
+    size_t rowStart = static_cast<size_t>(y) * width;
+    std::fill(colorBuffer.begin() + rowStart + tileMinX, colorBuffer.begin() + rowStart + tileMaxX + 1, 0u);
+    std::fill(depthBuffer.begin() + rowStart + tileMinX, depthBuffer.begin() + rowStart + tileMaxX + 1, 1.0f);
+  }
+
+  for (uint32_t index : bins[tile]) {
+    const Triangle& triangle = triangles[index];
+    rasterizeTriangle(triangle, std::max(triangle.minX, tileMinX), std::max(triangle.minY, tileMinY),
+                      std::min(triangle.maxX, tileMaxX), std::min(triangle.maxY, tileMaxY));
+  }
+}
+
+void SoftwareRenderer::rasterizeTriangle(const Triangle& triangle, int minX, int minY, int maxX, int maxY) {
+  // Edge i lies opposite vertex i. Its function is positive inside the triangle and grows linearly, so it is
+  // evaluated once at the first pixel center and then stepped. Pixel centers exactly on an edge belong to the
+  // triangle only if the edge is a top or left one, so that triangles sharing an edge never both draw a pixel
+  int64_t startX = static_cast<int64_t>(minX) * subpixelScale + subpixelScale / 2;
+  int64_t startY = static_cast<int64_t>(minY) * subpixelScale + subpixelScale / 2;
+  int64_t rowEdges[3], stepX[3], stepY[3];
+  for (int edge = 0; edge < 3; ++edge) {
+    int from = (edge + 1) % 3;
+    int to = (edge + 2) % 3;
+    int64_t deltaX = triangle.x[to] - triangle.x[from];
+    int64_t deltaY = triangle.y[to] - triangle.y[from];
+    bool topLeft = deltaY < 0 || (deltaY == 0 && deltaX < 0);
+    rowEdges[edge] = deltaX * (startY - triangle.y[from]) - deltaY * (startX - triangle.x[from]) - (topLeft ? 0 : 1);
+    stepX[edge] = -deltaY * subpixelScale;
+    stepY[edge] = deltaX * subpixelScale;
+  }
+
+  float originX = triangle.x[0] / static_cast<float>(subpixelScale);
+  float originY = triangle.y[0] / static_cast<float>(subpixelScale);
+  float step[AttributeCount];
+  for (int attribute = 0; attribute < AttributeCount; ++attribute) {
+    step[attribute] = triangle.planes[attribute][1];
+  }
+
+  int columns = maxX - minX + 1;
+  for (int y = minY; y <= maxY; ++y) {
+    // The pixels where every edge function is not negative form one span; solve for its ends exactly
+    int first = 0;
+    int last = columns - 1;
+    for (int edge = 0; edge < 3 && first <= last; ++edge) {
+      int64_t value = rowEdges[edge];
+      int64_t slope = stepX[edge];
+      if (slope > 0) {
+        if (value < 0) {
+          first = static_cast<int>(std::max<int64_t>(first, (-value + slope - 1) / slope));
+        }
+      } else if (slope < 0) {
+        last = value < 0 ? -1 : static_cast<int>(std::min<int64_t>(last, value / -slope));
+      } else if (value < 0) {
+        last = -1;
+      }
+    }
+
+    if (first <= last) {
+      // Attribute values at the first pixel center of the span
+      float deltaX = minX + first + 0.5f - originX;
+      float deltaY = y + 0.5f - originY;
+      float start[AttributeCount];
+      for (int attribute = 0; attribute < AttributeCount; ++attribute) {
+        start[attribute] = triangle.planes[attribute][0] + triangle.planes[attribute][1] * deltaX
+                         + triangle.planes[attribute][2] * deltaY;
+      }
+
+      size_t rowStart = static_cast<size_t>(y) * width + minX + first;
+      shadeSpan(start, step, last - first + 1, depthBuffer.data() + rowStart, colorBuffer.data() + rowStart);
+    }
+
+    rowEdges[0] += stepY[0];
+    rowEdges[1] += stepY[1];
+    rowEdges[2] += stepY[2];
+  }
+}
+
+void SoftwareRenderer::present(int targetWidth, int targetHeight) {
+  if (!framebufferId) {
+    GL::GenTextures(1, &textureId);
+    GLState::bindTexture2D(0, textureId);
+    GL::TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    GL::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    GL::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    GL::GenFramebuffers(1, &framebufferId);
+    GL::BindFramebuffer(GL_READ_FRAMEBUFFER, framebufferId);
+    GL::FramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textureId, 0);
+  }
+
+  // The asset staging buffer may still be bound for unpacking, which would make the upload read from it
+  GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+  GLState::bindTexture2D(0, textureId);
+  GL::TexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, colorBuffer.data());
+
+  // Blit from the texture, then point reads back at the target so that glReadPixels() still sees the frame
+  GLint targetFramebuffer = 0;
+  GL::GetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &targetFramebuffer);
+  GL::BindFramebuffer(GL_READ_FRAMEBUFFER, framebufferId);
+  GL::BlitFramebuffer(0, 0, width, height, 0, 0, targetWidth, targetHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+  GL::BindFramebuffer(GL_READ_FRAMEBUFFER, targetFramebuffer);
+}
+
+const std::vector<uint32_t>& SoftwareRenderer::getPixels() const {
+  return colorBuffer;
+}
+
+int SoftwareRenderer::getWidth() const {
+  return width;
+}
+
+int SoftwareRenderer::getHeight() const {
+  return height;
+}
+
+const SoftwareRenderStats& SoftwareRenderer::getStats() const {
+  return stats;
+}
@@ -0,0 +1,276 @@
+/**
+ * @file SoftwareRenderer.h
+ * @brief Declares the SoftwareRenderer class, which rasterizes meshes on the CPU.
+ */
+
+#ifndef SOFTWARE_RENDERER_H
+#define SOFTWARE_RENDERER_H
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../camera/Camera.h"
+#include "../mesh/Mesh.h"
+#include "../jobs/JobSystem.h"
+
+/**
+ * @struct SoftwareRenderStats
+ * @brief Counters of the work the SoftwareRenderer did since the last beginFrame().
+ */
+struct SoftwareRenderStats {
+  /**
+   * Number of render() calls, plus one per instance of every renderInstanced() call.
+   */
+  size_t draws = 0;
+
+  /**
+   * Number of triangles submitted, before any culling.
+   */
+  size_t trianglesSubmitted = 0;
+
+  /**
+   * Number of triangles culled for facing away, being degenerate or lying outside the view.
+   */
+  size_t trianglesCulled = 0;
+
+  /**
+   * Number of triangles that crossed a clip plane and were cut into smaller ones.
+   */
+  size_t trianglesClipped = 0;
+
+  /**
+   * Number of triangles rasterized, each counted once per tile it overlaps.
+   */
+  size_t tileTriangles = 0;
+
+  /**
+   * Time spent transforming, clipping and binning triangles, in seconds.
+   */
+  double setupTime = 0;
+
+  /**
+   * Time spent rasterizing the tiles, in seconds.
+   */
+  double rasterTime = 0;
+};
+
+/**
+ * @class SoftwareRenderer
+ * @brief Draws meshes into a framebuffer in memory, without a GPU.
+ *
+ * Honors the contract of the Renderer with the scene shaders: every vertex is transformed by the camera's view
+ * projection and the draw's model matrix, back faces are culled, fragments pass the depth test when closer than the
+ * stored depth, and the vertex colors are interpolated with perspective correction as the fragment shader outputs them.
+ *
+ * Vertices are transformed with SIMD as soon as a mesh is drawn. The resulting triangles are clipped, snapped to a
+ * 1/16 pixel grid and sorted into bins of screen tiles, and endFrame() rasterizes the tiles in parallel on the job
+ * system. Each tile is owned by one job and draws its triangles in submission order: exact integer edge functions
+ * with the top-left fill rule find the covered span of every row, which is then depth tested and shaded with SIMD.
+ * The image is watertight and bit-identical whatever the number of threads.
+ *
+ * Only meshes that keep their vertices in memory (see Mesh::getCpuVertices()) can be drawn; others draw nothing. The framebuffer can be copied to the current OpenGL framebuffer with present().
+ */
+class SoftwareRenderer {
+public:
+  /**
+   * @brief Constructs a SoftwareRenderer with a framebuffer of the given size.
+   * @param camera Pointer to the camera providing the view and projection matrices.
+   * @param jobSystem Pointer to the job system the tiles are rasterized on.
+   * @param width Width of the framebuffer in pixels.
+   * @param height Height of the framebuffer in pixels.
+   *
+   * Does not need an OpenGL context, unless present() is used.
+   */
+  SoftwareRenderer(Camera* camera, JobSystem* jobSystem, int width, int height);
+
+  /**
+   * @brief Releases the OpenGL objects created by present(), if any.
+   */
+  ~SoftwareRenderer();
+
+  /**
+   * @brief Starts a new frame with the current camera, discarding the triangles of the previous one.
+   */
+  void beginFrame();
+
+  /**
+   * @brief Rasterizes every tile, leaving the finished frame in the framebuffer.
+   */
+  void endFrame();
+
+  /**
+   * @brief Draws a mesh into the current frame.
+   * @param mesh The mesh to render. Its data is processed right away, so it does not need to outlive the call.
+   * @param modelMatrix The model matrix applied to the mesh.
+   */
+  void render(Mesh& mesh, const glm::mat4& modelMatrix);
+
+  /**
+   * @brief Draws many copies of a mesh into the current frame, transforming the copies in parallel.
+   * @param mesh The mesh to render.
+   * @param modelMatrices Model matrix of each copy.
+   * @param instanceCount Number of copies.
+   */
+  void renderInstanced(Mesh& mesh, const glm::mat4* modelMatrices, size_t instanceCount);
+
+  /**
+   * @brief Copies the framebuffer into the currently bound OpenGL draw framebuffer, scaled to fill it.
+   * @param targetWidth Width of the draw framebuffer in pixels.
+   * @param targetHeight Height of the draw framebuffer in pixels.
+   *
+   * Pixels are scaled with nearest filtering, so a low resolution frame keeps its hard edges.
+   */
+  void present(int targetWidth, int targetHeight);
+
+  /**
+   * @brief Get the framebuffer as RGBA bytes, bottom row first like glReadPixels(), as of the last endFrame().
+   */
+  const std::vector<uint32_t>& getPixels() const;
+
+  /**
+   * @brief Get the width of the framebuffer in pixels.
+   */
+  int getWidth() const;
+
+  /**
+   * @brief Get the height of the framebuffer in pixels.
+   */
+  int getHeight() const;
+
+  /**
+   * @brief Get the counters of the work done since the last beginFrame().
+   */
+  const SoftwareRenderStats& getStats() const;
+
+private:
+  /**
+   * A triangle ready for rasterization: vertices snapped to the subpixel grid with the attributes they interpolate.
+   */
+  struct Triangle {
+    /**
+     * Window coordinates of the vertices in 1/16 pixels, counter-clockwise.
+     */
+    int32_t x[3];
+    int32_t y[3];
+
+    /**
+     * Attributes interpolated over the triangle: window depth, reciprocal clip space w, and the color divided by w,
+     * which perspective correct interpolation needs. Each is a plane over the window, given by its value at the
+     * first vertex and its change per pixel in x and in y.
+     */
+    float planes[5][3];
+
+    /**
+     * Twice the area of the triangle in squared 1/16 pixels; always positive.
+     */
+    int64_t area;
+
+    /**
+     * Range of pixels whose centers may be covered, inclusive and within the framebuffer.
+     */
+    int minX, minY, maxX, maxY;
+  };
+
+  /**
+   * @brief Transforms, clips and snaps the triangles of copies of a mesh.
+   * @param mesh The mesh to set up.
+   * @param modelMatrices Model matrix of each copy.
+   * @param instanceCount Number of copies.
+   * @param output Receives the triangles that survived culling, in order.
+   * @param counters Receives the number of triangles submitted, culled and clipped.
+   *
+   * Only reads state shared between jobs, so several calls can run in parallel.
+   */
+  void setupInstances(const Mesh& mesh, const glm::mat4* modelMatrices, size_t instanceCount,
+                      std::vector<Triangle>& output, SoftwareRenderStats& counters) const;
+
+  /**
+   * @brief Projects a triangle given in clip space and appends it to output, unless it faces away or covers no pixel.
+   * @return true if the triangle was appended.
+   */
+  bool setupTriangle(const glm::vec4* positions, const glm::vec3* colors, std::vector<Triangle>& output) const;
+
+  /**
+   * @brief Appends triangles to the bins of the tiles they overlap.
+   */
+  void binTriangles(const std::vector<Triangle>& setup);
+
+  /**
+   * @brief Clears a tile and rasterizes the triangles in its bin.
+   * @param tile Index of the tile, row by row from the bottom left.
+   */
+  void rasterizeTile(size_t tile);
+
+  /**
+   * @brief Rasterizes the part of a triangle within a rectangle of pixels.
+   */
+  void rasterizeTriangle(const Triangle& triangle, int minX, int minY, int maxX, int maxY);
+
+  /**
+   * Pointer to the camera providing the view and projection matrices.
+   */
+  Camera* camera;
+
+  /**
+   * Pointer to the job system the setup and rasterization run on.
+   */
+  JobSystem* jobSystem;
+
+  /**
+   * Size of the framebuffer in pixels.
+   */
+  int width;
+  int height;
+
+  /**
+   * Number of tile columns and rows covering the framebuffer.
+   */
+  int tileColumns;
+  int tileRows;
+
+  /**
+   * Projection matrix times view matrix of the camera, taken by beginFrame().
+   */
+  glm::mat4 viewProjection;
+
+  /**
+   * Colors of the framebuffer as packed RGBA bytes, bottom row first.
+   */
+  std::vector<uint32_t> colorBuffer;
+
+  /**
+   * Depths of the framebuffer, in the same order as the colors.
+   */
+  std::vector<float> depthBuffer;
+
+  /**
+   * Triangles of the current frame, in submission order.
+   */
+  std::vector<Triangle> triangles;
+
+  /**
+   * Indices into triangles of the triangles overlapping each tile, in submission order.
+   */
+  std::vector<std::vector<uint32_t>> bins;
+
+  /**
+   * Triangles set up by each job of the last renderInstanced(), kept to reuse their memory.
+   */
+  std::vector<std::vector<Triangle>> jobTriangles;
+
+  /**
+   * Counters of the work done since the last beginFrame().
+   */
+  SoftwareRenderStats stats;
+
+  /**
+   * Texture holding the uploaded framebuffer and the framebuffer object it is read through by present(), or 0 before
+   * the first present().
+   */
+  GLuint textureId;
+  GLuint framebufferId;
+};
+
+#endif
@@ -0,0 +1,160 @@
+/**
+ * @file StreamBuffer.cpp
+ * @brief Implements the StreamBuffer class, which streams per-frame data such as instance transforms to the GPU.
+ */
+
+#include "StreamBuffer.h"
+#include "../gl/GLApi.h"
+#include "../gl/GLState.h"
+#include <chrono>
+
+namespace {
+  /**
+   * How long a single wait for a fence blocks, in nanoseconds, before it is retried.
+   */
+  const GLuint64 fenceWaitTimeout = 1000000;
+}
+
+StreamBuffer::StreamBuffer(GLenum target, size_t regionSize, unsigned regionCount, bool persistent)
+  : target(target),
+    regionSize(regionSize),
+    regionCount(regionCount),
+    persistent(persistent && GLEW_ARB_buffer_storage),
+    bufferId(0),
+    mappedData(nullptr),
+    fences(nullptr),
+    currentRegion(0),
+    writeOffset(0),
+    orphanPending(true) {
+  if (!this -> persistent) {
+    this -> regionCount = 1;
+  }
+
+  fences = new GLsync[this -> regionCount]();
+  createStorage();
+}
+
+StreamBuffer::~StreamBuffer() {
+  for (unsigned i = 0; i < regionCount; ++i) {
+    if (fences[i]) {
+      GL::DeleteSync(fences[i]);
+    }
+  }
+  delete[] fences;
+
+  // Deleting a buffer also unmaps it
+  GLState::deleteBuffer(bufferId);
+}
+
+void StreamBuffer::createStorage() {
+  GL::GenBuffers(1, &bufferId);
+  GLState::bindBuffer(target, bufferId);
+
+  size_t size = regionSize * regionCount;
+  if (persistent) {
+    // Coherent mapping makes CPU writes visible to later draws without explicit flushes
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    GL::BufferStorage(target, size, nullptr, flags);
+    mappedData = static_cast<unsigned char*>(GL::MapBufferRange(target, 0, size, flags));
+  } else {
+    GL::BufferData(target, size, nullptr, GL_STREAM_DRAW);
+  }
+}
+
+void StreamBuffer::waitForFence(GLsync& fence) {
+  // Polling first keeps the common case, a long signaled fence, free of any timing
+  GLenum result = GL::ClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+  if (result == GL_TIMEOUT_EXPIRED) {
+    auto start = std::chrono::steady_clock::now();
+    do {
+      result = GL::ClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, fenceWaitTimeout);
+    } while (result == GL_TIMEOUT_EXPIRED);
+
+    std::chrono::duration<double> waited = std::chrono::steady_clock::now() - start;
+    ++stats.stalls;
+    stats.stallTime += waited.count();
+  }
+
+  GL::DeleteSync(fence);
+  fence = nullptr;
+}
+
+void StreamBuffer::beginFrame() {
+  currentRegion = (currentRegion + 1) % regionCount;
+  writeOffset = 0;
+  orphanPending = true;
+
+  if (fences[currentRegion]) {
+    waitForFence(fences[currentRegion]);
+  }
+}
+
+void StreamBuffer::endFrame() {
+  if (persistent && writeOffset > 0) {
+    fences[currentRegion] = GL::FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  }
+}
+
+void* StreamBuffer::map(size_t size, size_t alignment, size_t& offset) {
+  size_t alignedOffset = (writeOffset + alignment - 1) / alignment * alignment;
+
+  // Grow to fit all of the frame's data so far, so that the next frames fit without growing again. Draws already
+  // issued keep reading the old buffer, which OpenGL keeps alive until they are done, so the new one starts out with
+  // no region in use
+  size_t frameSize = alignedOffset + size;
+  if (frameSize > regionSize) {
+    for (unsigned i = 0; i < regionCount; ++i) {
+      if (fences[i]) {
+        GL::DeleteSync(fences[i]);
+        fences[i] = nullptr;
+      }
+    }
+    GLState::deleteBuffer(bufferId);
+    mappedData = nullptr;
+
+    while (regionSize < frameSize) {
+      regionSize *= 2;
+    }
+    createStorage();
+    ++stats.resizes;
+
+    currentRegion = 0;
+    alignedOffset = 0;
+    orphanPending = false;
+  }
+
+  offset = currentRegion * regionSize + alignedOffset;
+  writeOffset = alignedOffset + size;
+  stats.bytesStreamed += size;
+
+  GLState::bindBuffer(target, bufferId);
+  if (persistent) {
+    return mappedData + offset;
+  }
+
+  // Orphan once per frame; later maps in the frame only touch ranges that no issued draw reads yet
+  if (orphanPending) {
+    GL::BufferData(target, regionSize, nullptr, GL_STREAM_DRAW);
+    orphanPending = false;
+  }
+  return GL::MapBufferRange(target, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+}
+
+void StreamBuffer::unmap() {
+  if (!persistent) {
+    GLState::bindBuffer(target, bufferId);
+    GL::UnmapBuffer(target);
+  }
+}
+
+GLuint StreamBuffer::getBufferId() const {
+  return bufferId;
+}
+
+bool StreamBuffer::isPersistent() const {
+  return persistent;
+}
+
+const StreamBufferStats& StreamBuffer::getStats() const {
+  return stats;
+}
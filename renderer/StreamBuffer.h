@@ -0,0 +1,179 @@
+/**
+ * @file StreamBuffer.h
+ * @brief Declares the StreamBuffer class, which streams per-frame data such as instance transforms to the GPU.
+ */
+
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <GL/glew.h>
+#include <cstddef>
+
+/**
+ * @struct StreamBufferStats
+ * @brief Counters of the data written to a StreamBuffer, over its whole lifetime.
+ */
+struct StreamBufferStats {
+  /**
+   * Number of bytes handed out by map().
+   */
+  size_t bytesStreamed = 0;
+
+  /**
+   * Number of times beginFrame() had to wait for the GPU to finish reading a region.
+   */
+  size_t stalls = 0;
+
+  /**
+   * Total time spent waiting for the GPU in seconds.
+   */
+  double stallTime = 0.0;
+
+  /**
+   * Number of times the buffer had to grow to fit a frame's data.
+   */
+  size_t resizes = 0;
+};
+
+/**
+ * @class StreamBuffer
+ * @brief A ring of frame regions inside one buffer, written by the CPU every frame and read by the GPU.
+ *
+ * When the context supports ARB_buffer_storage, the buffer is created with immutable storage and mapped once,
+ * persistently and coherently. It is split into regionCount regions, and each frame appends its data to the next
+ * region in turn; writes go straight into memory the GPU reads, without glBufferSubData copies. A fence placed by
+ * endFrame() guards each region, and beginFrame() only waits on it when the GPU is still regionCount frames behind,
+ * which in practice means never.
+ *
+ * Without buffer storage the buffer has a single region that is orphaned at the first map() of each frame, and every
+ * map() is an unsynchronized glMapBufferRange of a range no pending draw reads. The driver then hands out fresh
+ * memory instead of stalling, at the cost of a map and unmap per allocation.
+ *
+ * Either way, allocations are only valid until the next beginFrame(), and a frame's data must fit in one region;
+ * map() replaces the buffer with a larger one when it does not.
+ */
+class StreamBuffer {
+public:
+  /**
+   * @brief Creates the buffer. Requires a current OpenGL context.
+   * @param target Buffer target the buffer is bound to when mapped, e.g. GL_ARRAY_BUFFER.
+   * @param regionSize Initial size of each frame region in bytes.
+   * @param regionCount Number of frames that may be in flight before the CPU waits for the GPU.
+   * @param persistent Whether persistent mapping is used when supported; false forces the orphaning fallback.
+   */
+  StreamBuffer(GLenum target, size_t regionSize, unsigned regionCount = 3, bool persistent = true);
+
+  /**
+   * @brief Destructor that releases the buffer and its fences.
+   */
+  ~StreamBuffer();
+
+  /**
+   * @brief Moves on to the next frame region, waiting until the GPU has finished reading it.
+   */
+  void beginFrame();
+
+  /**
+   * @brief Fences the current frame region, once every draw reading it has been issued.
+   */
+  void endFrame();
+
+  /**
+   * @brief Allocates space in the current frame region and returns a pointer the CPU writes the data through.
+   * @param size Number of bytes to allocate.
+   * @param alignment Alignment of the allocation's offset in bytes, e.g. GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
+   * @param offset Receives the offset of the allocation within the buffer, to point attributes or bindings at.
+   * @return Write-only pointer to the allocation, valid until unmap().
+   *
+   * The buffer is left bound to its target. Call getBufferId() afterwards, as growing replaces the buffer.
+   */
+  void* map(size_t size, size_t alignment, size_t& offset);
+
+  /**
+   * @brief Makes the data written since map() visible to the GPU. Call before drawing with it.
+   */
+  void unmap();
+
+  /**
+   * @brief Get the ID of the buffer.
+   */
+  GLuint getBufferId() const;
+
+  /**
+   * @brief Checks whether the buffer is persistently mapped, as opposed to orphaned every frame.
+   */
+  bool isPersistent() const;
+
+  /**
+   * @brief Get the counters of the data written so far.
+   */
+  const StreamBufferStats& getStats() const;
+
+private:
+  /**
+   * @brief Creates the buffer with the current region size, mapping it when persistent.
+   */
+  void createStorage();
+
+  /**
+   * @brief Waits until the GPU has passed a fence, then deletes it.
+   */
+  void waitForFence(GLsync& fence);
+
+  /**
+   * Buffer target the buffer is bound to.
+   */
+  GLenum target;
+
+  /**
+   * Size of each frame region in bytes.
+   */
+  size_t regionSize;
+
+  /**
+   * Number of frame regions; always 1 for the orphaning fallback.
+   */
+  unsigned regionCount;
+
+  /**
+   * Whether the buffer is persistently mapped.
+   */
+  bool persistent;
+
+  /**
+   * Buffer ID.
+   */
+  GLuint bufferId;
+
+  /**
+   * Start of the persistent mapping, or nullptr for the orphaning fallback.
+   */
+  unsigned char* mappedData;
+
+  /**
+   * One fence per region, placed after the last draw of the frame that wrote it, or nullptr when the region is free.
+   */
+  GLsync* fences;
+
+  /**
+   * Index of the region the current frame writes to.
+   */
+  unsigned currentRegion;
+
+  /**
+   * Offset of the next allocation, relative to the start of the current region.
+   */
+  size_t writeOffset;
+
+  /**
+   * Whether the fallback has to orphan the buffer before the next map().
+   */
+  bool orphanPending;
+
+  /**
+   * Counters of the data written so far.
+   */
+  StreamBufferStats stats;
+};
+
+#endif
@@ -0,0 +1,27 @@
+/**
+ * @file UniformBuffer.cpp
+ * @brief Implements the UniformBuffer class, a buffer holding the data of a uniform block.
+ */
+
+#include "UniformBuffer.h"
+#include "../gl/GLApi.h"
+#include "../gl/GLState.h"
+
+UniformBuffer::UniformBuffer(GLuint binding, size_t size)
+  : bufferId(0), binding(binding), size(size) {
+  GL::GenBuffers(1, &bufferId);
+  GLState::bindBuffer(GL_UNIFORM_BUFFER, bufferId);
+  GL::BufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+}
+
+UniformBuffer::~UniformBuffer() {
+  GLState::deleteBuffer(bufferId);
+}
+
+void UniformBuffer::update(const void* data) {
+  // Orphan the previous contents, so the driver never waits for last frame's draws still reading them
+  GLState::bindBuffer(GL_UNIFORM_BUFFER, bufferId);
+  GL::BufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+  GL::BufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+  GLState::bindBufferBase(GL_UNIFORM_BUFFER, binding, bufferId);
+}
@@ -0,0 +1,56 @@
+/**
+ * @file UniformBuffer.h
+ * @brief Declares the UniformBuffer class, a buffer holding the data of a uniform block.
+ */
+
+#ifndef UNIFORM_BUFFER_H
+#define UNIFORM_BUFFER_H
+
+#include <GL/glew.h>
+#include <cstddef>
+
+/**
+ * @class UniformBuffer
+ * @brief Stores the data of one uniform block and binds it to a uniform buffer binding point.
+ *
+ * All programs whose block is attached to the same binding point read the same data, so it is uploaded once no
+ * matter how many programs or draws use it.
+ */
+class UniformBuffer {
+public:
+  /**
+   * @brief Creates the buffer. Requires a current OpenGL context.
+   * @param binding Uniform buffer binding point the data is bound to.
+   * @param size Size of the block data in bytes.
+   */
+  UniformBuffer(GLuint binding, size_t size);
+
+  /**
+   * @brief Destructor that releases the buffer.
+   */
+  ~UniformBuffer();
+
+  /**
+   * @brief Replaces the block data and binds the buffer to its binding point.
+   * @param data Pointer to the new data, of the size given at construction.
+   */
+  void update(const void* data);
+
+private:
+  /**
+   * Buffer object ID.
+   */
+  GLuint bufferId;
+
+  /**
+   * Uniform buffer binding point the buffer is bound to.
+   */
+  GLuint binding;
+
+  /**
+   * Size of the block data in bytes.
+   */
+  size_t size;
+};
+
+#endif
@@ -0,0 +1,167 @@
+/**
+ * @file ShaderCache.cpp
+ * @brief Implements the ShaderCache class, which stores linked program binaries on disk to skip shader compilation.
+ */
+
+#include "ShaderCache.h"
+#include "../gl/GLApi.h"
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace {
+  /**
+   * Identifies cache files, and changes whenever the file layout does.
+   */
+  const uint32_t cacheMagic = 0x31435352;  // "RSC1"
+
+  /**
+   * Largest program binary accepted from a cache file. Real binaries take kilobytes; anything near this is corrupt.
+   */
+  const uint64_t maxBinaryLength = 64 * 1024 * 1024;
+
+  /**
+   * Header written in front of every cached binary.
+   */
+  struct CacheHeader {
+    uint32_t magic;
+    GLenum binaryFormat;
+    uint64_t key;
+    double compileTime;
+    uint64_t binaryLength;
+  };
+
+  /**
+   * @brief Returns an OpenGL string, or an empty string if the driver does not report it.
+   */
+  std::string glString(GLenum name) {
+    const GLubyte* value = GL::GetString(name);
+    return value ? reinterpret_cast<const char*>(value) : "";
+  }
+}
+
+ShaderCache::ShaderCache(const std::string& directory)
+  : directory(directory), enabled(false) {
+  driverIdentity = glString(GL_VENDOR) + '\0' + glString(GL_RENDERER) + '\0' + glString(GL_VERSION);
+
+  GLint formatCount = 0;
+  if (GLEW_ARB_get_program_binary) {
+    GL::GetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+  }
+  enabled = formatCount > 0;
+}
+
+bool ShaderCache::isEnabled() const {
+  return enabled;
+}
+
+uint64_t ShaderCache::computeKey(const std::string& sources) const {
+  // 64-bit FNV-1a over the driver identity and the sources
+  uint64_t hash = 14695981039346656037ull;
+  for (const std::string* text : { &driverIdentity, &sources }) {
+    for (char character : *text) {
+      hash = (hash ^ static_cast<unsigned char>(character)) * 1099511628211ull;
+    }
+    hash = (hash ^ 0xff) * 1099511628211ull;
+  }
+  return hash;
+}
+
+std::string ShaderCache::pathFor(uint64_t key) const {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+  return (std::filesystem::path(directory) / name).string();
+}
+
+bool ShaderCache::load(uint64_t key, GLuint programId) {
+  if (!enabled) {
+    return false;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  std::string path = pathFor(key);
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  CacheHeader header;
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != cacheMagic || header.key != key) {
+    return false;
+  }
+
+  // The length comes from disk, so a truncated or corrupted file must not make it allocate, nor overflow GLsizei
+  std::error_code error;
+  uintmax_t fileSize = std::filesystem::file_size(path, error);
+  if (error || header.binaryLength > maxBinaryLength || header.binaryLength > INT_MAX
+      || header.binaryLength != fileSize - sizeof(header)) {
+    return false;
+  }
+
+  std::vector<char> binary(header.binaryLength);
+  if (!file.read(binary.data(), binary.size())) {
+    return false;
+  }
+
+  // The driver may refuse binaries from an older build of itself even when the version string is unchanged
+  GL::ProgramBinary(programId, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+  GLint success = 0;
+  GL::GetProgramiv(programId, GL_LINK_STATUS, &success);
+  if (!success) {
+    return false;
+  }
+
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  ++stats.hits;
+  stats.loadTime += elapsed.count();
+  stats.timeSaved += header.compileTime - elapsed.count();
+  return true;
+}
+
+void ShaderCache::store(uint64_t key, GLuint programId, double compileTime) {
+  if (!enabled) {
+    return;
+  }
+
+  GLint length = 0;
+  GL::GetProgramiv(programId, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) {
+    return;
+  }
+
+  CacheHeader header = { cacheMagic, 0, key, compileTime, 0 };
+  std::vector<char> binary(length);
+  GLsizei written = 0;
+  GL::GetProgramBinary(programId, length, &written, &header.binaryFormat, binary.data());
+  header.binaryLength = static_cast<uint64_t>(written);
+
+  std::error_code error;
+  std::filesystem::create_directories(directory, error);
+
+  // Write to a temporary file first, so that a crash or a second instance never leaves a truncated entry behind
+  std::string path = pathFor(key);
+  std::string temporaryPath = path + ".tmp";
+  {
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      std::cerr << "Failed to write shader cache file " << temporaryPath << std::endl;
+      return;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(binary.data(), written);
+  }
+  std::filesystem::rename(temporaryPath, path, error);
+}
+
+void ShaderCache::recordMiss() {
+  ++stats.misses;
+}
+
+const ShaderCacheStats& ShaderCache::getStats() const {
+  return stats;
+}
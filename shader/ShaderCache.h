@@ -0,0 +1,123 @@
+/**
+ * @file ShaderCache.h
+ * @brief Declares the ShaderCache class, which stores linked program binaries on disk to skip shader compilation.
+ */
+
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <string>
+
+/**
+ * @struct ShaderCacheStats
+ * @brief Counters describing how much the cache helped.
+ */
+struct ShaderCacheStats {
+  /**
+   * Number of programs loaded from the cache.
+   */
+  int hits = 0;
+
+  /**
+   * Number of programs that had to be compiled, because they were missing, outdated or rejected by the driver.
+   */
+  int misses = 0;
+
+  /**
+   * Time in seconds spent loading cached binaries.
+   */
+  double loadTime = 0.0;
+
+  /**
+   * Time in seconds the cache hits took to compile when they were stored, minus the time spent loading them.
+   */
+  double timeSaved = 0.0;
+};
+
+/**
+ * @class ShaderCache
+ * @brief A directory of program binaries, as produced by glGetProgramBinary, keyed by shader sources and driver.
+ *
+ * The key hashes the complete shader sources together with the OpenGL vendor, renderer and version strings, so
+ * editing a shader or updating the driver simply misses the cache. Drivers may still reject a binary, in which case
+ * the program is compiled from source again and the entry is replaced.
+ *
+ * Requires OpenGL 4.1 or ARB_get_program_binary, and a driver offering at least one binary format; otherwise the
+ * cache is disabled and every program is compiled.
+ */
+class ShaderCache {
+public:
+  /**
+   * @brief Constructs a cache stored in the given directory, which is created when the first binary is stored.
+   * Requires a current OpenGL context.
+   * @param directory Directory holding the cache files.
+   */
+  explicit ShaderCache(const std::string& directory);
+
+  /**
+   * @brief Returns whether the driver supports program binaries.
+   */
+  bool isEnabled() const;
+
+  /**
+   * @brief Computes the cache key of a program.
+   * @param sources Null-separated concatenation of all shader sources of the program.
+   */
+  uint64_t computeKey(const std::string& sources) const;
+
+  /**
+   * @brief Loads a cached binary into a program object.
+   * @param key Cache key of the program.
+   * @param programId Program object without attached shaders.
+   * @return true if the binary was found and the driver accepted it, leaving the program linked.
+   */
+  bool load(uint64_t key, GLuint programId);
+
+  /**
+   * @brief Stores the binary of a successfully linked program.
+   * @param key Cache key of the program.
+   * @param programId Linked program, created with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set.
+   * @param compileTime Time in seconds it took to compile and link the program, reported as saved on later hits.
+   */
+  void store(uint64_t key, GLuint programId, double compileTime);
+
+  /**
+   * @brief Counts a program that had to be compiled.
+   */
+  void recordMiss();
+
+  /**
+   * @brief Get the hit and miss counters.
+   */
+  const ShaderCacheStats& getStats() const;
+
+private:
+  /**
+   * @brief Returns the path of the cache file for a key.
+   */
+  std::string pathFor(uint64_t key) const;
+
+  /**
+   * Directory holding the cache files.
+   */
+  std::string directory;
+
+  /**
+   * Vendor, renderer and version of the OpenGL driver, which binaries are only valid for.
+   */
+  std::string driverIdentity;
+
+  /**
+   * Whether the driver supports program binaries.
+   */
+  bool enabled;
+
+  /**
+   * Hit and miss counters.
+   */
+  ShaderCacheStats stats;
+};
+
+#endif
@@ -4,43 +4,225 @@
  */
 
 #include "ShaderProgram.h"
+#include "UniformBlocks.h"
+#include "../gl/GLApi.h"
+#include "../gl/GLState.h"
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
 ShaderProgram::ShaderProgram(const std::string& vertexShaderPath, const std::string& fragmentShaderPath) 
-  : vertexShaderPath(vertexShaderPath), fragmentShaderPath(fragmentShaderPath), programId(0) {}
+  : vertexShaderPath(vertexShaderPath),
+    fragmentShaderPath(fragmentShaderPath),
+    programId(0),
+    cache(nullptr),
+    reloading(false),
+    reloadQueued(false) {}
 
 bool ShaderProgram::init() {
-  // Initialize GLEW
-  glewExperimental = GL_TRUE;  // Enable modern OpenGL functionality in GLEW
-  if (glewInit() != GLEW_OK) {
-      std::cerr << "Failed to initialize GLEW" << std::endl;
-      return false;
+  return init(loadShaderSource(vertexShaderPath), loadShaderSource(fragmentShaderPath));
+}
+
+bool ShaderProgram::init(const std::string& vertexShaderSource, const std::string& fragmentShaderSource) {
+  // Let the driver compile on its own threads, so that hot reloads never block a frame
+  if (GLEW_KHR_parallel_shader_compile) {
+    GL::MaxShaderCompilerThreadsKHR(0xffffffff);
+  } else if (GLEW_ARB_parallel_shader_compile) {
+    GL::MaxShaderCompilerThreadsARB(0xffffffff);
+  }
+
+  // Skip compilation entirely when the driver accepts a binary cached by an earlier run
+  if (cache) {
+    uint64_t cacheKey = cache -> computeKey(vertexShaderSource + '\0' + fragmentShaderSource);
+    GLuint cachedProgramId = GL::CreateProgram();
+    if (cache -> load(cacheKey, cachedProgramId)) {
+      programId = cachedProgramId;
+      reflect();
+      GLState::useProgram(programId);
+      return true;
+    }
+
+    // A rejected binary may leave the program in an unusable state, so the build starts over with a fresh one
+    cache -> recordMiss();
+    GLState::deleteProgram(cachedProgramId);
   }
 
-  // Vertex and fragment shader source code
-  std::string vertexShaderSource = loadShaderSource(vertexShaderPath);
-  std::string fragmentShaderSource = loadShaderSource(fragmentShaderPath);
+  ProgramBuild build;
+  startBuild(vertexShaderSource, fragmentShaderSource, build);
+  if (!finishBuild(build)) {
+    return false;
+  }
+
+  programId = build.programId;
+  reflect();
+  GLState::useProgram(programId);
+
+  return true;
+}
+
+void ShaderProgram::startBuild(const std::string& vertexShaderSource, const std::string& fragmentShaderSource, ProgramBuild& build) {
+  build.startTime = std::chrono::steady_clock::now();
+  build.cacheKey = cache ? cache -> computeKey(vertexShaderSource + '\0' + fragmentShaderSource) : 0;
 
   // Compile the shaders
-  GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexShaderSource.c_str());
-  GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentShaderSource.c_str());
+  build.vertexShader = compileShader(GL_VERTEX_SHADER, vertexShaderSource.c_str());
+  build.fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentShaderSource.c_str());
 
   // Create shader program and link shaders
-  programId = glCreateProgram();
-  glAttachShader(programId, vertexShader);
-  glAttachShader(programId, fragmentShader);
-  glLinkProgram(programId);
+  build.programId = GL::CreateProgram();
+  if (cache && cache -> isEnabled()) {
+    GL::ProgramParameteri(build.programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  }
+  GL::AttachShader(build.programId, build.vertexShader);
+  GL::AttachShader(build.programId, build.fragmentShader);
+  GL::LinkProgram(build.programId);
+}
 
-  // Use the shader program and clean up individual shaders since they are already compiled and linked into the programId
-  glUseProgram(programId);
-  glDeleteShader(vertexShader);
-  glDeleteShader(fragmentShader);
+bool ShaderProgram::isBuildComplete(const ProgramBuild& build) const {
+  // Without parallel compilation the build already completed inside the calls that started it
+  if (!GLEW_KHR_parallel_shader_compile && !GLEW_ARB_parallel_shader_compile) {
+    return true;
+  }
 
+  GLint complete = GL_FALSE;
+  GL::GetProgramiv(build.programId, GL_COMPLETION_STATUS_KHR, &complete);
+  return complete == GL_TRUE;
+}
+
+bool ShaderProgram::finishBuild(ProgramBuild& build) {
+  // Query the results only now: asking any earlier would wait for a parallel compile to finish
+  bool vertexShaderCompiled = checkCompileStatus(build.vertexShader);
+  bool fragmentShaderCompiled = checkCompileStatus(build.fragmentShader);
+
+  // Clean up individual shaders since they are already compiled and linked into the program
+  GL::DeleteShader(build.vertexShader);
+  GL::DeleteShader(build.fragmentShader);
+
+  int success;
+  GL::GetProgramiv(build.programId, GL_LINK_STATUS, &success);
+  if (!success) {
+    if (vertexShaderCompiled && fragmentShaderCompiled) {
+      char infoLog[512];
+      GL::GetProgramInfoLog(build.programId, 512, nullptr, infoLog);
+      std::cerr << "Shader link error:\n" << infoLog << std::endl;
+    }
+    GLState::deleteProgram(build.programId);
+    build.programId = 0;
+    return false;
+  }
+
+  if (cache) {
+    std::chrono::duration<double> compileTime = std::chrono::steady_clock::now() - build.startTime;
+    cache -> store(build.cacheKey, build.programId, compileTime.count());
+  }
   return true;
 }
 
+void ShaderProgram::reload() {
+  // Edits saved during a build are picked up by another build once it finishes
+  if (reloading) {
+    reloadQueued = true;
+    return;
+  }
+
+  startBuild(loadShaderSource(vertexShaderPath), loadShaderSource(fragmentShaderPath), pendingBuild);
+  reloading = true;
+  reloadQueued = false;
+}
+
+bool ShaderProgram::updateReload() {
+  if (!reloading || !isBuildComplete(pendingBuild)) {
+    return false;
+  }
+  reloading = false;
+
+  bool swapped = false;
+  if (finishBuild(pendingBuild)) {
+    // Swap only once the new program is known to work, so a typo in a shader never breaks the running game
+    GLState::deleteProgram(programId);
+    programId = pendingBuild.programId;
+    reflect();
+    GLState::useProgram(programId);
+    swapped = true;
+
+    std::chrono::duration<double> buildTime = std::chrono::steady_clock::now() - pendingBuild.startTime;
+    std::cout << "Reloaded shaders in " << buildTime.count() * 1000.0 << " ms" << std::endl;
+  } else {
+    std::cerr << "Shader reload failed, keeping the previous program" << std::endl;
+  }
+
+  if (reloadQueued) {
+    reload();
+  }
+  return swapped;
+}
+
+bool ShaderProgram::isReloading() const {
+  return reloading;
+}
+
+void ShaderProgram::reflect() {
+  uniforms.clear();
+  uniformBlocks.clear();
+
+  GLint uniformCount = 0;
+  GLint maxNameLength = 0;
+  GL::GetProgramiv(programId, GL_ACTIVE_UNIFORMS, &uniformCount);
+  GL::GetProgramiv(programId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+  std::vector<char> nameBuffer(std::max(maxNameLength, 1));
+
+  for (GLint i = 0; i < uniformCount; ++i) {
+    UniformInfo uniform;
+    GLsizei nameLength = 0;
+    GL::GetActiveUniform(programId, i, static_cast<GLsizei>(nameBuffer.size()), &nameLength, &uniform.size, &uniform.type, nameBuffer.data());
+
+    // Arrays are reported as "name[0]", but are set through their plain name
+    uniform.name.assign(nameBuffer.data(), nameLength);
+    if (uniform.name.size() > 3 && uniform.name.compare(uniform.name.size() - 3, 3, "[0]") == 0) {
+      uniform.name.resize(uniform.name.size() - 3);
+    }
+    uniform.hash = UniformName::hashName(uniform.name.c_str());
+    uniform.location = GL::GetUniformLocation(programId, nameBuffer.data());
+    uniforms.push_back(uniform);
+  }
+
+  GLint blockCount = 0;
+  GL::GetProgramiv(programId, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+  GL::GetProgramiv(programId, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxNameLength);
+  nameBuffer.resize(std::max(maxNameLength, 1));
+
+  for (GLint i = 0; i < blockCount; ++i) {
+    UniformBlockInfo block;
+    GLsizei nameLength = 0;
+    GL::GetActiveUniformBlockName(programId, i, static_cast<GLsizei>(nameBuffer.size()), &nameLength, nameBuffer.data());
+    GL::GetActiveUniformBlockiv(programId, i, GL_UNIFORM_BLOCK_DATA_SIZE, &block.dataSize);
+    block.name.assign(nameBuffer.data(), nameLength);
+    block.hash = UniformName::hashName(block.name.c_str());
+    block.index = static_cast<GLuint>(i);
+    uniformBlocks.push_back(block);
+
+    // Attach shared blocks to their binding point, where the buffer holding their data is bound
+    for (const SharedUniformBlock& shared : sharedUniformBlocks) {
+      if (shared.name.hash == block.hash && block.name == shared.name.name) {
+        GL::UniformBlockBinding(programId, block.index, shared.binding);
+      }
+    }
+  }
+
+  auto byHash = [](const auto& a, const auto& b) { return a.hash < b.hash; };
+  std::sort(uniforms.begin(), uniforms.end(), byHash);
+  std::sort(uniformBlocks.begin(), uniformBlocks.end(), byHash);
+
+  // Lookups only compare hashes, so two names sharing one would be confused
+  for (size_t i = 1; i < uniforms.size(); ++i) {
+    if (uniforms[i].hash == uniforms[i - 1].hash) {
+      std::cerr << "Uniforms " << uniforms[i - 1].name << " and " << uniforms[i].name << " have the same hash" << std::endl;
+    }
+  }
+}
+
 std::string ShaderProgram::loadShaderSource(const std::string& filepath) {
   std::ifstream shaderFile(filepath);
   std::stringstream shaderStream;
@@ -56,33 +238,80 @@ std::string ShaderProgram::loadShaderSource(const std::string& filepath) {
   return shaderStream.str();
 }
 
+void ShaderProgram::setCache(ShaderCache* shaderCache) {
+  cache = shaderCache;
+}
+
 void ShaderProgram::use() {
-  glUseProgram(programId);
+  GLState::useProgram(programId);
 }
 
 GLuint ShaderProgram::compileShader(unsigned int type, const char* source) {
-  GLuint id = glCreateShader(type);
-  glShaderSource(id, 1, &source, nullptr);
-  glCompileShader(id);
+  GLuint id = GL::CreateShader(type);
+  GL::ShaderSource(id, 1, &source, nullptr);
+  GL::CompileShader(id);
+  return id;
+}
 
+bool ShaderProgram::checkCompileStatus(GLuint shaderId) {
   int success;
-  glGetShaderiv(id, GL_COMPILE_STATUS, &success);
+  GL::GetShaderiv(shaderId, GL_COMPILE_STATUS, &success);
   if (!success) {
       char infoLog[512];
-      glGetShaderInfoLog(id, 512, nullptr, infoLog);
+      GL::GetShaderInfoLog(shaderId, 512, nullptr, infoLog);
       std::cerr << "Shader compilation error:\n" << infoLog << std::endl;
   }
 
-  return id;
+  return success;
+}
+
+GLuint ShaderProgram::getProgramId() const {
+  return programId;
+}
+
+GLint ShaderProgram::getUniformLocation(UniformName name) const {
+  auto found = std::lower_bound(uniforms.begin(), uniforms.end(), name.hash,
+    [](const UniformInfo& uniform, uint32_t hash) { return uniform.hash < hash; });
+  return found != uniforms.end() && found -> hash == name.hash ? found -> location : -1;
+}
+
+const UniformBlockInfo* ShaderProgram::getUniformBlock(UniformName name) const {
+  auto found = std::lower_bound(uniformBlocks.begin(), uniformBlocks.end(), name.hash,
+    [](const UniformBlockInfo& block, uint32_t hash) { return block.hash < hash; });
+  return found != uniformBlocks.end() && found -> hash == name.hash ? &*found : nullptr;
+}
+
+const std::vector<UniformInfo>& ShaderProgram::getUniforms() const {
+  return uniforms;
+}
+
+// OpenGL ignores location -1, so uniforms the program lacks need no special case
+void ShaderProgram::setUniform(UniformName name, int value) {
+  GL::Uniform1i(getUniformLocation(name), value);
+}
+
+void ShaderProgram::setUniform(UniformName name, float value) {
+  GL::Uniform1f(getUniformLocation(name), value);
+}
+
+void ShaderProgram::setUniform(UniformName name, const glm::vec2& value) {
+  GL::Uniform2f(getUniformLocation(name), value.x, value.y);
+}
+
+void ShaderProgram::setUniform(UniformName name, const glm::vec3& value) {
+  GL::Uniform3f(getUniformLocation(name), value.x, value.y, value.z);
+}
+
+void ShaderProgram::setUniform(UniformName name, const glm::vec4& value) {
+  GL::Uniform4f(getUniformLocation(name), value.x, value.y, value.z, value.w);
 }
 
-void ShaderProgram::setUniform(const std::string& name, const glm::mat4& matrix) {
-  GLuint matrixId = glGetUniformLocation(programId, name.c_str());
-  glUniformMatrix4fv(matrixId, 1, GL_FALSE, &matrix[0][0]);
+void ShaderProgram::setUniform(UniformName name, const glm::mat4& matrix) {
+  GL::UniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, &matrix[0][0]);
 }
 
 ShaderProgram::~ShaderProgram() {
   if(programId) {
-    glDeleteProgram(programId);
+    GLState::deleteProgram(programId);
   }
 }
\ No newline at end of file
@@ -6,9 +6,71 @@
 #ifndef SHADER_PROGRAM_H
 #define SHADER_PROGRAM_H
 
+#include <chrono>
+#include <cstdint>
 #include <string>
+#include <vector>
 #include <GL/glew.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include "UniformName.h"
+#include "ShaderCache.h"
+
+/**
+ * @struct UniformInfo
+ * @brief An active uniform of a linked program, as reported by OpenGL.
+ */
+struct UniformInfo {
+  /**
+   * Hash of the name, as computed by UniformName.
+   */
+  uint32_t hash;
+
+  /**
+   * Location to pass to glUniform*, or -1 for members of uniform blocks.
+   */
+  GLint location;
+
+  /**
+   * Data type, e.g. GL_FLOAT_MAT4.
+   */
+  GLenum type;
+
+  /**
+   * Number of array elements, or 1 for non-arrays.
+   */
+  GLint size;
+
+  /**
+   * Name of the uniform, without the "[0]" suffix of arrays.
+   */
+  std::string name;
+};
+
+/**
+ * @struct UniformBlockInfo
+ * @brief An active uniform block of a linked program.
+ */
+struct UniformBlockInfo {
+  /**
+   * Hash of the block name, as computed by UniformName.
+   */
+  uint32_t hash;
+
+  /**
+   * Index of the block within the program.
+   */
+  GLuint index;
+
+  /**
+   * Size of the block's data in bytes.
+   */
+  GLint dataSize;
+
+  /**
+   * Name of the block.
+   */
+  std::string name;
+};
 
 /**
  * @class ShaderProgram
@@ -17,6 +79,14 @@
  * The ShaderProgram class provides methods for initializing, using, and managing shader programs in OpenGL. It supports
  * loading shaders from file paths, compiling shader source code, and linking the compiled shaders into an executable
  * program that runs on the GPU.
+ *
+ * After linking, all active uniforms and uniform blocks are reflected into tables sorted by name hash, so setting a
+ * uniform never queries the driver by string. Uniform blocks listed in sharedUniformBlocks are attached to their
+ * fixed binding points, which lets one buffer per block serve every program.
+ *
+ * The program can be rebuilt from its source files while the game runs. Where the driver supports parallel shader
+ * compilation (KHR_parallel_shader_compile), the rebuild runs on driver threads and updateReload() merely polls it,
+ * so frames keep rendering with the old program until the new one has linked successfully.
  */
 class ShaderProgram {
 public:
@@ -42,10 +112,45 @@ public:
    * @return true if the shader program is successfully initialized; false if there was an error.
    *
    * This method loads shader source code from the specified files, compiles the vertex and fragment shaders, links them
-   * into an OpenGL program, and prepares the program for use.
+   * into an OpenGL program, and prepares the program for use. When a cache is set and holds a binary built from the
+   * same sources by the same driver, that binary is loaded instead of compiling. Compile and link errors are printed
+   * to stderr.
    */
   bool init();
 
+  /**
+   * @brief Initializes the shader program like init(), from sources already loaded, e.g. by an AssetManager.
+   * @param vertexShaderSource Source code of the vertex shader.
+   * @param fragmentShaderSource Source code of the fragment shader.
+   * @return true if the shader program is successfully initialized; false if there was an error.
+   */
+  bool init(const std::string& vertexShaderSource, const std::string& fragmentShaderSource);
+
+  /**
+   * @brief Sets the cache that init() loads the linked program from, and stores it into after compiling.
+   * @param shaderCache Pointer to a ShaderCache, or nullptr to always compile.
+   */
+  void setCache(ShaderCache* shaderCache);
+
+  /**
+   * @brief Starts rebuilding the program from its source files, without waiting for the result.
+   *
+   * If a rebuild is already running, another one starts as soon as it finishes, so the latest sources always win.
+   */
+  void reload();
+
+  /**
+   * @brief Completes a rebuild started by reload() if the driver has finished it. Call once per frame.
+   * @return true if the rebuilt program replaced the current one. A program that fails to compile or link is
+   * discarded, with errors printed to stderr, and the current program stays in use.
+   */
+  bool updateReload();
+
+  /**
+   * @brief Returns whether a rebuild started by reload() is still running.
+   */
+  bool isReloading() const;
+
   /**
    * @brief Activates the shader program for use in the OpenGL context.
    *
@@ -54,9 +159,52 @@ public:
    */
   void use();
 
-  void setUniform(const std::string& name, const glm::mat4& vector);
+  /**
+   * @brief Sets a uniform of the program, which must be in use.
+   * @param name Name of the uniform; declare it constexpr so the hash is computed at compile time.
+   * @param value New value.
+   *
+   * Uniforms the program does not have, for example because the compiler removed them as unused, are ignored.
+   */
+  void setUniform(UniformName name, int value);
+  void setUniform(UniformName name, float value);
+  void setUniform(UniformName name, const glm::vec2& value);
+  void setUniform(UniformName name, const glm::vec3& value);
+  void setUniform(UniformName name, const glm::vec4& value);
+  void setUniform(UniformName name, const glm::mat4& value);
+
+  /**
+   * @brief Get the OpenGL ID of the linked program. It changes when a reload swaps in a rebuilt program.
+   */
+  GLuint getProgramId() const;
+
+  /**
+   * @brief Returns the location of a uniform, or -1 if the program has no such uniform.
+   */
+  GLint getUniformLocation(UniformName name) const;
+
+  /**
+   * @brief Returns the reflected uniform block with the given name, or nullptr if the program has none.
+   */
+  const UniformBlockInfo* getUniformBlock(UniformName name) const;
+
+  /**
+   * @brief Get all active uniforms, sorted by name hash.
+   */
+  const std::vector<UniformInfo>& getUniforms() const;
 
 private:
+  /**
+   * A program being compiled and linked, possibly still running on driver threads.
+   */
+  struct ProgramBuild {
+    GLuint programId = 0;
+    GLuint vertexShader = 0;
+    GLuint fragmentShader = 0;
+    uint64_t cacheKey = 0;
+    std::chrono::steady_clock::time_point startTime;
+  };
+
   /**
    * File path to the vertex shader source code.
    */
@@ -72,6 +220,26 @@ private:
    */
   GLuint programId;
 
+  /**
+   * Pointer to the cache of linked program binaries, or nullptr to always compile.
+   */
+  ShaderCache* cache;
+
+  /**
+   * The rebuild started by reload(), while reloading is set.
+   */
+  ProgramBuild pendingBuild;
+
+  /**
+   * Whether a rebuild started by reload() is running.
+   */
+  bool reloading;
+
+  /**
+   * Whether reload() was called again while a rebuild was running.
+   */
+  bool reloadQueued;
+
   /**
    * @brief Loads the shader source code from a file.
    * @param filepath Path to the shader file.
@@ -86,6 +254,47 @@ private:
    * @return The OpenGL ID of the compiled shader.
    */
   GLuint compileShader(unsigned int type, const char* source);
+
+  /**
+   * @brief Checks whether a shader compiled, printing its info log if not.
+   * @param shaderId The OpenGL ID of the shader.
+   * @return true if the shader compiled successfully.
+   */
+  bool checkCompileStatus(GLuint shaderId);
+
+  /**
+   * @brief Compiles the shaders and links them into a new program, without waiting for the driver to finish.
+   * @param vertexShaderSource Source code of the vertex shader.
+   * @param fragmentShaderSource Source code of the fragment shader.
+   * @param build Receives the objects being built.
+   */
+  void startBuild(const std::string& vertexShaderSource, const std::string& fragmentShaderSource, ProgramBuild& build);
+
+  /**
+   * @brief Returns whether the driver has finished a build, so that finishBuild() will not block.
+   */
+  bool isBuildComplete(const ProgramBuild& build) const;
+
+  /**
+   * @brief Checks the result of a build, printing any errors, and stores successful programs in the cache.
+   * @return true if the program linked; otherwise the program is deleted and build.programId reset to 0.
+   */
+  bool finishBuild(ProgramBuild& build);
+
+  /**
+   * @brief Reads the active uniforms and uniform blocks of the linked program and attaches the shared blocks.
+   */
+  void reflect();
+
+  /**
+   * Active uniforms, sorted by name hash.
+   */
+  std::vector<UniformInfo> uniforms;
+
+  /**
+   * Active uniform blocks, sorted by name hash.
+   */
+  std::vector<UniformBlockInfo> uniformBlocks;
 };
 
 #endif
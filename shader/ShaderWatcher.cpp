@@ -0,0 +1,96 @@
+/**
+ * @file ShaderWatcher.cpp
+ * @brief Implements the ShaderWatcher class, which detects changes to shader source files.
+ */
+
+#include "ShaderWatcher.h"
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+ShaderWatcher::ShaderWatcher(const std::vector<std::string>& paths)
+  : paths(paths.begin(), paths.end()), inotifyFd(-1) {}
+
+ShaderWatcher::~ShaderWatcher() {
+#ifdef __linux__
+  if (inotifyFd >= 0) {
+    close(inotifyFd);
+  }
+#endif
+}
+
+bool ShaderWatcher::init() {
+#ifdef __linux__
+  inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotifyFd < 0) {
+    std::cerr << "Failed to start watching shaders: " << std::strerror(errno) << std::endl;
+    return false;
+  }
+
+  // Adding the same directory twice returns the same watch descriptor, so files may share directories freely
+  for (const std::filesystem::path& path : paths) {
+    std::filesystem::path directory = path.has_parent_path() ? path.parent_path() : std::filesystem::path(".");
+    int watchDescriptor = inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (watchDescriptor < 0) {
+      std::cerr << "Failed to watch " << directory << ": " << std::strerror(errno) << std::endl;
+      return false;
+    }
+    watchDescriptors.push_back(watchDescriptor);
+  }
+#else
+  std::error_code error;
+  for (const std::filesystem::path& path : paths) {
+    modificationTimes.push_back(std::filesystem::last_write_time(path, error));
+  }
+#endif
+  return true;
+}
+
+bool ShaderWatcher::poll() {
+  bool changed = false;
+
+#ifdef __linux__
+  if (inotifyFd < 0) {
+    return false;
+  }
+
+  // Drain every queued event, so that one save producing several events triggers a single reload
+  alignas(inotify_event) char buffer[4096];
+  while (true) {
+    ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+    if (length <= 0) {
+      break;
+    }
+
+    for (char* position = buffer; position < buffer + length; ) {
+      const inotify_event* event = reinterpret_cast<const inotify_event*>(position);
+      position += sizeof(inotify_event) + event -> len;
+      if (event -> len == 0) {
+        continue;
+      }
+
+      for (size_t i = 0; i < paths.size(); ++i) {
+        if (watchDescriptors[i] == event -> wd && paths[i].filename() == event -> name) {
+          changed = true;
+        }
+      }
+    }
+  }
+#else
+  std::error_code error;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    std::filesystem::file_time_type time = std::filesystem::last_write_time(paths[i], error);
+    if (!error && time != modificationTimes[i]) {
+      modificationTimes[i] = time;
+      changed = true;
+    }
+  }
+#endif
+
+  return changed;
+}
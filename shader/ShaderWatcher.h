@@ -0,0 +1,68 @@
+/**
+ * @file ShaderWatcher.h
+ * @brief Declares the ShaderWatcher class, which detects changes to shader source files.
+ */
+
+#ifndef SHADER_WATCHER_H
+#define SHADER_WATCHER_H
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/**
+ * @class ShaderWatcher
+ * @brief Watches a set of files and reports when any of them has been saved.
+ *
+ * On Linux the directories holding the files are watched with inotify, so checking for changes is a single
+ * non-blocking read. The whole directory is watched rather than the files themselves because many editors save by
+ * writing a new file and renaming it over the old one. Elsewhere the modification times are compared instead.
+ */
+class ShaderWatcher {
+public:
+  /**
+   * @brief Constructs a watcher for the given files. Call init() before polling.
+   * @param paths Paths of the files to watch.
+   */
+  explicit ShaderWatcher(const std::vector<std::string>& paths);
+
+  /**
+   * @brief Destructor that stops watching.
+   */
+  ~ShaderWatcher();
+
+  /**
+   * @brief Starts watching the files.
+   * @return true if watching started; false otherwise, after printing the error to stderr.
+   */
+  bool init();
+
+  /**
+   * @brief Checks for changes without blocking.
+   * @return true if any watched file was written since the last call.
+   */
+  bool poll();
+
+private:
+  /**
+   * Paths of the watched files.
+   */
+  std::vector<std::filesystem::path> paths;
+
+  /**
+   * The inotify instance, or -1 when inotify is not used.
+   */
+  int inotifyFd;
+
+  /**
+   * Watch descriptor of each watched file's directory, parallel to paths.
+   */
+  std::vector<int> watchDescriptors;
+
+  /**
+   * Last seen modification time of each watched file, parallel to paths, when inotify is not used.
+   */
+  std::vector<std::filesystem::file_time_type> modificationTimes;
+};
+
+#endif
@@ -0,0 +1,60 @@
+/**
+ * @file UniformBlocks.h
+ * @brief Defines the uniform blocks shared by all shader programs and the binding points they are attached to.
+ */
+
+#ifndef UNIFORM_BLOCKS_H
+#define UNIFORM_BLOCKS_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "UniformName.h"
+
+/**
+ * @enum UniformBlockBinding
+ * @brief Uniform buffer binding points reserved for shared uniform blocks.
+ */
+enum UniformBlockBinding : GLuint {
+  CameraBlockBinding = 0
+};
+
+/**
+ * @struct SharedUniformBlock
+ * @brief Associates the name of a shared uniform block with its binding point.
+ */
+struct SharedUniformBlock {
+  UniformName name;
+  UniformBlockBinding binding;
+};
+
+/**
+ * Every shared uniform block. Each program attaches the blocks it declares to these binding points when it is
+ * linked, so a buffer bound there once is seen by all programs.
+ */
+constexpr SharedUniformBlock sharedUniformBlocks[] = {
+  { "Camera", CameraBlockBinding }
+};
+
+/**
+ * @struct CameraBlock
+ * @brief CPU side copy of the Camera uniform block, in std140 layout.
+ *
+ * Must match the block declared in the shaders:
+ *
+ *   layout (std140) uniform Camera {
+ *     mat4 view;
+ *     mat4 projection;
+ *     mat4 viewProjection;
+ *     vec4 cameraPosition;
+ *   };
+ */
+struct CameraBlock {
+  glm::mat4 view;
+  glm::mat4 projection;
+  glm::mat4 viewProjection;
+  glm::vec4 position;
+};
+
+static_assert(sizeof(CameraBlock) == 3 * 64 + 16, "CameraBlock does not match the std140 layout");
+
+#endif
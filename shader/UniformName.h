@@ -0,0 +1,47 @@
+/**
+ * @file UniformName.h
+ * @brief Defines the UniformName struct, a shader uniform name with a precomputed hash.
+ */
+
+#ifndef UNIFORM_NAME_H
+#define UNIFORM_NAME_H
+
+#include <cstdint>
+
+/**
+ * @struct UniformName
+ * @brief The name of a uniform or uniform block together with its hash, which is what programs look it up by.
+ *
+ * The constructor is constexpr, so names declared as constexpr constants are hashed at compile time and setting a
+ * uniform costs a binary search over a few integers instead of a string lookup in the driver.
+ */
+struct UniformName {
+  /**
+   * @brief Wraps a uniform name, hashing it.
+   * @param name Null terminated uniform name, with static storage duration.
+   */
+  constexpr UniformName(const char* name) : name(name), hash(hashName(name)) {}
+
+  /**
+   * @brief Hashes a null terminated name with 32-bit FNV-1a.
+   */
+  static constexpr uint32_t hashName(const char* name) {
+    uint32_t result = 2166136261u;
+    while (*name) {
+      result = (result ^ static_cast<uint8_t>(*name++)) * 16777619u;
+    }
+    return result;
+  }
+
+  /**
+   * The name as written in the shader.
+   */
+  const char* name;
+
+  /**
+   * Hash of the name.
+   */
+  uint32_t hash;
+};
+
+#endif
@@ -0,0 +1,20 @@
+#version 330 core
+
+// Texture coordinate and color from the vertex shader
+in vec2 texCoord;
+in vec4 color;
+
+// Output color for the fragment (pixel)
+out vec4 fragmentColor;
+
+// Texture atlas the sprites are drawn from
+uniform sampler2D spriteTexture;
+
+void main() {
+  fragmentColor = texture(spriteTexture, texCoord) * color;
+
+  // Fully transparent texels are skipped entirely, as on tile-based hardware
+  if (fragmentColor.a == 0.0) {
+    discard;
+  }
+}
@@ -0,0 +1,21 @@
+#version 330 core
+
+// Sprite corner from the sprite vertex stream: position in pixels, texture coordinate and color
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec4 aColor;
+
+// Size of the render target in pixels
+uniform vec2 screenSize;
+
+// Texture coordinate and color, passed on to the fragment shader
+out vec2 texCoord;
+out vec4 color;
+
+void main() {
+  // Pixels run down from the top left corner, clip space up from the bottom left
+  gl_Position = vec4(aPos / screenSize * vec2(2.0, -2.0) + vec2(-1.0, 1.0), 0.0, 1.0);
+
+  texCoord = aTexCoord;
+  color = aColor;
+}
@@ -6,15 +6,27 @@ layout (location = 0) in vec3 aPos;
 // Input vertex color from location 1, passed in by the CPU
 layout (location = 1) in vec3 aColor;
 
+// Per-instance model matrix from locations 4-7, filled from the instance buffer by instanced draws. Regular draws
+// leave these attributes disabled, so they read the constant identity matrix the Renderer sets up
+layout (location = 4) in mat4 instanceModel;
+
 // Output color to be passed to the fragment shader, where it will be interpolated
 out vec3 vertexColor;
 
-// Uniform matrix for transforming the vertex position
-uniform mat4 modelViewProjection;
+// Camera matrices, shared by all programs and uploaded once per frame
+layout (std140) uniform Camera {
+  mat4 view;
+  mat4 projection;
+  mat4 viewProjection;
+  vec4 cameraPosition;
+};
+
+// Model matrix of the mesh being drawn. Instanced draws leave it at identity and use instanceModel instead
+uniform mat4 model;
 
 void main() {
   // Set the position of the vertex in clip space coordinates
-  gl_Position = modelViewProjection * vec4(aPos, 1.0);
+  gl_Position = viewProjection * model * instanceModel * vec4(aPos, 1.0);
 
   // Propagate color value to fragment shader
   vertexColor = aColor;
@@ -0,0 +1,158 @@
+/**
+ * @file SpriteBatch.cpp
+ * @brief Implements the SpriteBatch class, which draws large numbers of 2D sprites with few draw calls.
+ */
+
+#include "SpriteBatch.h"
+#include "../gl/GLApi.h"
+#include "../gl/GLState.h"
+#include "../shader/UniformName.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+  /**
+   * Uniform holding the size of the render target in pixels.
+   */
+  constexpr UniformName screenSizeUniform("screenSize");
+
+  /**
+   * Sampler uniform reading the sprite texture.
+   */
+  constexpr UniformName textureUniform("spriteTexture");
+
+  /**
+   * @brief Writes one corner of a sprite.
+   */
+  inline void writeVertex(SpriteVertex& vertex, float x, float y, uint16_t u, uint16_t v, uint32_t color) {
+    vertex.position[0] = x;
+    vertex.position[1] = y;
+    vertex.texCoord[0] = u;
+    vertex.texCoord[1] = v;
+    vertex.color[0] = static_cast<uint8_t>(color);
+    vertex.color[1] = static_cast<uint8_t>(color >> 8);
+    vertex.color[2] = static_cast<uint8_t>(color >> 16);
+    vertex.color[3] = static_cast<uint8_t>(color >> 24);
+  }
+}
+
+SpriteBatch::SpriteBatch(ShaderProgram* program, bool persistentStreaming, size_t expectedSprites)
+  : program(program),
+    vertexArrayId(0),
+    indexBufferId(0),
+    textureId(0),
+    screenSize(1.0f),
+    vertices(capacity * 4),
+    batchSize(0) {
+  // Each region holds all of a frame's batches, so that a frame never grows the stream
+  size_t regionSprites = std::max(expectedSprites, capacity);
+  stream = new StreamBuffer(GL_ARRAY_BUFFER, regionSprites * 4 * sizeof(SpriteVertex), 3, persistentStreaming);
+
+  // Every batch draws its quads with the same indices, so they are uploaded once and recorded in the VAO
+  std::vector<GLushort> indices;
+  indices.reserve(capacity * 6);
+  for (size_t quad = 0; quad < capacity; ++quad) {
+    GLushort first = static_cast<GLushort>(quad * 4);
+    const GLushort quadIndices[] = { first, GLushort(first + 2), GLushort(first + 1), GLushort(first + 1), GLushort(first + 2), GLushort(first + 3) };
+    indices.insert(indices.end(), quadIndices, quadIndices + 6);
+  }
+
+  GL::GenVertexArrays(1, &vertexArrayId);
+  GLState::bindVertexArray(vertexArrayId);
+  GL::GenBuffers(1, &indexBufferId);
+  GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferId);
+  GL::BufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+  GLState::bindVertexArray(0);
+}
+
+SpriteBatch::~SpriteBatch() {
+  GLState::deleteVertexArray(vertexArrayId);
+  GLState::deleteBuffer(indexBufferId);
+  delete stream;
+}
+
+void SpriteBatch::begin(int screenWidth, int screenHeight) {
+  screenSize = glm::vec2(static_cast<float>(screenWidth), static_cast<float>(screenHeight));
+  stats = SpriteStats();
+  stream -> beginFrame();
+
+  // Sprites are drawn in order over the scene, blending their transparent texels away
+  GLState::setEnabled(GL_DEPTH_TEST, false);
+  GLState::setEnabled(GL_CULL_FACE, false);
+  GLState::setEnabled(GL_BLEND, true);
+  GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void SpriteBatch::setTexture(GLuint texture) {
+  if (texture != textureId) {
+    flush();
+    textureId = texture;
+  }
+}
+
+void SpriteBatch::draw(const AtlasRegion& region, const glm::vec2& position, const glm::vec2& size, uint32_t color) {
+  if (batchSize == capacity) {
+    flush();
+  }
+
+  float left = std::floor(position.x + 0.5f);
+  float top = std::floor(position.y + 0.5f);
+  float right = left + size.x;
+  float bottom = top + size.y;
+
+  SpriteVertex* quad = vertices.data() + batchSize * 4;
+  writeVertex(quad[0], left, top, region.texCoords[0], region.texCoords[1], color);
+  writeVertex(quad[1], right, top, region.texCoords[2], region.texCoords[1], color);
+  writeVertex(quad[2], left, bottom, region.texCoords[0], region.texCoords[3], color);
+  writeVertex(quad[3], right, bottom, region.texCoords[2], region.texCoords[3], color);
+  ++batchSize;
+}
+
+void SpriteBatch::flush() {
+  if (batchSize == 0) {
+    return;
+  }
+
+  // Stream only the vertices of the sprites in the batch
+  size_t batchBytes = batchSize * 4 * sizeof(SpriteVertex);
+  size_t batchOffset = 0;
+  void* mapped = stream -> map(batchBytes, sizeof(SpriteVertex), batchOffset);
+  std::memcpy(mapped, vertices.data(), batchBytes);
+  stream -> unmap();
+
+  // Point the attributes at this batch's vertices
+  GLState::bindVertexArray(vertexArrayId);
+  GLState::bindBuffer(GL_ARRAY_BUFFER, stream -> getBufferId());
+  SpriteVertex::Format::enableAttributes(batchOffset);
+
+  program -> use();
+  program -> setUniform(screenSizeUniform, screenSize);
+  program -> setUniform(textureUniform, 0);
+  GLState::bindTexture2D(0, textureId);
+
+  GL::DrawElements(GL_TRIANGLES, static_cast<GLsizei>(batchSize * 6), GL_UNSIGNED_SHORT, (void*)0);
+
+  stats.sprites += batchSize;
+  ++stats.draws;
+  batchSize = 0;
+}
+
+void SpriteBatch::end() {
+  flush();
+  stream -> endFrame();
+
+  // Back to the state the 3D passes expect
+  GLState::setEnabled(GL_BLEND, false);
+  GLState::setEnabled(GL_CULL_FACE, true);
+  GLState::setEnabled(GL_DEPTH_TEST, true);
+}
+
+const SpriteStats& SpriteBatch::getStats() const {
+  return stats;
+}
+
+const StreamBuffer& SpriteBatch::getStream() const {
+  return *stream;
+}
@@ -0,0 +1,178 @@
+/**
+ * @file SpriteBatch.h
+ * @brief Declares the SpriteBatch class, which draws large numbers of 2D sprites with few draw calls.
+ */
+
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "TextureAtlas.h"
+#include "../mesh/VertexFormat.h"
+#include "../renderer/StreamBuffer.h"
+#include "../shader/ShaderProgram.h"
+
+/**
+ * @struct SpriteVertex
+ * @brief One corner of a sprite quad (16 bytes): position in pixels, normalized texture coordinate and color.
+ */
+struct SpriteVertex {
+  float position[2];
+  uint16_t texCoord[2];
+  uint8_t color[4];
+
+  typedef VertexFormat<
+    VertexAttribute<0, GL_FLOAT, 2>,
+    VertexAttribute<1, GL_UNSIGNED_SHORT, 2, true>,
+    VertexAttribute<2, GL_UNSIGNED_BYTE, 4, true>
+  > Format;
+};
+
+static_assert(sizeof(SpriteVertex) == SpriteVertex::Format::stride, "SpriteVertex does not match its format");
+
+/**
+ * @struct SpriteStats
+ * @brief Counters of the sprites drawn since the last begin().
+ */
+struct SpriteStats {
+  /**
+   * Number of sprites drawn.
+   */
+  size_t sprites = 0;
+
+  /**
+   * Number of draw calls issued for them.
+   */
+  size_t draws = 0;
+};
+
+/**
+ * @class SpriteBatch
+ * @brief Collects screen-space sprites into a streamed vertex buffer and draws them in batches.
+ *
+ * Each sprite is written as the four corners of a quad into a staging array. When the batch is drawn, only its
+ * vertices are copied into a StreamBuffer sized for the frame's sprites, and a static index buffer, shared by every
+ * batch, turns each quad into two triangles. A batch is drawn with one draw call when the texture changes, when it
+ * reaches its capacity, or at end(), so sprites drawn from a single TextureAtlas cost one draw call per capacity
+ * sprites.
+ *
+ * Sprites are positioned in pixels from the top left corner of the screen, snapped to whole pixels, and drawn in
+ * order with alpha blending, on top of whatever was rendered before.
+ */
+class SpriteBatch {
+public:
+  /**
+   * @brief Creates the vertex array, index buffer and vertex stream. Requires a current OpenGL context.
+   * @param program Program drawing the sprites, built from the sprite shaders.
+   * @param persistentStreaming Whether the vertex stream uses persistent mapping when supported.
+   * @param expectedSprites Number of sprites a frame is expected to draw, which the vertex stream is sized for.
+   */
+  SpriteBatch(ShaderProgram* program, bool persistentStreaming = true, size_t expectedSprites = capacity);
+
+  /**
+   * @brief Destructor that releases the vertex array, index buffer and vertex stream.
+   */
+  ~SpriteBatch();
+
+  /**
+   * @brief Starts the frame's sprites, switching to 2D rendering state.
+   * @param screenWidth Width of the render target in pixels.
+   * @param screenHeight Height of the render target in pixels.
+   *
+   * Call once per frame, with begin() and end() bracketing all of the frame's draw() calls.
+   */
+  void begin(int screenWidth, int screenHeight);
+
+  /**
+   * @brief Sets the texture the following sprites are drawn from, drawing the batch so far if it changes.
+   */
+  void setTexture(GLuint textureId);
+
+  /**
+   * @brief Queues a sprite.
+   * @param region Part of the current texture the sprite shows.
+   * @param position Position of the sprite's top left corner in pixels.
+   * @param size Size of the sprite in pixels.
+   * @param color Color the texture is multiplied with, as RGBA bytes with red in the lowest byte.
+   *
+   * Positions are snapped to whole pixels, so that every texel covers the same number of pixels.
+   */
+  void draw(const AtlasRegion& region, const glm::vec2& position, const glm::vec2& size, uint32_t color = 0xffffffff);
+
+  /**
+   * @brief Draws the remaining sprites and restores the 3D rendering state.
+   */
+  void end();
+
+  /**
+   * @brief Get the counters of the sprites drawn since the last begin().
+   */
+  const SpriteStats& getStats() const;
+
+  /**
+   * @brief Get the stream the sprite vertices are copied into, e.g. for its counters.
+   */
+  const StreamBuffer& getStream() const;
+
+  /**
+   * Maximum number of sprites per draw call, the most that 16-bit indices can address.
+   */
+  static const size_t capacity = 16384;
+
+private:
+  /**
+   * @brief Draws the sprites queued since the last flush.
+   */
+  void flush();
+
+  /**
+   * Program drawing the sprites.
+   */
+  ShaderProgram* program;
+
+  /**
+   * Stream the sprite vertices are written to.
+   */
+  StreamBuffer* stream;
+
+  /**
+   * Vertex array holding the vertex attribute layout and the index buffer.
+   */
+  GLuint vertexArrayId;
+
+  /**
+   * Index buffer with two triangles for each of capacity quads.
+   */
+  GLuint indexBufferId;
+
+  /**
+   * Texture the queued sprites are drawn from.
+   */
+  GLuint textureId;
+
+  /**
+   * Size of the render target in pixels.
+   */
+  glm::vec2 screenSize;
+
+  /**
+   * Vertices of the current batch, four per sprite, with room for capacity sprites.
+   */
+  std::vector<SpriteVertex> vertices;
+
+  /**
+   * Number of sprites in the current batch.
+   */
+  size_t batchSize;
+
+  /**
+   * Counters of the sprites drawn since the last begin().
+   */
+  SpriteStats stats;
+};
+
+#endif
@@ -0,0 +1,118 @@
+/**
+ * @file TextureAtlas.cpp
+ * @brief Implements the TextureAtlas class, which packs many small images into one texture.
+ */
+
+#include "TextureAtlas.h"
+#include "../gl/GLApi.h"
+#include "../gl/GLState.h"
+#include <algorithm>
+#include <iostream>
+
+TextureAtlas::TextureAtlas(int width, int height, int padding)
+  : width(width), height(height), padding(padding), textureId(0) {}
+
+TextureAtlas::~TextureAtlas() {
+  if (textureId) {
+    GLState::deleteTexture(textureId);
+  }
+}
+
+int TextureAtlas::add(const uint8_t* pixels, int imageWidth, int imageHeight) {
+  images.push_back({ imageWidth, imageHeight, std::vector<uint8_t>(pixels, pixels + imageWidth * imageHeight * 4) });
+  return static_cast<int>(images.size() - 1);
+}
+
+bool TextureAtlas::build() {
+  // Place the tallest images first, so that each shelf is filled with images of similar height
+  std::vector<int> order(images.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = static_cast<int>(i);
+  }
+  std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+    return images[a].height > images[b].height;
+  });
+
+  regions.assign(images.size(), AtlasRegion());
+  int shelfX = 0;
+  int shelfY = 0;
+  int shelfHeight = 0;
+  for (int index : order) {
+    int paddedWidth = images[index].width + 2 * padding;
+    int paddedHeight = images[index].height + 2 * padding;
+
+    // Start a new shelf when the image no longer fits next to the previous one
+    if (shelfX + paddedWidth > width) {
+      shelfY += shelfHeight;
+      shelfX = 0;
+      shelfHeight = 0;
+    }
+    if (paddedWidth > width || shelfY + paddedHeight > height) {
+      std::cerr << "Texture atlas of " << width << "x" << height << " texels is too small for " << images.size()
+                << " images" << std::endl;
+      return false;
+    }
+
+    AtlasRegion& region = regions[index];
+    region.x = shelfX + padding;
+    region.y = shelfY + padding;
+    region.width = images[index].width;
+    region.height = images[index].height;
+    region.texCoords[0] = static_cast<uint16_t>(static_cast<uint64_t>(region.x) * 65535 / width);
+    region.texCoords[1] = static_cast<uint16_t>(static_cast<uint64_t>(region.y) * 65535 / height);
+    region.texCoords[2] = static_cast<uint16_t>(static_cast<uint64_t>(region.x + region.width) * 65535 / width);
+    region.texCoords[3] = static_cast<uint16_t>(static_cast<uint64_t>(region.y + region.height) * 65535 / height);
+
+    shelfX += paddedWidth;
+    shelfHeight = std::max(shelfHeight, paddedHeight);
+  }
+
+  std::vector<uint8_t> atlasPixels(static_cast<size_t>(width) * height * 4, 0);
+  for (size_t i = 0; i < images.size(); ++i) {
+    blit(images[i], regions[i], atlasPixels);
+  }
+
+  if (!textureId) {
+    GL::GenTextures(1, &textureId);
+  }
+  GLState::bindTexture2D(0, textureId);
+  GL::TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, atlasPixels.data());
+
+  // Nearest filtering without mipmaps keeps every texel a crisp square, as on the original hardware
+  GL::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  GL::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  GL::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  GL::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  GL::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+
+  return true;
+}
+
+void TextureAtlas::blit(const Image& image, const AtlasRegion& region, std::vector<uint8_t>& atlasPixels) const {
+  // Every texel of the padded rectangle takes the nearest image pixel, which extrudes the edges into the padding
+  for (int y = -padding; y < image.height + padding; ++y) {
+    int sourceY = std::min(std::max(y, 0), image.height - 1);
+    for (int x = -padding; x < image.width + padding; ++x) {
+      int sourceX = std::min(std::max(x, 0), image.width - 1);
+      const uint8_t* source = &image.pixels[(static_cast<size_t>(sourceY) * image.width + sourceX) * 4];
+      uint8_t* destination = &atlasPixels[(static_cast<size_t>(region.y + y) * width + region.x + x) * 4];
+      std::copy(source, source + 4, destination);
+    }
+  }
+}
+
+const AtlasRegion& TextureAtlas::getRegion(int index) const {
+  return regions[index];
+}
+
+GLuint TextureAtlas::getTextureId() const {
+  return textureId;
+}
+
+float TextureAtlas::getUsage() const {
+  size_t used = 0;
+  for (const Image& image : images) {
+    used += static_cast<size_t>(image.width) * image.height;
+  }
+  return static_cast<float>(used) / (static_cast<float>(width) * height);
+}
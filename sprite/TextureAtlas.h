@@ -0,0 +1,137 @@
+/**
+ * @file TextureAtlas.h
+ * @brief Declares the TextureAtlas class, which packs many small images into one texture.
+ */
+
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <GL/glew.h>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct AtlasRegion
+ * @brief The place of one packed image inside a TextureAtlas.
+ */
+struct AtlasRegion {
+  /**
+   * Position of the image's top left texel in the atlas.
+   */
+  int x = 0;
+  int y = 0;
+
+  /**
+   * Size of the image in texels.
+   */
+  int width = 0;
+  int height = 0;
+
+  /**
+   * Texture coordinates of the image's corners (u0, v0, u1, v1), as normalized 16-bit integers.
+   */
+  uint16_t texCoords[4] = {};
+};
+
+/**
+ * @class TextureAtlas
+ * @brief Packs images, such as the tiles of a tile set, into a single RGBA texture.
+ *
+ * Drawing every tile from one texture lets a SpriteBatch draw any mix of them without switching textures. Images are
+ * collected with add() and packed by build() onto shelves, tallest first, which wastes little space when many images
+ * share a size, as tiles do.
+ *
+ * The texture is sampled with nearest filtering and no mipmaps, so pixel art keeps its hard edges. Each image is
+ * surrounded by a border repeating its edge texels, so that rounding at the edges of a sprite never samples a
+ * neighboring image.
+ */
+class TextureAtlas {
+public:
+  /**
+   * @brief Constructs an empty atlas.
+   * @param width Width of the atlas texture in texels.
+   * @param height Height of the atlas texture in texels.
+   * @param padding Width of the border around each image in texels.
+   */
+  TextureAtlas(int width, int height, int padding = 1);
+
+  /**
+   * @brief Destructor that releases the texture.
+   */
+  ~TextureAtlas();
+
+  /**
+   * @brief Adds an image to be packed by the next build().
+   * @param pixels RGBA pixels, row by row from the top, four bytes each. They are copied.
+   * @param width Width of the image in pixels.
+   * @param height Height of the image in pixels.
+   * @return Index of the image, for getRegion().
+   */
+  int add(const uint8_t* pixels, int width, int height);
+
+  /**
+   * @brief Packs all added images and uploads the atlas texture. Requires a current OpenGL context.
+   * @return true if all images fit; false otherwise, after printing the error to stderr.
+   */
+  bool build();
+
+  /**
+   * @brief Get the place of an image inside the atlas, valid after build().
+   * @param index Index returned by add().
+   */
+  const AtlasRegion& getRegion(int index) const;
+
+  /**
+   * @brief Get the ID of the atlas texture, or 0 before build().
+   */
+  GLuint getTextureId() const;
+
+  /**
+   * @brief Get the fraction of the atlas covered by images, padding excluded.
+   */
+  float getUsage() const;
+
+private:
+  /**
+   * @struct Image
+   * @brief An added image waiting to be packed.
+   */
+  struct Image {
+    int width;
+    int height;
+    std::vector<uint8_t> pixels;
+  };
+
+  /**
+   * @brief Copies an image into the atlas pixels at its region, extruding its edges into the padding.
+   */
+  void blit(const Image& image, const AtlasRegion& region, std::vector<uint8_t>& atlasPixels) const;
+
+  /**
+   * Size of the atlas texture in texels.
+   */
+  int width;
+  int height;
+
+  /**
+   * Width of the border around each image in texels.
+   */
+  int padding;
+
+  /**
+   * Added images, in order of addition.
+   */
+  std::vector<Image> images;
+
+  /**
+   * Place of each image, in order of addition.
+   */
+  std::vector<AtlasRegion> regions;
+
+  /**
+   * Atlas texture ID, or 0 before build().
+   */
+  GLuint textureId;
+};
+
+#endif
@@ -0,0 +1,33 @@
+/**
+ * @file FixedTimestep.cpp
+ * @brief Implements the FixedTimestep class, which splits variable frame times into constant simulation ticks.
+ */
+
+#include "FixedTimestep.h"
+
+FixedTimestep::FixedTimestep(double tickDuration, int maxTicksPerFrame)
+  : tickDuration(tickDuration), maxTicksPerFrame(maxTicksPerFrame), accumulator(0) {}
+
+int FixedTimestep::advance(double frameTime) {
+  accumulator += frameTime;
+
+  int ticks = 0;
+  while (accumulator >= tickDuration && ticks < maxTicksPerFrame) {
+    accumulator -= tickDuration;
+    ++ticks;
+  }
+
+  // Drop whatever could not be simulated within the tick budget
+  if (accumulator >= tickDuration) {
+    accumulator = 0;
+  }
+  return ticks;
+}
+
+double FixedTimestep::getAlpha() const {
+  return accumulator / tickDuration;
+}
+
+double FixedTimestep::getTickDuration() const {
+  return tickDuration;
+}
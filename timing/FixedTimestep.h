@@ -0,0 +1,60 @@
+/**
+ * @file FixedTimestep.h
+ * @brief Declares the FixedTimestep class, which splits variable frame times into constant simulation ticks.
+ */
+
+#ifndef FIXED_TIMESTEP_H
+#define FIXED_TIMESTEP_H
+
+/**
+ * @class FixedTimestep
+ * @brief Accumulates elapsed frame time and hands it out as a whole number of fixed-length ticks.
+ *
+ * Running the simulation at a constant tick rate makes it independent of the render frame rate. The time left over
+ * after the last whole tick is exposed as an interpolation factor, so rendering can blend between the previous and
+ * the current simulation state instead of stepping visibly at the tick rate.
+ */
+class FixedTimestep {
+public:
+  /**
+   * @brief Constructs a FixedTimestep.
+   * @param tickDuration Length of one simulation tick in seconds.
+   * @param maxTicksPerFrame Upper bound on ticks per frame; after a long stall the excess time is dropped instead of
+   * simulated, so a slow frame cannot cause an ever-growing backlog of ticks.
+   */
+  FixedTimestep(double tickDuration, int maxTicksPerFrame);
+
+  /**
+   * @brief Adds elapsed time and returns how many ticks to simulate this frame.
+   * @param frameTime Time elapsed since the previous frame in seconds.
+   */
+  int advance(double frameTime);
+
+  /**
+   * @brief Returns how far between the previous and the current tick the present moment lies, in [0, 1).
+   */
+  double getAlpha() const;
+
+  /**
+   * @brief Returns the length of one simulation tick in seconds.
+   */
+  double getTickDuration() const;
+
+private:
+  /**
+   * Length of one simulation tick in seconds.
+   */
+  double tickDuration;
+
+  /**
+   * Upper bound on ticks simulated per frame.
+   */
+  int maxTicksPerFrame;
+
+  /**
+   * Elapsed time not yet consumed by a tick, in seconds.
+   */
+  double accumulator;
+};
+
+#endif
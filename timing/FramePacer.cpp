@@ -0,0 +1,91 @@
+/**
+ * @file FramePacer.cpp
+ * @brief Implements the FramePacer class, which waits for frame deadlines with sub-millisecond precision.
+ */
+
+#include "FramePacer.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace {
+  /**
+   * Bounds for how long before a deadline sleeping stops, in seconds.
+   */
+  const double minSpinThreshold = 0.00025;
+  const double maxSpinThreshold = 0.004;
+
+  /**
+   * Below this much remaining time the pacer busy-waits instead of yielding, since a yield may not come back in time.
+   */
+  const std::chrono::microseconds busyWaitThreshold(50);
+}
+
+FramePacer::FramePacer(double targetFrameTime)
+  : period(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(targetFrameTime))),
+    spinThreshold(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(minSpinThreshold))),
+    overshootPeak(0),
+    missedDeadlines(0) {}
+
+void FramePacer::start() {
+  deadline = Clock::now() + period;
+}
+
+void FramePacer::waitForNextFrame() {
+  Clock::time_point now = Clock::now();
+  if (now >= deadline) {
+    ++missedDeadlines;
+    deadline = now + period;
+    return;
+  }
+
+  // Coarse sleep, stopping early enough that the expected overshoot still lands before the deadline
+  Clock::time_point wakeTime = deadline - spinThreshold;
+  if (now < wakeTime) {
+    std::this_thread::sleep_until(wakeTime);
+    now = Clock::now();
+    calibrate(now - wakeTime);
+  }
+
+  // Fine wait for the remainder
+  while (now < deadline) {
+    if (deadline - now > busyWaitThreshold) {
+      std::this_thread::yield();
+    }
+    now = Clock::now();
+  }
+
+  errors.push(std::chrono::duration<double>(now - deadline).count());
+
+  deadline += period;
+  if (deadline <= now) {
+    deadline = now + period;
+  }
+}
+
+void FramePacer::calibrate(Clock::duration overshoot) {
+  // Track a peak that decays slowly, so one unlucky sleep widens the margin for a while rather than forever
+  double overshootSeconds = std::max(0.0, std::chrono::duration<double>(overshoot).count());
+  overshootPeak = std::max(overshootSeconds, overshootPeak * 0.98);
+
+  double threshold = std::min(std::max(overshootPeak * 1.25, minSpinThreshold), maxSpinThreshold);
+  spinThreshold = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(threshold));
+}
+
+PacingStats FramePacer::getStats() const {
+  std::vector<double> snapshot;
+  errors.snapshot(snapshot);
+
+  PacingStats stats = { 0, 0, 0, missedDeadlines };
+  if (snapshot.empty()) {
+    return stats;
+  }
+
+  std::sort(snapshot.begin(), snapshot.end());
+  stats.meanError = std::accumulate(snapshot.begin(), snapshot.end(), 0.0) / snapshot.size();
+  stats.p99Error = snapshot[static_cast<size_t>(std::ceil(0.99 * snapshot.size())) - 1];
+  stats.maxError = snapshot.back();
+  return stats;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file FramePacer.h
+ * @brief Declares the FramePacer class, which waits for frame deadlines with sub-millisecond precision.
+ */
+
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <chrono>
+#include <cstdint>
+#include "../profiler/RingBuffer.h"
+
+/**
+ * @struct PacingStats
+ * @brief Summary of how late the pacer woke up relative to its deadlines.
+ */
+struct PacingStats {
+  /**
+   * Mean wake-up error in seconds.
+   */
+  double meanError;
+
+  /**
+   * 99th percentile wake-up error in seconds.
+   */
+  double p99Error;
+
+  /**
+   * Largest wake-up error in seconds.
+   */
+  double maxError;
+
+  /**
+   * Number of frames whose work ran past the deadline, so there was nothing to wait for.
+   */
+  uint64_t missedDeadlines;
+};
+
+/**
+ * @class FramePacer
+ * @brief Paces frames to a fixed period using a coarse sleep followed by a short spin.
+ *
+ * A plain sleep can overshoot by a whole scheduler quantum, which at 61 FPS is a large fraction of the frame and
+ * shows up as judder. The pacer instead sleeps until shortly before the deadline and then yields/spins the rest of
+ * the way. How early it stops sleeping is calibrated continuously from the overshoot actually observed, so the spin
+ * stays short on systems with a precise timer and grows only where the scheduler needs it.
+ *
+ * Deadlines are absolute and advance by exactly one period per frame, so small errors do not accumulate into drift.
+ */
+class FramePacer {
+public:
+  /**
+   * @brief Constructs a FramePacer.
+   * @param targetFrameTime Duration of a frame in seconds.
+   */
+  FramePacer(double targetFrameTime);
+
+  /**
+   * @brief Starts pacing; the first deadline is one period from now.
+   */
+  void start();
+
+  /**
+   * @brief Blocks until the current frame's deadline and schedules the next one.
+   *
+   * If the deadline has already passed the call returns immediately and the schedule restarts from now, rather than
+   * rushing through several frames to catch up.
+   */
+  void waitForNextFrame();
+
+  /**
+   * @brief Summarizes the wake-up errors of recent frames.
+   */
+  PacingStats getStats() const;
+
+private:
+  typedef std::chrono::steady_clock Clock;
+
+  /**
+   * @brief Folds the overshoot of one sleep into the estimate used to decide when to stop sleeping.
+   * @param overshoot How long past its requested wake-up time the sleep returned.
+   */
+  void calibrate(Clock::duration overshoot);
+
+  /**
+   * Duration of a frame.
+   */
+  Clock::duration period;
+
+  /**
+   * Time the current frame should end.
+   */
+  Clock::time_point deadline;
+
+  /**
+   * How long before the deadline to stop sleeping and start spinning.
+   */
+  Clock::duration spinThreshold;
+
+  /**
+   * Slowly decaying peak of the observed sleep overshoot, in seconds.
+   */
+  double overshootPeak;
+
+  /**
+   * Number of deadlines that had already passed when waitForNextFrame was called.
+   */
+  uint64_t missedDeadlines;
+
+  /**
+   * Wake-up errors of recent frames, in seconds.
+   */
+  RingBuffer<double, 1024> errors;
+};
+
+#endif
@@ -6,11 +6,48 @@
 #include <string>
 #include <iostream>
 #include "Window.h"
+#include "../gl/GLApi.h"
+#include "../gl/NullGL.h"
 
-Window::Window(int width, int height, const std::string& title)
-  : width(width), height(height), title(title), window(nullptr) {}
+#ifdef RETROKANTO_HEADLESS
+#include <EGL/eglext.h>
+#endif
+
+Window::Window(int width, int height, const std::string& title, WindowMode mode)
+  : width(width),
+    height(height),
+    title(title),
+    window(nullptr),
+    mode(mode),
+    closeRequested(false),
+    framebufferId(0),
+    colorRenderbufferId(0),
+    depthRenderbufferId(0)
+#ifdef RETROKANTO_HEADLESS
+    , eglDisplay(EGL_NO_DISPLAY),
+    eglContext(EGL_NO_CONTEXT)
+#endif
+    {}
 
 bool Window::init() {
+  startTime = std::chrono::steady_clock::now();
+
+  if (mode == WindowMode::Headless) {
+    return initHeadless();
+  }
+
+  if (mode == WindowMode::Null) {
+    NullGL::install();
+    return true;
+  }
+
+  if (!initWindowed()) {
+    return false;
+  }
+  return initGlew();
+}
+
+bool Window::initWindowed() {
   if(!glfwInit()) {
     std::cerr << "Failed to initialize GLFW" << std::endl;
     return false;
@@ -34,19 +71,162 @@ bool Window::init() {
   }
 
   // Make the OpenGL context of the created window current. This context will be used for all OpenGL calls
-  glfwMakeContextCurrent(window); 
+  glfwMakeContextCurrent(window);
+  return true;
+}
+
+bool Window::initHeadless() {
+#ifdef RETROKANTO_HEADLESS
+  // Prefer Mesa's surfaceless platform, which needs neither a display server nor a GPU (llvmpipe works fine)
+  PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+    (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+  if (getPlatformDisplay) {
+    eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+  }
+  if (eglDisplay == EGL_NO_DISPLAY) {
+    eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+  }
+
+  if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, nullptr, nullptr)) {
+    std::cerr << "Failed to initialize EGL display" << std::endl;
+    return false;
+  }
+
+  if (!eglBindAPI(EGL_OPENGL_API)) {
+    std::cerr << "EGL display does not support desktop OpenGL" << std::endl;
+    return false;
+  }
+
+  const EGLint configAttributes[] = {
+    EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+    EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+    EGL_NONE
+  };
+  EGLConfig config;
+  EGLint configCount = 0;
+  if (!eglChooseConfig(eglDisplay, configAttributes, &config, 1, &configCount) || configCount == 0) {
+    std::cerr << "Failed to choose an EGL config" << std::endl;
+    return false;
+  }
+
+  // Request the same 4.1 core profile the windowed path uses, so both modes exercise identical shaders
+  const EGLint contextAttributes[] = {
+    EGL_CONTEXT_MAJOR_VERSION, 4,
+    EGL_CONTEXT_MINOR_VERSION, 1,
+    EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+    EGL_NONE
+  };
+  eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttributes);
+  if (eglContext == EGL_NO_CONTEXT) {
+    std::cerr << "Failed to create EGL context" << std::endl;
+    return false;
+  }
+
+  // Bind the context without any surface; all rendering goes to the framebuffer object created below
+  if (!eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext)) {
+    std::cerr << "Failed to make EGL context current" << std::endl;
+    return false;
+  }
+
+  // Function pointers are needed to create the framebuffer object
+  if (!initGlew()) {
+    return false;
+  }
+
+  GL::GenRenderbuffers(1, &colorRenderbufferId);
+  GL::BindRenderbuffer(GL_RENDERBUFFER, colorRenderbufferId);
+  GL::RenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+  GL::GenRenderbuffers(1, &depthRenderbufferId);
+  GL::BindRenderbuffer(GL_RENDERBUFFER, depthRenderbufferId);
+  GL::RenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+
+  GL::GenFramebuffers(1, &framebufferId);
+  GL::BindFramebuffer(GL_FRAMEBUFFER, framebufferId);
+  GL::FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRenderbufferId);
+  GL::FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRenderbufferId);
+
+  if (GL::CheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    std::cerr << "Offscreen framebuffer is incomplete" << std::endl;
+    return false;
+  }
+
+  GL::Viewport(0, 0, width, height);
+  return true;
+#else
+  std::cerr << "Headless mode requires building with RETROKANTO_HEADLESS" << std::endl;
+  return false;
+#endif
+}
+
+bool Window::initGlew() {
+  glewExperimental = GL_TRUE;  // Enable modern OpenGL functionality in GLEW
+
+  // glewInit also loads GLX/WGL entry points, which fail without a display; only the core ones matter headless
+  GLenum result = mode == WindowMode::Headless ? glewContextInit() : glewInit();
+  if (result != GLEW_OK) {
+    std::cerr << "Failed to initialize GLEW" << std::endl;
+    return false;
+  }
   return true;
 }
 
 bool Window::shouldClose() {
+  if (mode != WindowMode::Windowed) {
+    return closeRequested;
+  }
   return glfwWindowShouldClose(window);
 }
 
+void Window::close() {
+  closeRequested = true;
+  if (window) {
+    glfwSetWindowShouldClose(window, true);
+  }
+}
+
 void Window::swapBuffers() {
+  if (mode == WindowMode::Headless) {
+    GL::Finish();
+    return;
+  }
+  if (mode == WindowMode::Null) {
+    NullGL::endFrame();
+    return;
+  }
   glfwSwapBuffers(window);
 }
 
+void Window::makeContextCurrent() {
+  if (mode == WindowMode::Headless) {
+#ifdef RETROKANTO_HEADLESS
+    eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext);
+#endif
+    return;
+  }
+  if (mode == WindowMode::Null) {
+    return;
+  }
+  glfwMakeContextCurrent(window);
+}
+
+void Window::releaseContext() {
+  if (mode == WindowMode::Headless) {
+#ifdef RETROKANTO_HEADLESS
+    eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+#endif
+    return;
+  }
+  if (mode == WindowMode::Null) {
+    return;
+  }
+  glfwMakeContextCurrent(nullptr);
+}
+
 void Window::pollEvents() {
+  if (mode != WindowMode::Windowed) {
+    return;
+  }
   glfwPollEvents();
 }
 
@@ -62,9 +242,47 @@ GLFWwindow* Window::getWindow() const {
   return window;
 }
 
+bool Window::isHeadless() const {
+  return mode != WindowMode::Windowed;
+}
+
+double Window::getTime() const {
+  if (mode != WindowMode::Windowed) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  }
+  return glfwGetTime();
+}
+
+void Window::readPixels(std::vector<unsigned char>& pixels) const {
+  pixels.resize(static_cast<size_t>(width) * height * 4);
+  GL::PixelStorei(GL_PACK_ALIGNMENT, 1);
+  GL::ReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+}
+
 Window::~Window() {
+  if (mode == WindowMode::Headless) {
+#ifdef RETROKANTO_HEADLESS
+    if (eglContext != EGL_NO_CONTEXT) {
+      GL::DeleteFramebuffers(1, &framebufferId);
+      GL::DeleteRenderbuffers(1, &colorRenderbufferId);
+      GL::DeleteRenderbuffers(1, &depthRenderbufferId);
+      eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+      eglDestroyContext(eglDisplay, eglContext);
+    }
+    if (eglDisplay != EGL_NO_DISPLAY) {
+      eglTerminate(eglDisplay);
+    }
+#endif
+    return;
+  }
+
+  if (mode == WindowMode::Null) {
+    GL::useDriver();
+    return;
+  }
+
   if(window) {
     glfwDestroyWindow(window);
   }
   glfwTerminate();
-}
\ No newline at end of file
+}
@@ -6,8 +6,36 @@
 #ifndef WINDOW_H
 #define WINDOW_H
 
+#include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <string>
+#include <vector>
+#include <chrono>
+
+#ifdef RETROKANTO_HEADLESS
+#include <EGL/egl.h>
+#endif
+
+/**
+ * @enum WindowMode
+ * @brief Selects how the OpenGL context and default framebuffer are created.
+ */
+enum class WindowMode {
+  /**
+   * A visible GLFW window with its own default framebuffer.
+   */
+  Windowed,
+
+  /**
+   * A surfaceless EGL context rendering into an offscreen framebuffer object, for machines without a display.
+   */
+  Headless,
+
+  /**
+   * No context at all: every OpenGL call is recorded by NullGL instead, to measure the game without any driver.
+   */
+  Null
+};
 
 /**
  * @class Window
@@ -23,8 +51,9 @@ public:
    * @param width Width of the window in pixels.
    * @param height Height of the window in pixels.
    * @param title Title of the window.
+   * @param mode Whether to open a visible window or render offscreen.
    */
-  Window(int width, int height, const std::string& title);
+  Window(int width, int height, const std::string& title, WindowMode mode = WindowMode::Windowed);
 
   /**
    * @brief Destructor that cleans up the window.
@@ -35,8 +64,8 @@ public:
    * @brief Initializes the window and sets up the OpenGL context.
    * @return true if the window is successfully initialized, false otherwise.
    *
-   * This method creates the window with the specified settings,
-   * and makes the OpenGL context current.
+   * This method creates the window (or the headless context and its offscreen framebuffer) with the specified
+   * settings, makes the OpenGL context current and loads the OpenGL function pointers through GLEW.
    */
   bool init();
 
@@ -46,11 +75,31 @@ public:
    */
   bool shouldClose();
 
+  /**
+   * @brief Requests that the window close at the end of the current frame.
+   */
+  void close();
+
   /**
    * @brief Swaps the front and back buffers, displaying the most recent frame.
+   *
+   * In headless mode there is nothing to present, so this waits for the frame to finish rendering instead, which
+   * keeps measured frame times honest. In null mode it ends the frame's NullGL command stream.
    */
   void swapBuffers();
 
+  /**
+   * @brief Makes the OpenGL context current on the calling thread.
+   *
+   * A context is current on at most one thread, so the thread that had it must call releaseContext() first.
+   */
+  void makeContextCurrent();
+
+  /**
+   * @brief Detaches the OpenGL context from the calling thread, so that another thread can make it current.
+   */
+  void releaseContext();
+
   /**
    * @brief Polls for and processes any pending events, such as keyboard and mouse input.
    */
@@ -71,7 +120,41 @@ public:
    */
   GLFWwindow* getWindow() const;
 
+  /**
+   * @brief Checks whether the window renders offscreen, or not at all.
+   */
+  bool isHeadless() const;
+
+  /**
+   * @brief Get the time in seconds since the window was initialized.
+   */
+  double getTime() const;
+
+  /**
+   * @brief Reads back the current contents of the framebuffer being rendered to.
+   * @param pixels Receives width * height tightly packed RGBA8 pixels, bottom row first.
+   */
+  void readPixels(std::vector<unsigned char>& pixels) const;
+
 private:
+  /**
+   * @brief Creates a visible GLFW window and makes its context current.
+   * @return true on success, false otherwise.
+   */
+  bool initWindowed();
+
+  /**
+   * @brief Creates a surfaceless EGL context and an offscreen framebuffer to render into.
+   * @return true on success, false otherwise.
+   */
+  bool initHeadless();
+
+  /**
+   * @brief Loads the OpenGL function pointers for the current context.
+   * @return true on success, false otherwise.
+   */
+  bool initGlew();
+
   /** 
    * Width of the window in pixels.
    */
@@ -91,6 +174,48 @@ private:
    * Pointer to the GLFW window context.
    */
   GLFWwindow* window;
+
+  /**
+   * Whether the window is visible or rendering offscreen.
+   */
+  WindowMode mode;
+
+  /**
+   * Set by close() in headless mode, where there is no GLFW window to carry the flag.
+   */
+  bool closeRequested;
+
+  /**
+   * Time at which the window was initialized, used as the headless clock origin.
+   */
+  std::chrono::steady_clock::time_point startTime;
+
+  /**
+   * Offscreen framebuffer object the headless context renders into.
+   */
+  GLuint framebufferId;
+
+  /**
+   * Color renderbuffer attached to the offscreen framebuffer.
+   */
+  GLuint colorRenderbufferId;
+
+  /**
+   * Depth renderbuffer attached to the offscreen framebuffer.
+   */
+  GLuint depthRenderbufferId;
+
+#ifdef RETROKANTO_HEADLESS
+  /**
+   * EGL display connection used by the headless context.
+   */
+  EGLDisplay eglDisplay;
+
+  /**
+   * EGL rendering context used in headless mode.
+   */
+  EGLContext eglContext;
+#endif
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,31 @@
+/**
+ * @file Chunk.cpp
+ * @brief Implements the Chunk class, a fixed-size column of blocks that the world is divided into.
+ */
+
+#include "Chunk.h"
+
+Chunk::Chunk(int chunkX, int chunkZ)
+  : chunkX(chunkX), chunkZ(chunkZ), blocks(size * size * height, Air) {}
+
+BlockType Chunk::getBlock(int x, int y, int z) const {
+  if (x < 0 || x >= size || y < 0 || y >= height || z < 0 || z >= size) {
+    return Air;
+  }
+  return blocks[x + z * size + y * size * size];
+}
+
+void Chunk::setBlock(int x, int y, int z, BlockType block) {
+  if (x < 0 || x >= size || y < 0 || y >= height || z < 0 || z >= size) {
+    return;
+  }
+  blocks[x + z * size + y * size * size] = block;
+}
+
+int Chunk::getChunkX() const {
+  return chunkX;
+}
+
+int Chunk::getChunkZ() const {
+  return chunkZ;
+}
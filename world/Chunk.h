@@ -0,0 +1,91 @@
+/**
+ * @file Chunk.h
+ * @brief Declares the Chunk class, a fixed-size column of blocks that the world is divided into.
+ */
+
+#ifndef CHUNK_H
+#define CHUNK_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @enum BlockType
+ * @brief The kinds of blocks a chunk can hold. Air is empty space and is never drawn.
+ */
+enum BlockType : uint8_t {
+  Air = 0,
+  Grass,
+  Dirt,
+  Stone,
+  Sand,
+  Water,
+  Wood,
+  Leaves,
+  BlockTypeCount
+};
+
+/**
+ * @class Chunk
+ * @brief A 16 x 32 x 16 column of blocks, the unit the world is stored, meshed and drawn in.
+ *
+ * Chunks are laid out on a grid in the XZ plane. Block coordinates within a chunk are local, in [0, size) along X
+ * and Z and [0, height) along Y.
+ */
+class Chunk {
+public:
+  /**
+   * Number of blocks along the X and Z axes.
+   */
+  static const int size = 16;
+
+  /**
+   * Number of blocks along the Y axis.
+   */
+  static const int height = 32;
+
+  /**
+   * @brief Constructs an empty chunk at the given grid position.
+   * @param chunkX Position of the chunk along the X axis, in chunks.
+   * @param chunkZ Position of the chunk along the Z axis, in chunks.
+   */
+  Chunk(int chunkX, int chunkZ);
+
+  /**
+   * @brief Returns the block at the given local coordinates, or Air outside the chunk.
+   */
+  BlockType getBlock(int x, int y, int z) const;
+
+  /**
+   * @brief Sets the block at the given local coordinates. Coordinates outside the chunk are ignored.
+   */
+  void setBlock(int x, int y, int z, BlockType block);
+
+  /**
+   * @brief Get the position of the chunk along the X axis, in chunks.
+   */
+  int getChunkX() const;
+
+  /**
+   * @brief Get the position of the chunk along the Z axis, in chunks.
+   */
+  int getChunkZ() const;
+
+private:
+  /**
+   * Position of the chunk along the X axis, in chunks.
+   */
+  int chunkX;
+
+  /**
+   * Position of the chunk along the Z axis, in chunks.
+   */
+  int chunkZ;
+
+  /**
+   * Block types, indexed by x + z * size + y * size * size.
+   */
+  std::vector<BlockType> blocks;
+};
+
+#endif
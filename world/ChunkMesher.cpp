@@ -0,0 +1,147 @@
+/**
+ * @file ChunkMesher.cpp
+ * @brief Implements the ChunkMesher class, which turns chunk blocks into triangle meshes with greedy face merging.
+ */
+
+#include "ChunkMesher.h"
+
+namespace {
+  /**
+   * Base color of each block type.
+   */
+  const float blockColors[BlockTypeCount][3] = {
+    { 0.0f, 0.0f, 0.0f },     // Air
+    { 0.36f, 0.66f, 0.25f },  // Grass
+    { 0.52f, 0.37f, 0.22f },  // Dirt
+    { 0.50f, 0.50f, 0.52f },  // Stone
+    { 0.86f, 0.80f, 0.55f },  // Sand
+    { 0.22f, 0.42f, 0.80f },  // Water
+    { 0.40f, 0.27f, 0.14f },  // Wood
+    { 0.18f, 0.48f, 0.16f }   // Leaves
+  };
+
+  /**
+   * Brightness of faces along each axis, for a simple fixed lighting that keeps block edges readable.
+   */
+  const float axisShade[3] = { 0.8f, 1.0f, 0.65f };
+}
+
+int ChunkMesher::paddedIndex(int x, int y, int z) {
+  return (x + 1) + (z + 1) * paddedSize + (y + 1) * paddedSize * paddedSize;
+}
+
+void ChunkMesher::buildMesh(const std::vector<BlockType>& paddedBlocks, std::vector<PackedVertex>& vertices, std::vector<GLuint>& indices) {
+  const int dimensions[3] = { Chunk::size, Chunk::height, Chunk::size };
+  std::vector<BlockType> mask;
+
+  // Sweep each axis in both directions. The two other axes span the slices the faces lie in
+  for (int axis = 0; axis < 3; ++axis) {
+    int uAxis = (axis + 1) % 3;
+    int vAxis = (axis + 2) % 3;
+    int uSize = dimensions[uAxis];
+    int vSize = dimensions[vAxis];
+    mask.resize(uSize * vSize);
+
+    for (int direction = -1; direction <= 1; direction += 2) {
+      for (int slice = 0; slice < dimensions[axis]; ++slice) {
+        // Mark every block in this slice whose face towards the sweep direction borders air
+        for (int v = 0; v < vSize; ++v) {
+          for (int u = 0; u < uSize; ++u) {
+            int position[3];
+            position[axis] = slice;
+            position[uAxis] = u;
+            position[vAxis] = v;
+            BlockType block = paddedBlocks[paddedIndex(position[0], position[1], position[2])];
+
+            position[axis] += direction;
+            BlockType neighbor = paddedBlocks[paddedIndex(position[0], position[1], position[2])];
+
+            mask[u + v * uSize] = block != Air && neighbor == Air ? block : Air;
+          }
+        }
+
+        // Greedily cover the marked faces with rectangles: grow each one along u as far as possible, then along v
+        // for as long as the whole row matches
+        for (int v = 0; v < vSize; ++v) {
+          for (int u = 0; u < uSize; ) {
+            BlockType block = mask[u + v * uSize];
+            if (block == Air) {
+              ++u;
+              continue;
+            }
+
+            int width = 1;
+            while (u + width < uSize && mask[u + width + v * uSize] == block) {
+              ++width;
+            }
+
+            int height = 1;
+            bool rowMatches = true;
+            while (v + height < vSize && rowMatches) {
+              for (int k = 0; k < width; ++k) {
+                if (mask[u + k + (v + height) * uSize] != block) {
+                  rowMatches = false;
+                  break;
+                }
+              }
+              if (rowMatches) {
+                ++height;
+              }
+            }
+
+            float origin[3] = {};
+            float uEdge[3] = {};
+            float vEdge[3] = {};
+            float normal[3] = {};
+            origin[axis] = static_cast<float>(direction > 0 ? slice + 1 : slice);
+            origin[uAxis] = static_cast<float>(u);
+            origin[vAxis] = static_cast<float>(v);
+            uEdge[uAxis] = static_cast<float>(width);
+            vEdge[vAxis] = static_cast<float>(height);
+            normal[axis] = static_cast<float>(direction);
+            emitQuad(origin, uEdge, vEdge, normal, block, vertices, indices);
+
+            for (int dv = 0; dv < height; ++dv) {
+              for (int du = 0; du < width; ++du) {
+                mask[u + du + (v + dv) * uSize] = Air;
+              }
+            }
+            u += width;
+          }
+        }
+      }
+    }
+  }
+}
+
+void ChunkMesher::emitQuad(const float origin[3], const float uAxis[3], const float vAxis[3], const float normal[3],
+    BlockType block, std::vector<PackedVertex>& vertices, std::vector<GLuint>& indices) {
+  int axis = normal[0] != 0 ? 0 : normal[1] != 0 ? 1 : 2;
+  float shade = axisShade[axis] * (normal[axis] < 0 && axis == 1 ? 0.6f : 1.0f);
+  float color[3] = {
+    blockColors[block][0] * shade,
+    blockColors[block][1] * shade,
+    blockColors[block][2] * shade
+  };
+
+  // u x v points along the positive axis, so this corner order is counter-clockwise seen from the positive side
+  float corners[4][3];
+  for (int i = 0; i < 3; ++i) {
+    corners[0][i] = origin[i];
+    corners[1][i] = origin[i] + uAxis[i];
+    corners[2][i] = origin[i] + uAxis[i] + vAxis[i];
+    corners[3][i] = origin[i] + vAxis[i];
+  }
+
+  GLuint first = static_cast<GLuint>(vertices.size());
+  for (int i = 0; i < 4; ++i) {
+    vertices.push_back(packVertex(corners[i], color, normal));
+  }
+
+  // Faces pointing along the negative axis are wound the other way round
+  if (normal[axis] > 0) {
+    indices.insert(indices.end(), { first, first + 1, first + 2, first, first + 2, first + 3 });
+  } else {
+    indices.insert(indices.end(), { first, first + 2, first + 1, first, first + 3, first + 2 });
+  }
+}
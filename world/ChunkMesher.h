@@ -0,0 +1,67 @@
+/**
+ * @file ChunkMesher.h
+ * @brief Declares the ChunkMesher class, which turns chunk blocks into triangle meshes with greedy face merging.
+ */
+
+#ifndef CHUNK_MESHER_H
+#define CHUNK_MESHER_H
+
+#include <GL/glew.h>
+#include <vector>
+#include "Chunk.h"
+#include "../mesh/VertexFormat.h"
+
+/**
+ * @class ChunkMesher
+ * @brief Builds the mesh of a chunk from a snapshot of its blocks.
+ *
+ * Only faces between a solid block and air are emitted, so the inside of the terrain costs nothing. Coplanar
+ * neighbouring faces of the same block type are then merged into as few rectangles as possible (greedy meshing),
+ * which turns a flat field of grass into a handful of quads instead of one pair of triangles per block.
+ *
+ * The mesher works on a padded copy of the chunk that includes a one block border taken from the neighbouring
+ * chunks, so faces along chunk borders are culled correctly and the mesher never touches live world data. This makes
+ * it safe to run on worker threads.
+ */
+class ChunkMesher {
+public:
+  /**
+   * Size of the padded block snapshot along the X and Z axes.
+   */
+  static const int paddedSize = Chunk::size + 2;
+
+  /**
+   * Size of the padded block snapshot along the Y axis.
+   */
+  static const int paddedHeight = Chunk::height + 2;
+
+  /**
+   * @brief Returns the index into a padded snapshot of the block at local chunk coordinates.
+   * @param x Local X coordinate in [-1, Chunk::size].
+   * @param y Local Y coordinate in [-1, Chunk::height].
+   * @param z Local Z coordinate in [-1, Chunk::size].
+   */
+  static int paddedIndex(int x, int y, int z);
+
+  /**
+   * @brief Builds the mesh of a chunk.
+   * @param paddedBlocks Snapshot of the chunk's blocks plus a one block border, indexed with paddedIndex().
+   * @param vertices Receives the mesh vertices, in chunk-local coordinates.
+   * @param indices Receives the mesh indices, three per triangle.
+   */
+  static void buildMesh(const std::vector<BlockType>& paddedBlocks, std::vector<PackedVertex>& vertices, std::vector<GLuint>& indices);
+
+private:
+  /**
+   * @brief Appends one rectangular face as two triangles.
+   * @param origin Corner of the rectangle with the lowest coordinates.
+   * @param uAxis Edge of the rectangle along its first axis.
+   * @param vAxis Edge of the rectangle along its second axis.
+   * @param normal Outward facing normal; the winding is chosen so the face is front-facing from this side.
+   * @param block Block type, which determines the color.
+   */
+  static void emitQuad(const float origin[3], const float uAxis[3], const float vAxis[3], const float normal[3],
+    BlockType block, std::vector<PackedVertex>& vertices, std::vector<GLuint>& indices);
+};
+
+#endif
@@ -0,0 +1,357 @@
+/**
+ * @file World.cpp
+ * @brief Implements the World class, which stores the block world in chunks and keeps their meshes up to date.
+ */
+
+#include "World.h"
+#include "ChunkMesher.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+  /**
+   * Terrain at or below this height is covered in water.
+   */
+  const int waterLevel = 8;
+
+  /**
+   * Roughly one in this many columns grows a tree.
+   */
+  const uint32_t treeRarity = 61;
+
+  /**
+   * @brief Divides rounding towards negative infinity, so that negative world coordinates map to the right chunk.
+   */
+  int floorDivide(int value, int divisor) {
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+  }
+
+  /**
+   * @brief Returns the terrain height of the given world column.
+   */
+  int terrainHeight(int x, int z) {
+    double height = 10.0
+      + 3.0 * std::sin(x * 0.15)
+      + 3.0 * std::cos(z * 0.11)
+      + 2.0 * std::sin((x + z) * 0.07);
+    return std::min(std::max(static_cast<int>(height), 1), Chunk::height - 8);
+  }
+
+  /**
+   * @brief Hashes a world column, giving a deterministic pseudo random value for decorations.
+   */
+  uint32_t columnHash(int x, int z) {
+    uint32_t hash = static_cast<uint32_t>(x) * 73856093u ^ static_cast<uint32_t>(z) * 19349663u;
+    hash ^= hash >> 13;
+    hash *= 0x5bd1e995u;
+    return hash ^ (hash >> 15);
+  }
+}
+
+World::World(int workerCount)
+  : stopping(false),
+    jobsInFlight(0),
+    uploadsLastUpdate(0),
+    chunksDrawn(0),
+    lastRevision(0),
+    meshesBuilt(0) {
+  if (workerCount <= 0) {
+    workerCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+  }
+
+  for (int i = 0; i < workerCount; ++i) {
+    workers.emplace_back(&World::meshWorker, this);
+  }
+}
+
+World::~World() {
+  {
+    std::lock_guard<std::mutex> lock(jobMutex);
+    stopping = true;
+  }
+  jobAvailable.notify_all();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  for (auto& entry : chunks) {
+    delete entry.second.mesh;
+  }
+}
+
+int64_t World::chunkKey(int chunkX, int chunkZ) {
+  return static_cast<int64_t>(chunkX) << 32 | static_cast<uint32_t>(chunkZ);
+}
+
+void World::generate(int radius) {
+  for (auto& entry : chunks) {
+    delete entry.second.mesh;
+  }
+  chunks.clear();
+
+  for (int chunkZ = -radius; chunkZ <= radius; ++chunkZ) {
+    for (int chunkX = -radius; chunkX <= radius; ++chunkX) {
+      auto inserted = chunks.emplace(chunkKey(chunkX, chunkZ), ChunkEntry(chunkX, chunkZ));
+      inserted.first -> second.revision = ++lastRevision;
+      generateTerrain(inserted.first -> second.chunk);
+    }
+  }
+}
+
+void World::generateTerrain(Chunk& chunk) {
+  int originX = chunk.getChunkX() * Chunk::size;
+  int originZ = chunk.getChunkZ() * Chunk::size;
+
+  for (int z = 0; z < Chunk::size; ++z) {
+    for (int x = 0; x < Chunk::size; ++x) {
+      int height = terrainHeight(originX + x, originZ + z);
+      bool beach = height <= waterLevel + 1;
+
+      for (int y = 0; y <= height; ++y) {
+        BlockType block = y < height - 3 ? Stone : y < height ? Dirt : beach ? Sand : Grass;
+        chunk.setBlock(x, y, z, block);
+      }
+      for (int y = height + 1; y <= waterLevel; ++y) {
+        chunk.setBlock(x, y, z, Water);
+      }
+
+      // Trees stay clear of the chunk borders, so that every tree lies entirely within one chunk
+      bool insideBorder = x >= 2 && x < Chunk::size - 2 && z >= 2 && z < Chunk::size - 2;
+      if (beach || !insideBorder || columnHash(originX + x, originZ + z) % treeRarity != 0) {
+        continue;
+      }
+
+      int trunkTop = height + 4;
+      for (int y = height + 1; y <= trunkTop; ++y) {
+        chunk.setBlock(x, y, z, Wood);
+      }
+      for (int y = trunkTop - 1; y <= trunkTop + 1; ++y) {
+        int reach = y > trunkTop ? 1 : 2;
+        for (int dz = -reach; dz <= reach; ++dz) {
+          for (int dx = -reach; dx <= reach; ++dx) {
+            if (chunk.getBlock(x + dx, y, z + dz) == Air) {
+              chunk.setBlock(x + dx, y, z + dz, Leaves);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+const Chunk* World::findChunk(int chunkX, int chunkZ) const {
+  auto found = chunks.find(chunkKey(chunkX, chunkZ));
+  return found == chunks.end() ? nullptr : &found -> second.chunk;
+}
+
+BlockType World::getBlock(int x, int y, int z) const {
+  int chunkX = floorDivide(x, Chunk::size);
+  int chunkZ = floorDivide(z, Chunk::size);
+  const Chunk* chunk = findChunk(chunkX, chunkZ);
+  if (!chunk) {
+    return Air;
+  }
+  return chunk -> getBlock(x - chunkX * Chunk::size, y, z - chunkZ * Chunk::size);
+}
+
+void World::setBlock(int x, int y, int z, BlockType block) {
+  int chunkX = floorDivide(x, Chunk::size);
+  int chunkZ = floorDivide(z, Chunk::size);
+  auto found = chunks.find(chunkKey(chunkX, chunkZ));
+  if (found == chunks.end() || y < 0 || y >= Chunk::height) {
+    return;
+  }
+
+  int localX = x - chunkX * Chunk::size;
+  int localZ = z - chunkZ * Chunk::size;
+  Chunk& chunk = found -> second.chunk;
+  if (chunk.getBlock(localX, y, localZ) == block) {
+    return;
+  }
+  chunk.setBlock(localX, y, localZ, block);
+  markDirty(chunkX, chunkZ);
+
+  // A block on a border also decides which faces of the neighbouring chunk are visible
+  if (localX == 0) {
+    markDirty(chunkX - 1, chunkZ);
+  } else if (localX == Chunk::size - 1) {
+    markDirty(chunkX + 1, chunkZ);
+  }
+  if (localZ == 0) {
+    markDirty(chunkX, chunkZ - 1);
+  } else if (localZ == Chunk::size - 1) {
+    markDirty(chunkX, chunkZ + 1);
+  }
+}
+
+void World::markDirty(int chunkX, int chunkZ) {
+  auto found = chunks.find(chunkKey(chunkX, chunkZ));
+  if (found != chunks.end()) {
+    found -> second.dirty = true;
+    found -> second.revision = ++lastRevision;
+  }
+}
+
+void World::copyPaddedBlocks(const Chunk& chunk, std::vector<BlockType>& paddedBlocks) const {
+  paddedBlocks.assign(ChunkMesher::paddedSize * ChunkMesher::paddedSize * ChunkMesher::paddedHeight, Air);
+
+  // Only the four direct neighbours matter: the mesher never looks diagonally across a chunk corner
+  int chunkX = chunk.getChunkX();
+  int chunkZ = chunk.getChunkZ();
+  const Chunk* left = findChunk(chunkX - 1, chunkZ);
+  const Chunk* right = findChunk(chunkX + 1, chunkZ);
+  const Chunk* back = findChunk(chunkX, chunkZ - 1);
+  const Chunk* front = findChunk(chunkX, chunkZ + 1);
+
+  for (int y = 0; y < Chunk::height; ++y) {
+    for (int z = 0; z < Chunk::size; ++z) {
+      for (int x = 0; x < Chunk::size; ++x) {
+        paddedBlocks[ChunkMesher::paddedIndex(x, y, z)] = chunk.getBlock(x, y, z);
+      }
+    }
+
+    for (int i = 0; i < Chunk::size; ++i) {
+      if (left) {
+        paddedBlocks[ChunkMesher::paddedIndex(-1, y, i)] = left -> getBlock(Chunk::size - 1, y, i);
+      }
+      if (right) {
+        paddedBlocks[ChunkMesher::paddedIndex(Chunk::size, y, i)] = right -> getBlock(0, y, i);
+      }
+      if (back) {
+        paddedBlocks[ChunkMesher::paddedIndex(i, y, -1)] = back -> getBlock(i, y, Chunk::size - 1);
+      }
+      if (front) {
+        paddedBlocks[ChunkMesher::paddedIndex(i, y, Chunk::size)] = front -> getBlock(i, y, 0);
+      }
+    }
+  }
+}
+
+void World::update(double uploadBudget) {
+  // Hand a snapshot of every dirty chunk to the meshing threads
+  std::vector<MeshJob> newJobs;
+  for (auto& entry : chunks) {
+    ChunkEntry& chunkEntry = entry.second;
+    if (!chunkEntry.dirty) {
+      continue;
+    }
+    chunkEntry.dirty = false;
+
+    MeshJob job;
+    job.key = entry.first;
+    job.revision = chunkEntry.revision;
+    copyPaddedBlocks(chunkEntry.chunk, job.paddedBlocks);
+    newJobs.push_back(std::move(job));
+  }
+
+  if (!newJobs.empty()) {
+    {
+      std::lock_guard<std::mutex> lock(jobMutex);
+      for (MeshJob& job : newJobs) {
+        jobs.push_back(std::move(job));
+      }
+    }
+    jobsInFlight += newJobs.size();
+    jobAvailable.notify_all();
+  }
+
+  // Upload finished meshes until the budget is spent
+  auto start = std::chrono::steady_clock::now();
+  uploadsLastUpdate = 0;
+
+  while (true) {
+    MeshResult result;
+    {
+      std::lock_guard<std::mutex> lock(resultMutex);
+      if (results.empty()) {
+        break;
+      }
+      result = std::move(results.front());
+      results.pop_front();
+    }
+    --jobsInFlight;
+
+    // A chunk that changed after its snapshot was taken is already scheduled again, so the outdated mesh is dropped
+    auto found = chunks.find(result.key);
+    if (found == chunks.end() || found -> second.revision != result.revision) {
+      continue;
+    }
+
+    ChunkEntry& chunkEntry = found -> second;
+    delete chunkEntry.mesh;
+    chunkEntry.mesh = nullptr;
+    chunkEntry.triangleCount = result.indices.size() / 3;
+    if (!result.indices.empty()) {
+      chunkEntry.mesh = new Mesh(result.vertices.data(), result.vertices.size(), result.indices.data(), result.indices.size());
+    }
+    ++uploadsLastUpdate;
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if (elapsed.count() >= uploadBudget) {
+      break;
+    }
+  }
+}
+
+void World::meshWorker() {
+  while (true) {
+    MeshJob job;
+    {
+      std::unique_lock<std::mutex> lock(jobMutex);
+      jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+      if (stopping) {
+        return;
+      }
+      job = std::move(jobs.front());
+      jobs.pop_front();
+    }
+
+    MeshResult result;
+    result.key = job.key;
+    result.revision = job.revision;
+    ChunkMesher::buildMesh(job.paddedBlocks, result.vertices, result.indices);
+
+    std::lock_guard<std::mutex> lock(resultMutex);
+    results.push_back(std::move(result));
+    ++meshesBuilt;
+  }
+}
+
+void World::render(Renderer& renderer, const Frustum& frustum) {
+  chunksDrawn = 0;
+
+  for (auto& entry : chunks) {
+    const ChunkEntry& chunkEntry = entry.second;
+    if (!chunkEntry.mesh) {
+      continue;
+    }
+
+    glm::vec3 origin(chunkEntry.chunk.getChunkX() * Chunk::size, baseHeight, chunkEntry.chunk.getChunkZ() * Chunk::size);
+    AABB bounds = { origin, origin + glm::vec3(Chunk::size, Chunk::height, Chunk::size) };
+    if (!frustum.intersects(bounds)) {
+      continue;
+    }
+
+    renderer.submit(*chunkEntry.mesh, glm::translate(glm::mat4(1.0f), origin));
+    ++chunksDrawn;
+  }
+}
+
+WorldStats World::getStats() const {
+  WorldStats stats;
+  stats.chunkCount = chunks.size();
+  stats.pendingChunks = jobsInFlight;
+  stats.uploadsLastUpdate = uploadsLastUpdate;
+  stats.chunksDrawn = chunksDrawn;
+
+  for (const auto& entry : chunks) {
+    stats.pendingChunks += entry.second.dirty ? 1 : 0;
+    stats.triangleCount += entry.second.triangleCount;
+  }
+
+  std::lock_guard<std::mutex> lock(resultMutex);
+  stats.meshesBuilt = meshesBuilt;
+  return stats;
+}
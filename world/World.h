@@ -0,0 +1,271 @@
+/**
+ * @file World.h
+ * @brief Declares the World class, which stores the block world in chunks and keeps their meshes up to date.
+ */
+
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Chunk.h"
+#include "../mesh/Mesh.h"
+#include "../renderer/Renderer.h"
+#include "../culling/Frustum.h"
+
+/**
+ * @struct WorldStats
+ * @brief Counters describing the state of the chunk meshing pipeline.
+ */
+struct WorldStats {
+  /**
+   * Number of loaded chunks.
+   */
+  size_t chunkCount = 0;
+
+  /**
+   * Number of chunks waiting for a mesh, either queued, being meshed or waiting for upload.
+   */
+  size_t pendingChunks = 0;
+
+  /**
+   * Number of chunk meshes uploaded by the last call to update().
+   */
+  size_t uploadsLastUpdate = 0;
+
+  /**
+   * Total number of chunk meshes built since the world was created.
+   */
+  size_t meshesBuilt = 0;
+
+  /**
+   * Number of triangles in all uploaded chunk meshes.
+   */
+  size_t triangleCount = 0;
+
+  /**
+   * Number of chunks submitted by the last call to render(), after frustum culling.
+   */
+  size_t chunksDrawn = 0;
+};
+
+/**
+ * @class World
+ * @brief A block world divided into chunks, meshed on worker threads and drawn one mesh per chunk.
+ *
+ * Changing a block only marks the chunk holding it dirty, plus the neighbouring chunk when the block lies on a
+ * border, since their shared faces may appear or disappear. update() hands a snapshot of every dirty chunk to the
+ * worker threads, which build the mesh with ChunkMesher, and then uploads finished meshes to the GPU until the
+ * per-frame time budget is spent. Meshes that were rebuilt from outdated blocks are discarded, so edits made while a
+ * chunk is being meshed are never lost.
+ *
+ * All methods must be called from the thread owning the OpenGL context.
+ */
+class World {
+public:
+  /**
+   * @brief Constructs an empty world and starts its meshing threads.
+   * @param workerCount Number of meshing threads, or 0 to use one less than the number of hardware threads.
+   */
+  explicit World(int workerCount = 0);
+
+  /**
+   * @brief Stops the meshing threads and releases every chunk mesh.
+   */
+  ~World();
+
+  /**
+   * @brief Generates a square of terrain chunks centered on the origin, replacing any existing chunks.
+   * @param radius Number of chunks on each side of the center chunk.
+   */
+  void generate(int radius);
+
+  /**
+   * @brief Returns the block at the given world coordinates, or Air outside the loaded chunks.
+   */
+  BlockType getBlock(int x, int y, int z) const;
+
+  /**
+   * @brief Sets the block at the given world coordinates and marks the affected chunks for re-meshing.
+   *
+   * Coordinates outside the loaded chunks are ignored.
+   */
+  void setBlock(int x, int y, int z, BlockType block);
+
+  /**
+   * @brief Schedules dirty chunks for meshing and uploads finished meshes.
+   * @param uploadBudget Time in seconds that may be spent uploading meshes. At least one mesh is uploaded per call
+   * when one is ready, so a small budget slows the world down but never stalls it.
+   */
+  void update(double uploadBudget);
+
+  /**
+   * @brief Submits every chunk that has a mesh and intersects the frustum for rendering.
+   * @param renderer Renderer that the chunk meshes are submitted to; they are drawn by its next flush().
+   * @param frustum View frustum; chunks entirely outside it are skipped.
+   */
+  void render(Renderer& renderer, const Frustum& frustum);
+
+  /**
+   * @brief Get the counters describing the meshing pipeline.
+   */
+  WorldStats getStats() const;
+
+  /**
+   * Height in world units of the bottom of every chunk, which places the default terrain surface just below the
+   * origin.
+   */
+  static constexpr float baseHeight = -16.0f;
+
+private:
+  /**
+   * A loaded chunk together with its mesh.
+   */
+  struct ChunkEntry {
+    Chunk chunk;
+
+    /**
+     * Uploaded mesh, or nullptr if the chunk has none yet or contains no visible faces.
+     */
+    Mesh* mesh = nullptr;
+
+    /**
+     * Whether the blocks changed since the chunk was last scheduled for meshing.
+     */
+    bool dirty = true;
+
+    /**
+     * Revision of the blocks, renewed on every change so that meshes built from older blocks can be recognised.
+     */
+    uint32_t revision = 0;
+
+    /**
+     * Number of triangles in mesh.
+     */
+    size_t triangleCount = 0;
+
+    ChunkEntry(int chunkX, int chunkZ) : chunk(chunkX, chunkZ) {}
+  };
+
+  /**
+   * Work item for a meshing thread.
+   */
+  struct MeshJob {
+    int64_t key;
+    uint32_t revision;
+    std::vector<BlockType> paddedBlocks;
+  };
+
+  /**
+   * Mesh data built by a meshing thread, waiting to be uploaded.
+   */
+  struct MeshResult {
+    int64_t key;
+    uint32_t revision;
+    std::vector<PackedVertex> vertices;
+    std::vector<GLuint> indices;
+  };
+
+  /**
+   * @brief Returns the key of the chunk at the given chunk grid position.
+   */
+  static int64_t chunkKey(int chunkX, int chunkZ);
+
+  /**
+   * @brief Returns the chunk at the given chunk grid position, or nullptr if it is not loaded.
+   */
+  const Chunk* findChunk(int chunkX, int chunkZ) const;
+
+  /**
+   * @brief Marks the chunk at the given chunk grid position for re-meshing, if it is loaded.
+   */
+  void markDirty(int chunkX, int chunkZ);
+
+  /**
+   * @brief Copies a chunk's blocks plus a one block border from its neighbours, as input for ChunkMesher.
+   */
+  void copyPaddedBlocks(const Chunk& chunk, std::vector<BlockType>& paddedBlocks) const;
+
+  /**
+   * @brief Fills a chunk with terrain generated from its world position.
+   */
+  static void generateTerrain(Chunk& chunk);
+
+  /**
+   * @brief Body of each meshing thread: builds meshes for queued jobs until the world is destroyed.
+   */
+  void meshWorker();
+
+  /**
+   * Loaded chunks, by chunkKey().
+   */
+  std::unordered_map<int64_t, ChunkEntry> chunks;
+
+  /**
+   * Threads building chunk meshes.
+   */
+  std::vector<std::thread> workers;
+
+  /**
+   * Chunks waiting to be meshed, guarded by jobMutex.
+   */
+  std::deque<MeshJob> jobs;
+
+  /**
+   * Finished meshes waiting to be uploaded, guarded by resultMutex.
+   */
+  std::deque<MeshResult> results;
+
+  /**
+   * Guards jobs and stopping.
+   */
+  std::mutex jobMutex;
+
+  /**
+   * Guards results and meshesBuilt.
+   */
+  mutable std::mutex resultMutex;
+
+  /**
+   * Wakes the meshing threads when jobs are queued or the world is destroyed.
+   */
+  std::condition_variable jobAvailable;
+
+  /**
+   * Set when the world is destroyed, telling the meshing threads to exit.
+   */
+  bool stopping;
+
+  /**
+   * Number of jobs handed to the meshing threads whose results have not been uploaded or discarded yet.
+   */
+  size_t jobsInFlight;
+
+  /**
+   * Number of chunk meshes uploaded by the last call to update().
+   */
+  size_t uploadsLastUpdate;
+
+  /**
+   * Number of chunks drawn by the last call to render().
+   */
+  size_t chunksDrawn;
+
+  /**
+   * Last revision handed out to a chunk. Revisions are unique across all chunks and generations, so a mesh still
+   * being built for a chunk replaced by generate() can never be mistaken for current.
+   */
+  uint32_t lastRevision;
+
+  /**
+   * Total number of chunk meshes built since the world was created.
+   */
+  size_t meshesBuilt;
+};
+
+#endif